@@ -122,7 +122,8 @@
     }
   }
 
-  NSMutableArray *multiTouchPaths = [[NSMutableArray alloc] init];
+  NSMutableArray<GREYTouchPath *> *multiTouchPaths =
+      [[NSMutableArray alloc] initWithCapacity:_numberOfFingers];
   CGRect accessibilityFrame = [element accessibilityFrame];
 
   for(NSUInteger i = 0; i < _numberOfFingers; i++) {
@@ -144,17 +145,18 @@
     CGFloat xStartPoint = xOffset + CGRectGetMaxX(accessibilityFrame) * _startPercents.x;
     CGFloat yStartPoint = yOffset + CGRectGetMaxY(accessibilityFrame) * _startPercents.y;
     CGPoint startPoint = CGPointMake(xStartPoint, yStartPoint);
-    NSArray *touchPath = [GREYPathGestureUtils touchPathForGestureWithStartPoint:startPoint
-                                                                    andDirection:_direction
-                                                                     andDuration:_duration
-                                                                        inWindow:window];
+    GREYTouchPath *touchPath =
+        [GREYPathGestureUtils touchPathForGestureWithStartPoint:startPoint
+                                                   andDirection:_direction
+                                                    andDuration:_duration
+                                                       inWindow:window];
     [multiTouchPaths addObject:touchPath];
   }
 
-  [GREYSyntheticEvents touchAlongMultiplePaths:multiTouchPaths
-                              relativeToWindow:window
-                                   forDuration:_duration
-                                    expendable:YES];
+  [GREYSyntheticEvents touchAlongMultipleTouchPaths:multiTouchPaths
+                                   relativeToWindow:window
+                                        forDuration:_duration
+                                         expendable:YES];
   return YES;
 }
 @end
@@ -18,6 +18,8 @@
 
 #import <EarlGrey/GREYConstants.h>
 
+@class GREYTouchPath;
+
 NS_ASSUME_NONNULL_BEGIN
 
 /**
@@ -35,12 +37,12 @@ NS_ASSUME_NONNULL_BEGIN
  *  @param duration                      How long the gesture should last (in seconds).
  *  @param window                        The window in which the touch path is generated.
  *
- *  @return NSArray of CGPoints that denote the points in the touch path.
+ *  @return A GREYTouchPath of CGPoints that denote the points in the touch path.
  */
-+ (NSArray *)touchPathForGestureWithStartPoint:(CGPoint)startPointInWindowCoordinates
-                                  andDirection:(GREYDirection)direction
-                                   andDuration:(CFTimeInterval)duration
-                                      inWindow:(UIWindow *)window;
++ (GREYTouchPath *)touchPathForGestureWithStartPoint:(CGPoint)startPointInWindowCoordinates
+                                        andDirection:(GREYDirection)direction
+                                         andDuration:(CFTimeInterval)duration
+                                            inWindow:(UIWindow *)window;
 
 /**
  *  Generates a touch path in the @c window starting from a given @c view in a particular direction
@@ -62,15 +64,15 @@ NS_ASSUME_NONNULL_BEGIN
  *  @param[out] outRemainingAmountOrNull The difference of the length and the amount,
  *                                       if the length falls short.
  *
- *  @return Array of CGPoints that denote the points in the touch path. The touch path's length
- *          will be at least the minimum scroll detection length, when that is not possible
+ *  @return GREYTouchPath of CGPoints that denote the points in the touch path. The touch path's
+ *          length will be at least the minimum scroll detection length, when that is not possible
  *          (due to @c view position and/or size) @c nil is returned.
  */
-+ (NSArray *)touchPathForGestureInView:(UIView *)view
-                         withDirection:(GREYDirection)direction
-                                length:(CGFloat)length
-                    startPointPercents:(CGPoint)startPointPercents
-                    outRemainingAmount:(CGFloat *_Nullable)outRemainingAmountOrNull;
++ (GREYTouchPath *)touchPathForGestureInView:(UIView *)view
+                               withDirection:(GREYDirection)direction
+                                      length:(CGFloat)length
+                          startPointPercents:(CGPoint)startPointPercents
+                          outRemainingAmount:(CGFloat *_Nullable)outRemainingAmountOrNull;
 
 /**
  *  Generates a touch path in the @c window from the given @c startPoint and the given @c
@@ -80,11 +82,11 @@ NS_ASSUME_NONNULL_BEGIN
  *  @param endPoint      The end point for touch path.
  *  @param cancelInertia A boolean value indicating whether intertial movement should be cancelled.
  *
- *  @return NSArray of CGPoints that denote the points in the touch path.
+ *  @return A GREYTouchPath of CGPoints that denote the points in the touch path.
  */
-+ (NSArray *)touchPathForDragGestureWithStartPoint:(CGPoint)startPoint
-                                          endPoint:(CGPoint)endPoint
-                                     cancelInertia:(BOOL)cancelInertia;
++ (GREYTouchPath *)touchPathForDragGestureWithStartPoint:(CGPoint)startPoint
+                                                endPoint:(CGPoint)endPoint
+                                           cancelInertia:(BOOL)cancelInertia;
 
 @end
 
@@ -27,6 +27,7 @@
 #import "Common/GREYVisibilityChecker.h"
 #import "Event/GREYSyntheticEvents.h"
 #import "Event/GREYTouchInjector.h"
+#import "Event/GREYTouchPath.h"
 
 /**
  *  Refers to the minimum 10 points of scroll that is required for any scroll to be detected.
@@ -48,10 +49,10 @@ static CGFloat kCachedScreenEdgePanDetectionLength = NAN;
 
 @implementation GREYPathGestureUtils
 
-+ (NSArray *)touchPathForGestureWithStartPoint:(CGPoint)startPointInWindowCoords
-                                  andDirection:(GREYDirection)direction
-                                   andDuration:(CFTimeInterval)duration
-                                      inWindow:(UIWindow *)window {
++ (GREYTouchPath *)touchPathForGestureWithStartPoint:(CGPoint)startPointInWindowCoords
+                                        andDirection:(GREYDirection)direction
+                                         andDuration:(CFTimeInterval)duration
+                                            inWindow:(UIWindow *)window {
   GREYDirection interfaceTransformedDirection =
       [self grey_relativeDirectionForCurrentOrientationWithDirection:direction];
   // Find an endpoint for gesture in window coordinates that gives us the longest path.
@@ -70,20 +71,20 @@ static CGFloat kCachedScreenEdgePanDetectionLength = NAN;
                         shouldCancelInertia:NO];
 }
 
-+ (NSArray *)touchPathForDragGestureWithStartPoint:(CGPoint)startPoint
-                                          endPoint:(CGPoint)endPoint
-                                     cancelInertia:(BOOL)cancelInertia {
++ (GREYTouchPath *)touchPathForDragGestureWithStartPoint:(CGPoint)startPoint
+                                                endPoint:(CGPoint)endPoint
+                                           cancelInertia:(BOOL)cancelInertia {
   return [self grey_touchPathWithStartPoint:startPoint
                                    endPoint:endPoint
                                    duration:NAN
                         shouldCancelInertia:cancelInertia];
 }
 
-+ (NSArray *)touchPathForGestureInView:(UIView *)view
-                         withDirection:(GREYDirection)direction
-                                length:(CGFloat)length
-                    startPointPercents:(CGPoint)startPointPercents
-                    outRemainingAmount:(CGFloat *)outRemainingAmountOrNull {
++ (GREYTouchPath *)touchPathForGestureInView:(UIView *)view
+                               withDirection:(GREYDirection)direction
+                                      length:(CGFloat)length
+                          startPointPercents:(CGPoint)startPointPercents
+                          outRemainingAmount:(CGFloat *)outRemainingAmountOrNull {
   GREYThrowOnFailedConditionWithMessage(isnan(startPointPercents.x) ||
                                         (startPointPercents.x > 0 && startPointPercents.x < 1),
                                         @"startPointPercents must be NAN or in the range (0, 1) "
@@ -294,30 +295,40 @@ static CGFloat kCachedScreenEdgePanDetectionLength = NAN;
  *
  *  @return A touch path between the two points.
  */
-+ (NSArray *)grey_touchPathWithStartPoint:(CGPoint)startPoint
-                                 endPoint:(CGPoint)endPoint
-                                 duration:(CFTimeInterval)duration
-                      shouldCancelInertia:(BOOL)cancelInertia {
++ (GREYTouchPath *)grey_touchPathWithStartPoint:(CGPoint)startPoint
+                                       endPoint:(CGPoint)endPoint
+                                       duration:(CFTimeInterval)duration
+                            shouldCancelInertia:(BOOL)cancelInertia {
   const CGVector deltaVector = CGVectorFromEndPoints(startPoint, endPoint, NO);
   const CGFloat pathLength = CGVectorLength(deltaVector);
   if (pathLength <= kGREYScrollDetectionLength) {
     return nil;
   }
 
-  NSMutableArray *touchPath = [[NSMutableArray alloc] init];
+  // To cancel inertia, slow down as approaching the end point. This is done by inserting a series
+  // of points between the 2nd last and the last point.
+  static const NSUInteger kNumSlowTouchesBetweenSecondLastAndLastTouch = 20;
+  const NSUInteger slowTouchPoints =
+      cancelInertia ? (kNumSlowTouchesBetweenSecondLastAndLastTouch - 1) : 0;
+
+  GREYTouchPath *touchPath;
   if (isnan(duration)) {
     // After the start point, rest of the path is divided into equal segments and a touch point is
     // created for each segment.
     NSUInteger totalPoints = (NSUInteger)(pathLength / kGREYDistanceBetweenTwoAdjacentPoints);
+    touchPath = [[GREYTouchPath alloc] initWithCapacity:totalPoints + slowTouchPoints + 1];
     // Compute delta for each point and create a path with it.
     CGFloat deltaX = (endPoint.x - startPoint.x) / totalPoints;
     CGFloat deltaY = (endPoint.y - startPoint.y) / totalPoints;
     for (NSUInteger i = 0; i < totalPoints; i++) {
       CGPoint touchPoint = CGPointMake(startPoint.x + (deltaX * i), startPoint.y + (deltaY * i));
-      [touchPath addObject:[NSValue valueWithCGPoint:touchPoint]];
+      [touchPath appendPoint:touchPoint];
     }
   } else {
-    [touchPath addObject:[NSValue valueWithCGPoint:startPoint]];
+    // One point for each touch injected during the gesture, in addition to the start and end.
+    NSUInteger totalPoints = (NSUInteger)MAX(ceil(duration * kGREYTouchInjectionFrequency), 0.0);
+    touchPath = [[GREYTouchPath alloc] initWithCapacity:totalPoints + slowTouchPoints + 2];
+    [touchPath appendPoint:startPoint];
 
     // Uses the kinematics equation for distance: d = a*t*t/2 + v*t
     const double initialVelocity = 0;
@@ -373,30 +384,24 @@ static CGFloat kCachedScreenEdgePanDetectionLength = NAN;
       double deltaY = displacement * sinAngle;
       CGPoint touchPoint = CGPointMake((CGFloat)(startPoint.x + deltaX),
                                        (CGFloat)(startPoint.y + deltaY));
-      [touchPath addObject:[NSValue valueWithCGPoint:touchPoint]];
+      [touchPath appendPoint:touchPoint];
     }
   }
 
-  NSValue *endPointValue = [NSValue valueWithCGPoint:endPoint];
   if (cancelInertia) {
-    // To cancel inertia, slow down as approaching the end point. This is done by inserting a series
-    // of points between the 2nd last and the last point.
-    static const NSUInteger kNumSlowTouchesBetweenSecondLastAndLastTouch = 20;
-
-    NSValue *secondLastValue = [touchPath lastObject];
-    CGPoint secondLastPoint = [secondLastValue CGPointValue];
+    CGPoint secondLastPoint = touchPath.lastPoint;
     CGVector secondLastToLastVector = CGVectorFromEndPoints(secondLastPoint, endPoint, NO);
 
     CGFloat slowTouchesVectorScale = (CGFloat)(1.0 / kNumSlowTouchesBetweenSecondLastAndLastTouch);
     CGVector slowTouchesVector = CGVectorScale(secondLastToLastVector, slowTouchesVectorScale);
 
     CGPoint slowTouchPoint = secondLastPoint;
-    for (NSUInteger i = 0; i < (kNumSlowTouchesBetweenSecondLastAndLastTouch - 1); i++) {
+    for (NSUInteger i = 0; i < slowTouchPoints; i++) {
       slowTouchPoint = CGPointAddVector(slowTouchPoint, slowTouchesVector);
-      [touchPath addObject:[NSValue valueWithCGPoint:slowTouchPoint]];
+      [touchPath appendPoint:slowTouchPoint];
     }
   }
-  [touchPath addObject:endPointValue];
+  [touchPath appendPoint:endPoint];
 
   return touchPath;
 }
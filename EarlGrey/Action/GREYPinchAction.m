@@ -170,19 +170,20 @@ static CGFloat const kPinchScale = (CGFloat)0.8;
   // @c kGREYPinchDirectionInward then the two touch paths have starting points on the circle
   // having the touch path as the radius and ending points are the center of the the view under
   // test.
-  NSArray *touchPathInDirection1 =
+  GREYTouchPath *touchPathInDirection1 =
       [GREYPathGestureUtils touchPathForDragGestureWithStartPoint:startPoint1
                                                          endPoint:endPoint1
                                                     cancelInertia:NO];
-  NSArray *touchPathInDirection2 =
+  GREYTouchPath *touchPathInDirection2 =
       [GREYPathGestureUtils touchPathForDragGestureWithStartPoint:startPoint2
                                                          endPoint:endPoint2
                                                     cancelInertia:NO];
 
-  [GREYSyntheticEvents touchAlongMultiplePaths:@[ touchPathInDirection1, touchPathInDirection2 ]
-                              relativeToWindow:window
-                                   forDuration:_duration
-                                    expendable:YES];
+  NSArray<GREYTouchPath *> *touchPaths = @[ touchPathInDirection1, touchPathInDirection2 ];
+  [GREYSyntheticEvents touchAlongMultipleTouchPaths:touchPaths
+                                   relativeToWindow:window
+                                        forDuration:_duration
+                                         expendable:YES];
   return YES;
 }
 
@@ -0,0 +1,58 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/**
+ *  @file GREYScrollAction+Internal.h
+ *  @brief Exposes GREYScrollAction's interfaces that are used by GREYElementInteraction to search
+ *  for elements.
+ */
+
+#import "Action/GREYScrollAction.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface GREYScrollAction (Internal)
+
+/**
+ *  Creates a scroll action to be used as the search action of a single element search. It scrolls
+ *  in the same direction and from the same start point as the receiver, optionally planning the
+ *  amount of each scroll and setting the content offset directly instead of injecting touches.
+ *
+ *  When planning amounts, the first scroll is for the receiver's amount and each following one
+ *  doubles the previous amount, up to three quarters of the visible length of the scroll view, so
+ *  that an element that fits in the remaining quarter can't be scrolled past without being
+ *  revealed. No scroll goes past the content remaining in the scroll direction.
+ *
+ *  When setting the content offset, the content is moved one page at a time and laid out after
+ *  each page, so scroll view delegates and cell reuse still see every page, but no gesture is
+ *  performed. Scroll views that have scrolling disabled or paging enabled are scrolled by
+ *  injecting touches instead, as they can't be moved to an arbitrary offset by the user.
+ *
+ *  @param plansAmounts      Whether the amount of each scroll is planned.
+ *  @param setsContentOffset Whether the content offset is set directly instead of injecting
+ *                           touches.
+ *
+ *  @remark The returned action keeps state across its performs, so a new one must be created for
+ *          every search.
+ *
+ *  @return A new GREYScrollAction for searching.
+ */
+- (instancetype)searchActionPlanningAmounts:(BOOL)plansAmounts
+                       settingContentOffset:(BOOL)setsContentOffset;
+
+@end
+
+NS_ASSUME_NONNULL_END
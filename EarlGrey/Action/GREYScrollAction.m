@@ -17,6 +17,7 @@
 #import "Action/GREYScrollAction.h"
 
 #import "Action/GREYPathGestureUtils.h"
+#import "Action/GREYScrollAction+Internal.h"
 #import "Action/GREYScrollActionError.h"
 #import "Additions/CGGeometry+GREYAdditions.h"
 #import "Additions/NSError+GREYAdditions.h"
@@ -28,11 +29,13 @@
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYThrowDefines.h"
 #import "Event/GREYSyntheticEvents.h"
+#import "Event/GREYTouchPath.h"
 #import "Matcher/GREYAllOf.h"
 #import "Matcher/GREYAnyOf.h"
 #import "Matcher/GREYMatchers.h"
 #import "Matcher/GREYNot.h"
 #import "Synchronization/GREYAppStateTracker.h"
+#import "Synchronization/GREYAppStateTrackerObject.h"
 #import "Synchronization/GREYUIThreadExecutor.h"
 
 /**
@@ -41,6 +44,49 @@
  */
 static const NSInteger kMinTouchPointsToDetectScrollResistance = 2;
 
+/**
+ *  The largest fraction of the visible length of a scroll view that a search action with planned
+ *  amounts scrolls at once. The rest of the visible length overlaps with the content that was
+ *  visible before the scroll so that elements smaller than it can't be skipped.
+ */
+static const CGFloat kMaxPlannedAmountVisibleLengthFraction = 0.75;
+
+/**
+ *  @return The length of the visible area of @c scrollView along @c direction.
+ */
+static CGFloat GREYVisibleLengthInDirection(UIScrollView *scrollView, GREYDirection direction) {
+  CGSize boundsSize = scrollView.bounds.size;
+  switch (direction) {
+    case kGREYDirectionLeft:
+    case kGREYDirectionRight:
+      return boundsSize.width;
+    case kGREYDirectionUp:
+    case kGREYDirectionDown:
+      return boundsSize.height;
+  }
+}
+
+/**
+ *  @return The length by which the content of @c scrollView can be scrolled in @c direction before
+ *          reaching the content edge, including the content insets.
+ */
+static CGFloat GREYScrollableLengthInDirection(UIScrollView *scrollView, GREYDirection direction) {
+  CGPoint offset = scrollView.contentOffset;
+  CGSize contentSize = scrollView.contentSize;
+  CGSize boundsSize = scrollView.bounds.size;
+  UIEdgeInsets inset = scrollView.contentInset;
+  switch (direction) {
+    case kGREYDirectionLeft:
+      return offset.x + inset.left;
+    case kGREYDirectionRight:
+      return contentSize.width + inset.right - boundsSize.width - offset.x;
+    case kGREYDirectionUp:
+      return offset.y + inset.top;
+    case kGREYDirectionDown:
+      return contentSize.height + inset.bottom - boundsSize.height - offset.y;
+  }
+}
+
 @implementation GREYScrollAction {
   /**
    *  The direction in which the content must be scrolled.
@@ -56,6 +102,20 @@ static const NSInteger kMinTouchPointsToDetectScrollResistance = 2;
    *  point will be set to achieve maximum scroll.
    */
   CGPoint _startPointPercents;
+  /**
+   *  Whether the amount of each scroll is planned from the scroll view's geometry instead of being
+   *  fixed to @c _amount.
+   */
+  BOOL _plansAmounts;
+  /**
+   *  The amount planned for the previous scroll, or 0 if nothing has been planned yet.
+   */
+  CGFloat _previousPlannedAmount;
+  /**
+   *  Whether the content is scrolled by setting the scroll view's content offset instead of by
+   *  injecting touches.
+   */
+  BOOL _setsContentOffset;
 }
 
 - (instancetype)initWithDirection:(GREYDirection)direction
@@ -97,6 +157,39 @@ static const NSInteger kMinTouchPointsToDetectScrollResistance = 2;
   return [self initWithDirection:direction amount:amount startPointPercents:GREYCGPointNull];
 }
 
+- (instancetype)searchActionPlanningAmounts:(BOOL)plansAmounts
+                       settingContentOffset:(BOOL)setsContentOffset {
+  GREYScrollAction *searchAction = [[GREYScrollAction alloc] initWithDirection:_direction
+                                                                        amount:_amount
+                                                            startPointPercents:_startPointPercents];
+  searchAction->_plansAmounts = plansAmounts;
+  searchAction->_setsContentOffset = setsContentOffset;
+  return searchAction;
+}
+
+/**
+ *  Plans the amount of the next scroll of @c scrollView for an action created with
+ *  GREYScrollAction::searchActionPlanningAmounts:settingContentOffset: and records it as the
+ *  previous amount.
+ *
+ *  @param scrollView The scroll view to be scrolled.
+ *
+ *  @return The amount, in points, for the next scroll.
+ */
+- (CGFloat)grey_nextPlannedAmountForScrollView:(UIScrollView *)scrollView {
+  CGFloat amount = _previousPlannedAmount > 0 ? _previousPlannedAmount * 2 : _amount;
+  CGFloat visibleLength = GREYVisibleLengthInDirection(scrollView, _direction);
+  CGFloat scrollableLength = GREYScrollableLengthInDirection(scrollView, _direction);
+  // Never scroll less than the amount asked for, even on scroll views too small to plan for.
+  amount = MIN(amount, MAX(_amount, visibleLength * kMaxPlannedAmountVisibleLengthFraction));
+  _previousPlannedAmount = amount;
+  // If nothing remains, scroll the full amount so that reaching the content edge is reported.
+  if (scrollableLength > 0 && scrollableLength < amount) {
+    amount = scrollableLength;
+  }
+  return amount;
+}
+
 #pragma mark - GREYAction
 
 - (BOOL)perform:(id)element error:(__strong NSError **)errorOrNil {
@@ -111,17 +204,27 @@ static const NSInteger kMinTouchPointsToDetectScrollResistance = 2;
   }
 #endif  // !defined(__IPHONE_12_0) || __IPHONE_OS_VERSION_MIN_REQUIRED < __IPHONE_12_0
 
-  CGFloat amountRemaining = _amount;
+  CGFloat amountRemaining =
+      _plansAmounts ? [self grey_nextPlannedAmountForScrollView:element] : _amount;
   BOOL success = YES;
+  UIScrollView *scrollView = element;
+  // Only scroll views the user could move to any offset can skip the gesture.
+  if (_setsContentOffset && scrollView.scrollEnabled && !scrollView.pagingEnabled) {
+    success = [GREYScrollAction grey_setContentOffsetOfScrollView:scrollView
+                                                      inDirection:_direction
+                                                           amount:amountRemaining];
+    amountRemaining = 0;
+  }
   while (amountRemaining > 0 && success) {
     @autoreleasepool {
       // To scroll the content view in a direction
       GREYDirection reverseDirection = [GREYConstants reverseOfDirection:_direction];
-      NSArray *touchPath = [GREYPathGestureUtils touchPathForGestureInView:element
-                                                             withDirection:reverseDirection
-                                                                    length:amountRemaining
-                                                        startPointPercents:_startPointPercents
-                                                        outRemainingAmount:&amountRemaining];
+      GREYTouchPath *touchPath =
+          [GREYPathGestureUtils touchPathForGestureInView:element
+                                            withDirection:reverseDirection
+                                                   length:amountRemaining
+                                       startPointPercents:_startPointPercents
+                                       outRemainingAmount:&amountRemaining];
       if (!touchPath) {
         GREYPopulateErrorOrLog(errorOrNil,
                                kGREYScrollErrorDomain,
@@ -144,6 +247,45 @@ static const NSInteger kMinTouchPointsToDetectScrollResistance = 2;
 
 #pragma mark - Private
 
+/**
+ *  Scrolls the content of @c scrollView in @c direction by setting its content offset one page
+ *  at a time, without injecting any touches. Every page is laid out, so the delegate is sent
+ *  @c scrollViewDidScroll: and table and collection views reuse their cells as they would while
+ *  being dragged. The scroll view is tracked as scrolling by GREYAppStateTracker until done.
+ *
+ *  @param scrollView The UIScrollView to be scrolled.
+ *  @param direction  The direction in which the content is scrolled.
+ *  @param amount     The amount to scroll the content by, in points.
+ *
+ *  @return @c YES if the content was scrolled by the entire @c amount, @c NO if the content edge
+ *          was reached first.
+ */
++ (BOOL)grey_setContentOffsetOfScrollView:(UIScrollView *)scrollView
+                              inDirection:(GREYDirection)direction
+                                   amount:(CGFloat)amount {
+  GREYAppStateTrackerObject *object =
+      TRACK_STATE_FOR_OBJECT(kGREYPendingUIScrollViewScrolling, scrollView);
+  CGVector directionVector = [GREYConstants normalizedVectorFromDirection:direction];
+  CGFloat pageLength = GREYVisibleLengthInDirection(scrollView, direction);
+  CGFloat amountRemaining = amount;
+  while (amountRemaining > 0) {
+    CGFloat scrollableLength = GREYScrollableLengthInDirection(scrollView, direction);
+    CGFloat pageAmount = MIN(MIN(amountRemaining, pageLength), MAX(scrollableLength, 0));
+    if (pageAmount <= 0) {
+      break;
+    }
+    CGPoint offset =
+        CGPointAddVector(scrollView.contentOffset, CGVectorScale(directionVector, pageAmount));
+    [scrollView setContentOffset:offset animated:NO];
+    [scrollView layoutIfNeeded];
+    amountRemaining -= pageAmount;
+    // Let the app respond to the new page, e.g. by loading more content, before the next one.
+    [[GREYUIThreadExecutor sharedInstance] drainOnce];
+  }
+  UNTRACK_STATE_FOR_OBJECT(kGREYPendingUIScrollViewScrolling, object);
+  return amountRemaining <= 0;
+}
+
 /**
  *  Injects the touch path into the given @c scrollView until the content edge could be reached.
  *
@@ -152,7 +294,7 @@ static const NSInteger kMinTouchPointsToDetectScrollResistance = 2;
  *
  *  @return @c YES if entire touchPath was injected, else @c NO.
  */
-+ (BOOL)grey_injectTouchPath:(NSArray *)touchPath onScrollView:(UIScrollView *)scrollView {
++ (BOOL)grey_injectTouchPath:(GREYTouchPath *)touchPath onScrollView:(UIScrollView *)scrollView {
   GREYFatalAssert([touchPath count] >= 1);
 
   // In scrollviews that have their bounce turned off the horizontal and vertical velocities are not
@@ -165,17 +307,17 @@ static const NSInteger kMinTouchPointsToDetectScrollResistance = 2;
   CGPoint prevOffset = scrollView.contentOffset;
 
   GREYSyntheticEvents *eventGenerator = [[GREYSyntheticEvents alloc] init];
-  [eventGenerator beginTouchAtPoint:[touchPath[0] CGPointValue]
+  [eventGenerator beginTouchAtPoint:touchPath.firstPoint
                    relativeToWindow:[scrollView window]
                   immediateDelivery:YES];
   BOOL hasResistance = NO;
   NSInteger consecutiveTouchPointsWithSameContentOffset = 0;
   for (NSUInteger touchPointIndex = 1; touchPointIndex < [touchPath count]; touchPointIndex++) {
     @autoreleasepool {
-      CGPoint currentTouchPoint = [touchPath[touchPointIndex] CGPointValue];
-      [eventGenerator continueTouchAtPoint:currentTouchPoint
-                         immediateDelivery:YES
-                                expendable:NO];
+      [eventGenerator continueTouchAlongPath:touchPath
+                                atPointIndex:touchPointIndex
+                           immediateDelivery:YES
+                                  expendable:NO];
       BOOL detectedResistanceFromContentOffsets = NO;
       // Keep track of |consecutiveTouchPointsWithSameContentOffset| if we must detect resistance
       // from content offset.
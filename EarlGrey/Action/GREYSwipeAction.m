@@ -124,14 +124,15 @@
       return NO;
     }
   }
-  NSArray *touchPath = [GREYPathGestureUtils touchPathForGestureWithStartPoint:startPoint
-                                                                  andDirection:_direction
-                                                                   andDuration:_duration
-                                                                      inWindow:window];
-  [GREYSyntheticEvents touchAlongPath:touchPath
-                     relativeToWindow:window
-                          forDuration:_duration
-                           expendable:YES];
+  GREYTouchPath *touchPath =
+      [GREYPathGestureUtils touchPathForGestureWithStartPoint:startPoint
+                                                 andDirection:_direction
+                                                  andDuration:_duration
+                                                     inWindow:window];
+  [GREYSyntheticEvents touchAlongTouchPath:touchPath
+                          relativeToWindow:window
+                               forDuration:_duration
+                                expendable:YES];
   return YES;
 }
 
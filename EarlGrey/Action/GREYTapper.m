@@ -25,6 +25,7 @@
 #import "Common/GREYThrowDefines.h"
 #import "Core/GREYInteraction.h"
 #import "Event/GREYSyntheticEvents.h"
+#import "Event/GREYTouchPath.h"
 
 @implementation GREYTapper
 
@@ -56,13 +57,13 @@
     return NO;
   }
 
-  NSArray *touchPath = @[ [NSValue valueWithCGPoint:location] ];
+  GREYTouchPath *touchPath = [GREYTouchPath touchPathWithPoint:location];
   for (NSUInteger i = 1; i <= numberOfTaps; i++) {
     @autoreleasepool {
-      [GREYSyntheticEvents touchAlongPath:touchPath
-                         relativeToWindow:window
-                              forDuration:0
-                               expendable:NO];
+      [GREYSyntheticEvents touchAlongTouchPath:touchPath
+                              relativeToWindow:window
+                                   forDuration:0
+                                    expendable:NO];
     }
   }
   return YES;
@@ -84,11 +85,11 @@
     return NO;
   }
 
-  NSArray *touchPath = @[[NSValue valueWithCGPoint:resolvedLocation]];
-  [GREYSyntheticEvents touchAlongPath:touchPath
-                     relativeToWindow:window
-                          forDuration:duration
-                           expendable:NO];
+  GREYTouchPath *touchPath = [GREYTouchPath touchPathWithPoint:resolvedLocation];
+  [GREYSyntheticEvents touchAlongTouchPath:touchPath
+                          relativeToWindow:window
+                               forDuration:duration
+                                expendable:NO];
   return YES;
 }
 
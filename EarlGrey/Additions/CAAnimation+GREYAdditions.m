@@ -22,6 +22,7 @@
 #import "Common/GREYDefines.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYSwizzler.h"
+#import "Common/GREYVisibilityChecker+Internal.h"
 #import "Delegate/GREYCAAnimationDelegate.h"
 #import "Synchronization/GREYAppStateTracker.h"
 #import "Synchronization/GREYAppStateTrackerObject.h"
@@ -74,6 +75,7 @@
 }
 
 - (void)grey_trackForDurationOfAnimation {
+  GREYVisibilityCheckerBumpGeneration();
   GREYAppStateTrackerObject *object = TRACK_STATE_FOR_OBJECT(kGREYPendingCAAnimation, self);
   objc_setAssociatedObject(self,
                            @selector(grey_trackForDurationOfAnimation),
@@ -96,6 +98,7 @@
 }
 
 - (void)grey_untrack {
+  GREYVisibilityCheckerBumpGeneration();
   GREYAppStateTrackerObject *object =
       objc_getAssociatedObject(self, @selector(grey_trackForDurationOfAnimation));
   UNTRACK_STATE_FOR_OBJECT(kGREYPendingCAAnimation, object);
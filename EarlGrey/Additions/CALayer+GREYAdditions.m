@@ -20,10 +20,12 @@
 
 #import "Additions/CAAnimation+GREYAdditions.h"
 #import "Additions/NSObject+GREYAdditions.h"
+#import "Common/GREYConfiguration+Internal.h"
 #import "Common/GREYConfiguration.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYLogger.h"
 #import "Common/GREYSwizzler.h"
+#import "Common/GREYVisibilityChecker+Internal.h"
 #import "Synchronization/GREYAppStateTracker.h"
 #import "Synchronization/GREYAppStateTrackerObject.h"
 
@@ -66,16 +68,101 @@
                       replaceInstanceMethod:@selector(removeAllAnimations)
                                  withMethod:@selector(greyswizzled_removeAllAnimations)];
     GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer removeAllAnimations");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setHidden:)
+                                 withMethod:@selector(greyswizzled_setHidden:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setHidden:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setOpacity:)
+                                 withMethod:@selector(greyswizzled_setOpacity:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setOpacity:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setBounds:)
+                                 withMethod:@selector(greyswizzled_setBounds:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setBounds:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setPosition:)
+                                 withMethod:@selector(greyswizzled_setPosition:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setPosition:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setTransform:)
+                                 withMethod:@selector(greyswizzled_setTransform:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setTransform:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setAffineTransform:)
+                                 withMethod:@selector(greyswizzled_setAffineTransform:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setAffineTransform:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setContents:)
+                                 withMethod:@selector(greyswizzled_setContents:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setContents:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setBackgroundColor:)
+                                 withMethod:@selector(greyswizzled_setBackgroundColor:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setBackgroundColor:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setZPosition:)
+                                 withMethod:@selector(greyswizzled_setZPosition:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setZPosition:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setMask:)
+                                 withMethod:@selector(greyswizzled_setMask:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setMask:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setSublayers:)
+                                 withMethod:@selector(greyswizzled_setSublayers:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer setSublayers:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(addSublayer:)
+                                 withMethod:@selector(greyswizzled_addSublayer:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer addSublayer:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(insertSublayer:atIndex:)
+                                 withMethod:@selector(greyswizzled_insertSublayer:atIndex:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer insertSublayer:atIndex:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(insertSublayer:above:)
+                                 withMethod:@selector(greyswizzled_insertSublayer:above:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer insertSublayer:above:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(insertSublayer:below:)
+                                 withMethod:@selector(greyswizzled_insertSublayer:below:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer insertSublayer:below:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(replaceSublayer:with:)
+                                 withMethod:@selector(greyswizzled_replaceSublayer:with:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer replaceSublayer:with:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(removeFromSuperlayer)
+                                 withMethod:@selector(greyswizzled_removeFromSuperlayer)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle CALayer removeFromSuperlayer");
   }
 }
 
 - (void)grey_adjustAnimationToAllowableRange:(CAAnimation *)animation {
-  if (!GREY_CONFIG_BOOL(kGREYConfigKeyCALayerModifyAnimations)) {
+  if (!GREY_CONFIG_SNAPSHOT(caLayerModifyAnimations)) {
     return;
   }
 
   CFTimeInterval maxAllowableAnimationDuration =
-      (CFTimeInterval)GREY_CONFIG_DOUBLE(kGREYConfigKeyCALayerMaxAnimationDuration);
+      (CFTimeInterval)GREY_CONFIG_SNAPSHOT(caLayerMaxAnimationDuration);
   if ([animation duration] > maxAllowableAnimationDuration) {
     GREYLogVerbose(@"Adjusting repeatCount and repeatDuration to 0 for animation %@", animation);
     GREYLogVerbose(@"Adjusting duration to %f for animation %@",
@@ -151,6 +238,7 @@
 #pragma mark - Swizzled Implementations
 
 - (void)greyswizzled_removeAllAnimations {
+  GREYVisibilityCheckerBumpGeneration();
   for (NSString *key in [self animationKeys]) {
     CAAnimation *animation = [self animationForKey:key];
     [animation grey_untrack];
@@ -159,6 +247,7 @@
 }
 
 - (void)greyswizzled_removeAnimationForKey:(NSString *)key {
+  GREYVisibilityCheckerBumpGeneration();
   if (key) {
     CAAnimation *animation = [self animationForKey:key];
     [animation grey_untrack];
@@ -167,6 +256,7 @@
 }
 
 - (void)greyswizzled_addAnimation:(CAAnimation *)animation forKey:(NSString *)key {
+  GREYVisibilityCheckerBumpGeneration();
   [self grey_adjustAnimationToAllowableRange:animation];
 
   // If no key is given, give it one.  We need a key to track what animations have been idled.
@@ -193,32 +283,112 @@
 }
 
 - (void)greyswizzled_setNeedsDisplayInRect:(CGRect)invalidRect {
-  GREYAppStateTrackerObject *object = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, self);
-  // Next runloop drain will perform the draw pass.
-  dispatch_async(dispatch_get_main_queue(), ^{
-    UNTRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, object);
-  });
+  GREYVisibilityCheckerBumpGeneration();
+  [[GREYAppStateTracker sharedInstance] trackPendingDrawLayoutPass];
   INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setNeedsDisplayInRect:), invalidRect);
 }
 
 - (void)greyswizzled_setNeedsDisplay {
-  GREYAppStateTrackerObject *object = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, self);
-  // Next runloop drain will perform the draw pass.
-  dispatch_async(dispatch_get_main_queue(), ^{
-    UNTRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, object);
-  });
+  GREYVisibilityCheckerBumpGeneration();
+  [[GREYAppStateTracker sharedInstance] trackPendingDrawLayoutPass];
   INVOKE_ORIGINAL_IMP(void, @selector(greyswizzled_setNeedsDisplay));
 }
 
 - (void)greyswizzled_setNeedsLayout {
-  GREYAppStateTrackerObject *object = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, self);
-  // Next runloop drain will perform the layout pass.
-  dispatch_async(dispatch_get_main_queue(), ^ {
-    UNTRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, object);
-  });
+  GREYVisibilityCheckerBumpGeneration();
+  [[GREYAppStateTracker sharedInstance] trackPendingDrawLayoutPass];
   INVOKE_ORIGINAL_IMP(void, @selector(greyswizzled_setNeedsLayout));
 }
 
+// Hiding, fading, moving, transforming, restyling or reordering a layer changes what is on screen
+// without requiring a display or layout pass, so these only let the visibility checker know that
+// its cached results are stale.
+
+- (void)greyswizzled_setHidden:(BOOL)hidden {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setHidden:), hidden);
+}
+
+- (void)greyswizzled_setOpacity:(float)opacity {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setOpacity:), opacity);
+}
+
+- (void)greyswizzled_setBounds:(CGRect)bounds {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setBounds:), bounds);
+}
+
+- (void)greyswizzled_setPosition:(CGPoint)position {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setPosition:), position);
+}
+
+- (void)greyswizzled_setTransform:(CATransform3D)transform {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setTransform:), transform);
+}
+
+- (void)greyswizzled_setAffineTransform:(CGAffineTransform)transform {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setAffineTransform:), transform);
+}
+
+- (void)greyswizzled_setContents:(id)contents {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setContents:), contents);
+}
+
+- (void)greyswizzled_setBackgroundColor:(CGColorRef)backgroundColor {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setBackgroundColor:), backgroundColor);
+}
+
+- (void)greyswizzled_setZPosition:(CGFloat)zPosition {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setZPosition:), zPosition);
+}
+
+- (void)greyswizzled_setMask:(CALayer *)mask {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setMask:), mask);
+}
+
+- (void)greyswizzled_setSublayers:(NSArray<CALayer *> *)sublayers {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setSublayers:), sublayers);
+}
+
+- (void)greyswizzled_addSublayer:(CALayer *)layer {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_addSublayer:), layer);
+}
+
+- (void)greyswizzled_insertSublayer:(CALayer *)layer atIndex:(unsigned)index {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP2(void, @selector(greyswizzled_insertSublayer:atIndex:), layer, index);
+}
+
+- (void)greyswizzled_insertSublayer:(CALayer *)layer above:(CALayer *)sibling {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP2(void, @selector(greyswizzled_insertSublayer:above:), layer, sibling);
+}
+
+- (void)greyswizzled_insertSublayer:(CALayer *)layer below:(CALayer *)sibling {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP2(void, @selector(greyswizzled_insertSublayer:below:), layer, sibling);
+}
+
+- (void)greyswizzled_replaceSublayer:(CALayer *)oldLayer with:(CALayer *)newLayer {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP2(void, @selector(greyswizzled_replaceSublayer:with:), oldLayer, newLayer);
+}
+
+- (void)greyswizzled_removeFromSuperlayer {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP(void, @selector(greyswizzled_removeFromSuperlayer));
+}
+
 #pragma mark - Internal Methods Exposed For Testing
 
 - (NSMutableSet *)grey_pausedAnimationKeys {
@@ -21,6 +21,7 @@
 #import "Additions/CGGeometry+GREYAdditions.h"
 #import "Additions/NSString+GREYAdditions.h"
 #import "Assertion/GREYAssertionDefines.h"
+#import "Common/GREYConfiguration+Internal.h"
 #import "Common/GREYConfiguration.h"
 #import "Common/GREYConstants.h"
 #import "Common/GREYElementHierarchy.h"
@@ -322,8 +323,7 @@ static Class gWebAccessibilityWrapper;
   if ([NSThread isMainThread]) {
     NSArray *arguments = [self grey_arrayWithSelector:aSelector argument:anArgument];
     // Track delayed executions on main thread that fall within a trackable duration.
-    CFTimeInterval maxDelayToTrack =
-        GREY_CONFIG_DOUBLE(kGREYConfigKeyDelayedPerformMaxTrackableDuration);
+    CFTimeInterval maxDelayToTrack = GREY_CONFIG_SNAPSHOT(delayedPerformMaxTrackableDuration);
     if (maxDelayToTrack >= delay) {
       // As a safeguard, track the pending call for twice the amount incase the execution is
       // *really* delayed (due to cpu trashing) for more than the expected execution-time.
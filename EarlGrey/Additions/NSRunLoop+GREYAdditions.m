@@ -16,6 +16,7 @@
 
 #import "Additions/NSRunLoop+GREYAdditions.h"
 
+#import "Common/GREYConfiguration+Internal.h"
 #import "Common/GREYConfiguration.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYSwizzler.h"
@@ -40,7 +41,7 @@
   if ([mode isEqualToString:NSDefaultRunLoopMode]) {
     // Add a idling resource for short non-repeating timers.
     if (timer.timeInterval == 0 &&
-        GREY_CONFIG_DOUBLE(kGREYConfigKeyNSTimerMaxTrackableInterval) >=
+        GREY_CONFIG_SNAPSHOT(nsTimerMaxTrackableInterval) >=
         [timer.fireDate timeIntervalSinceNow]) {
       NSString *name = [NSString stringWithFormat:@"IdlingResource For Timer %@", timer];
       [GREYNSTimerIdlingResource trackTimer:timer name:name removeOnIdle:YES];
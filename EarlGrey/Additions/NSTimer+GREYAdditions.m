@@ -16,6 +16,7 @@
 
 #import "Additions/NSTimer+GREYAdditions.h"
 
+#import "Common/GREYConfiguration+Internal.h"
 #import "Common/GREYConfiguration.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYSwizzler.h"
@@ -58,7 +59,7 @@
       invocation,
       repeats);
 
-  if (!repeats && GREY_CONFIG_DOUBLE(kGREYConfigKeyNSTimerMaxTrackableInterval) >= interval) {
+  if (!repeats && GREY_CONFIG_SNAPSHOT(nsTimerMaxTrackableInterval) >= interval) {
     [GREYNSTimerIdlingResource trackTimer:timer
                                      name:[NSString stringWithFormat:@"Tracking Timer %@", timer]
                              removeOnIdle:YES];
@@ -80,7 +81,7 @@
                                         aSelector,
                                         userInfo,
                                         repeats);
-  if (!repeats && GREY_CONFIG_DOUBLE(kGREYConfigKeyNSTimerMaxTrackableInterval) >= interval) {
+  if (!repeats && GREY_CONFIG_SNAPSHOT(nsTimerMaxTrackableInterval) >= interval) {
     [GREYNSTimerIdlingResource trackTimer:timer
                                      name:[NSString stringWithFormat:@"Tracking Timer %@", timer]
                              removeOnIdle:YES];
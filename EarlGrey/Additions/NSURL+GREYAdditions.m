@@ -18,11 +18,146 @@
 
 #import <objc/runtime.h>
 
+#import "Common/GREYConfiguration+Internal.h"
 #import "Common/GREYConfiguration.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYLogger.h"
 #import "Common/GREYThrowDefines.h"
 
+/**
+ *  The maximum number of URLs whose blacklist match result is cached.
+ */
+static const NSUInteger kMatchResultCacheCountLimit = 256;
+
+/**
+ *  Matches URLs against a list of blacklisted URL regular expressions, compiled once into a single
+ *  alternation. Regular expressions that can't safely be part of an alternation, such as those
+ *  with capture groups that may be back referenced, are matched separately.
+ */
+@interface GREYURLBlacklistMatcher : NSObject
+
+/**
+ *  @param regExs The regular expressions of the blacklisted URLs.
+ *
+ *  @return A matcher for URLs matching any of @c regExs.
+ */
+- (instancetype)initWithRegExs:(NSArray<NSString *> *)regExs;
+
+/**
+ *  @param URLString The absolute string of the URL to be matched.
+ *
+ *  @return @c YES if @c URLString matches any of the blacklisted regular expressions, @c NO
+ *          otherwise.
+ */
+- (BOOL)matchesURLString:(NSString *)URLString;
+
+@end
+
+@implementation GREYURLBlacklistMatcher {
+  NSRegularExpression *_alternationRegEx;
+  NSArray<NSRegularExpression *> *_separateRegExs;
+  NSCache<NSString *, NSNumber *> *_matchResults;
+}
+
+- (instancetype)initWithRegExs:(NSArray<NSString *> *)regExs {
+  self = [super init];
+  if (self) {
+    NSMutableArray<NSString *> *alternatives = [[NSMutableArray alloc] init];
+    NSMutableArray<NSRegularExpression *> *separateRegExs = [[NSMutableArray alloc] init];
+    for (NSString *regExString in regExs) {
+      NSError *error;
+      NSRegularExpression *regEx = [NSRegularExpression regularExpressionWithPattern:regExString
+                                                                             options:0
+                                                                               error:&error];
+      GREYFatalAssertWithMessage(!error,
+                                 @"Invalid regex:\"%@\". See error: %@", regExString, error);
+      if ([[self class] grey_canBeAlternative:regEx]) {
+        [alternatives addObject:[NSString stringWithFormat:@"(?:%@)", regExString]];
+      } else {
+        [separateRegExs addObject:regEx];
+      }
+    }
+    if (alternatives.count > 0) {
+      NSError *error;
+      NSString *alternation = [alternatives componentsJoinedByString:@"|"];
+      _alternationRegEx = [NSRegularExpression regularExpressionWithPattern:alternation
+                                                                    options:0
+                                                                      error:&error];
+      GREYFatalAssertWithMessage(!error, @"Invalid regex alternation. See error: %@", error);
+    }
+    _separateRegExs = separateRegExs;
+    _matchResults = [[NSCache alloc] init];
+    _matchResults.countLimit = kMatchResultCacheCountLimit;
+  }
+  return self;
+}
+
+- (BOOL)matchesURLString:(NSString *)URLString {
+  NSNumber *cachedResult = [_matchResults objectForKey:URLString];
+  if (cachedResult) {
+    return [cachedResult boolValue];
+  }
+
+  BOOL matches = [self grey_regEx:_alternationRegEx matchesString:URLString];
+  for (NSRegularExpression *regEx in _separateRegExs) {
+    if (matches) {
+      break;
+    }
+    matches = [self grey_regEx:regEx matchesString:URLString];
+  }
+  [_matchResults setObject:@(matches) forKey:URLString];
+  return matches;
+}
+
+#pragma mark - Private
+
+/**
+ *  @return @c YES if @c regEx matches the same strings when wrapped in a non-capturing group and
+ *          joined with other regular expressions in an alternation, @c NO otherwise.
+ */
++ (BOOL)grey_canBeAlternative:(NSRegularExpression *)regEx {
+  NSString *pattern = regEx.pattern;
+  // Capture groups can be back referenced by number, which changes in an alternation. \Q quotes
+  // until the end of the pattern when it isn't closed and (?x) turns # into a comment, either of
+  // which could swallow the closing parenthesis of the group.
+  return regEx.numberOfCaptureGroups == 0 &&
+         [pattern rangeOfString:@"\\Q"].location == NSNotFound &&
+         [pattern rangeOfString:@"\\(\\?[a-zA-Z-]*x"
+                        options:NSRegularExpressionSearch].location == NSNotFound;
+}
+
+/**
+ *  @return @c YES if @c regEx is not @c nil and matches @c string, @c NO otherwise.
+ */
+- (BOOL)grey_regEx:(NSRegularExpression *)regEx matchesString:(NSString *)string {
+  if (!regEx) {
+    return NO;
+  }
+  NSRange firstMatch = [regEx rangeOfFirstMatchInString:string
+                                                options:0
+                                                  range:NSMakeRange(0, [string length])];
+  return firstMatch.location != NSNotFound;
+}
+
+@end
+
+/**
+ *  The matcher for the current blacklist or @c nil if no URL is blacklisted. Guarded by the
+ *  @c NSURL class.
+ */
+static GREYURLBlacklistMatcher *gBlacklistMatcher;
+
+/**
+ *  Whether @c gBlacklistMatcher reflects the framework blacklist. Guarded by the @c NSURL class.
+ */
+static BOOL gBlacklistMatcherIsValid;
+
+/**
+ *  The configuration change count at which @c gBlacklistMatcher was created. Guarded by the
+ *  @c NSURL class.
+ */
+static NSUInteger gBlacklistMatcherChangeCount;
+
 @implementation NSURL (GREYAdditions)
 
 - (BOOL)grey_shouldSynchronize {
@@ -31,29 +166,37 @@
     return NO;
   }
 
-  NSArray *blacklistRegExs = [[self class] grey_blacklistRegEx];
-  if (blacklistRegExs.count == 0) {
+  GREYURLBlacklistMatcher *blacklistMatcher = [[self class] grey_blacklistMatcher];
+  if (!blacklistMatcher) {
     return YES;
   }
 
   NSString *stringURL = [self absoluteString];
-  NSError *error;
-  for (NSString *regexStr in blacklistRegExs) {
-    NSRegularExpression * regex = [NSRegularExpression regularExpressionWithPattern:regexStr
-                                                                            options:0
-                                                                              error:&error];
-    GREYFatalAssertWithMessage(!error, @"Invalid regex:\"%@\". See error: %@", regex, error);
-    NSRange firstMatch = [regex rangeOfFirstMatchInString:stringURL
-                                                  options:0
-                                                    range:NSMakeRange(0, [stringURL length])];
-    if (firstMatch.location != NSNotFound) {
-      GREYLogVerbose(@"Matched a blacklisted URL: %@", stringURL);
-      return NO;
-    }
+  if ([blacklistMatcher matchesURLString:stringURL]) {
+    GREYLogVerbose(@"Matched a blacklisted URL: %@", stringURL);
+    return NO;
   }
   return YES;
 }
 
+// Returns the matcher for the URLs that shouldn't be synchronized with or @c nil if there are
+// none. The matcher is only created again after the blacklist has changed.
++ (GREYURLBlacklistMatcher *)grey_blacklistMatcher {
+  NSUInteger changeCount = [[GREYConfiguration sharedInstance] changeCount];
+  @synchronized (self) {
+    if (!gBlacklistMatcherIsValid || gBlacklistMatcherChangeCount != changeCount) {
+      NSArray *blacklistRegExs = [self grey_blacklistRegEx];
+      gBlacklistMatcher = nil;
+      if (blacklistRegExs.count > 0) {
+        gBlacklistMatcher = [[GREYURLBlacklistMatcher alloc] initWithRegExs:blacklistRegExs];
+      }
+      gBlacklistMatcherIsValid = YES;
+      gBlacklistMatcherChangeCount = changeCount;
+    }
+    return gBlacklistMatcher;
+  }
+}
+
 // Returns an @c NSArray of @c NSString representing regexs of URLs that shouldn't be synchronized
 // with.
 + (NSArray *)grey_blacklistRegEx {
@@ -82,6 +225,7 @@
                                OBJC_ASSOCIATION_RETAIN_NONATOMIC);
     }
     [blacklist addObject:URLRegEx];
+    gBlacklistMatcherIsValid = NO;
   }
 }
 
@@ -0,0 +1,25 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#import <UIKit/UIKit.h>
+
+/**
+ *  Additions that let the element index know about the accessibility identifiers of accessibility
+ *  elements, which it can't index.
+ */
+@interface UIAccessibilityElement (GREYAdditions)
+@end
@@ -0,0 +1,48 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#import "Additions/UIAccessibilityElement+GREYAdditions.h"
+
+#import "Common/GREYFatalAsserts.h"
+#import "Common/GREYSwizzler.h"
+#import "Core/GREYElementIndex.h"
+
+@implementation UIAccessibilityElement (GREYAdditions)
+
++ (void)load {
+  @autoreleasepool {
+    GREYSwizzler *swizzler = [[GREYSwizzler alloc] init];
+    BOOL swizzled = [swizzler swizzleClass:self
+                     replaceInstanceMethod:@selector(setAccessibilityIdentifier:)
+                                withMethod:@selector(greyswizzled_setAccessibilityIdentifier:)];
+    GREYFatalAssertWithMessage(swizzled,
+                               @"Cannot swizzle "
+                               @"[UIAccessibilityElement setAccessibilityIdentifier:]");
+  }
+}
+
+#pragma mark - Swizzled Implementation
+
+- (void)greyswizzled_setAccessibilityIdentifier:(NSString *)accessibilityIdentifier {
+  INVOKE_ORIGINAL_IMP1(void,
+                       @selector(greyswizzled_setAccessibilityIdentifier:),
+                       accessibilityIdentifier);
+  [[GREYElementIndex sharedInstance]
+      recordAccessibilityIDOfUnindexedElement:accessibilityIdentifier];
+}
+
+@end
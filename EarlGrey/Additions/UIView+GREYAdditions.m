@@ -22,9 +22,10 @@
 #import "Common/GREYConstants.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYSwizzler.h"
+#import "Common/GREYVisibilityChecker+Internal.h"
+#import "Core/GREYElementIndex.h"
 #import "Provider/GREYElementProvider.h"
 #import "Synchronization/GREYAppStateTracker.h"
-#import "Synchronization/GREYAppStateTrackerObject.h"
 #import "Synchronization/GREYTimedIdlingResource.h"
 
 @implementation UIView (GREYAdditions)
@@ -56,6 +57,12 @@
                                  withMethod:@selector(greyswizzled_addSubview:)];
     GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle UIView addSubview");
 
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setAccessibilityIdentifier:)
+                                 withMethod:@selector(greyswizzled_setAccessibilityIdentifier:)];
+    GREYFatalAssertWithMessage(swizzleSuccess,
+                               @"Cannot swizzle UIView setAccessibilityIdentifier:");
+
     swizzleSuccess = [swizzler swizzleClass:self
                       replaceInstanceMethod:@selector(willRemoveSubview:)
                                  withMethod:@selector(greyswizzled_willRemoveSubview:)];
@@ -86,6 +93,21 @@
     GREYFatalAssertWithMessage(swizzleSuccess,
                                @"Cannot swizzle UIView insertSubview:belowSubview:");
 
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(bringSubviewToFront:)
+                                 withMethod:@selector(greyswizzled_bringSubviewToFront:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle UIView bringSubviewToFront:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(sendSubviewToBack:)
+                                 withMethod:@selector(greyswizzled_sendSubviewToBack:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle UIView sendSubviewToBack:");
+
+    swizzleSuccess = [swizzler swizzleClass:self
+                      replaceInstanceMethod:@selector(setTransform:)
+                                 withMethod:@selector(greyswizzled_setTransform:)];
+    GREYFatalAssertWithMessage(swizzleSuccess, @"Cannot swizzle UIView setTransform:");
+
     swizzleSuccess = [swizzler swizzleClass:self
                       replaceInstanceMethod:@selector(setNeedsDisplayInRect:)
                                  withMethod:@selector(greyswizzled_setNeedsDisplayInRect:)];
@@ -264,6 +286,7 @@
 #pragma mark - Swizzled Implementation
 
 - (void)greyswizzled_setCenter:(CGPoint)center {
+  GREYVisibilityCheckerBumpGeneration();
   NSValue *fixedFrame =
       objc_getAssociatedObject(self, @selector(grey_keepSubviewOnTopAndFrameFixed:));
   if (fixedFrame) {
@@ -274,6 +297,7 @@
 }
 
 - (void)greyswizzled_setFrame:(CGRect)frame {
+  GREYVisibilityCheckerBumpGeneration();
   NSValue *fixedFrame =
       objc_getAssociatedObject(self, @selector(grey_keepSubviewOnTopAndFrameFixed:));
   if (fixedFrame) {
@@ -283,11 +307,21 @@
 }
 
 - (void)greyswizzled_addSubview:(UIView *)view {
+  GREYVisibilityCheckerBumpGeneration();
   INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_addSubview:), view);
   [self grey_bringAlwaysTopSubviewToFront];
+  [[GREYElementIndex sharedInstance] indexViewHierarchy:view];
+}
+
+- (void)greyswizzled_setAccessibilityIdentifier:(NSString *)accessibilityIdentifier {
+  INVOKE_ORIGINAL_IMP1(void,
+                       @selector(greyswizzled_setAccessibilityIdentifier:),
+                       accessibilityIdentifier);
+  [[GREYElementIndex sharedInstance] indexView:self];
 }
 
 - (void)greyswizzled_willRemoveSubview:(UIView *)view {
+  GREYVisibilityCheckerBumpGeneration();
   UIView *alwaysTopSubview =
       objc_getAssociatedObject(self, @selector(grey_bringAlwaysTopSubviewToFront));
   if ([view isEqual:alwaysTopSubview]) {
@@ -304,27 +338,34 @@
 }
 
 - (void)greyswizzled_insertSubview:(UIView *)view aboveSubview:(UIView *)siblingSubview {
+  GREYVisibilityCheckerBumpGeneration();
   INVOKE_ORIGINAL_IMP2(void,
                        @selector(greyswizzled_insertSubview:aboveSubview:),
                        view,
                        siblingSubview);
   [self grey_bringAlwaysTopSubviewToFront];
+  [[GREYElementIndex sharedInstance] indexViewHierarchy:view];
 }
 
 - (void)greyswizzled_insertSubview:(UIView *)view belowSubview:(UIView *)siblingSubview {
+  GREYVisibilityCheckerBumpGeneration();
   INVOKE_ORIGINAL_IMP2(void,
                        @selector(greyswizzled_insertSubview:belowSubview:),
                        view,
                        siblingSubview);
   [self grey_bringAlwaysTopSubviewToFront];
+  [[GREYElementIndex sharedInstance] indexViewHierarchy:view];
 }
 
 - (void)greyswizzled_insertSubview:(UIView *)view atIndex:(NSInteger)index {
+  GREYVisibilityCheckerBumpGeneration();
   INVOKE_ORIGINAL_IMP2(void, @selector(greyswizzled_insertSubview:atIndex:), view, index);
   [self grey_bringAlwaysTopSubviewToFront];
+  [[GREYElementIndex sharedInstance] indexViewHierarchy:view];
 }
 
 - (void)greyswizzled_exchangeSubviewAtIndex:(NSInteger)index1 withSubviewAtIndex:(NSInteger)index2 {
+  GREYVisibilityCheckerBumpGeneration();
   INVOKE_ORIGINAL_IMP2(void,
                        @selector(greyswizzled_exchangeSubviewAtIndex:withSubviewAtIndex:),
                        index1,
@@ -332,39 +373,42 @@
   [self grey_bringAlwaysTopSubviewToFront];
 }
 
+- (void)greyswizzled_bringSubviewToFront:(UIView *)view {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_bringSubviewToFront:), view);
+}
+
+- (void)greyswizzled_sendSubviewToBack:(UIView *)view {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_sendSubviewToBack:), view);
+}
+
+- (void)greyswizzled_setTransform:(CGAffineTransform)transform {
+  GREYVisibilityCheckerBumpGeneration();
+  INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setTransform:), transform);
+}
+
 - (void)greyswizzled_setNeedsDisplayInRect:(CGRect)rect {
-  GREYAppStateTrackerObject *object = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, self);
-  // Next runloop drain will perform the draw pass.
-  dispatch_async(dispatch_get_main_queue(), ^ {
-    UNTRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, object);
-  });
+  GREYVisibilityCheckerBumpGeneration();
+  [[GREYAppStateTracker sharedInstance] trackPendingDrawLayoutPass];
   INVOKE_ORIGINAL_IMP1(void, @selector(greyswizzled_setNeedsDisplayInRect:), rect);
 }
 
 - (void)greyswizzled_setNeedsDisplay {
-  GREYAppStateTrackerObject *object = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, self);
-  // Next runloop drain will perform the draw pass.
-  dispatch_async(dispatch_get_main_queue(), ^ {
-    UNTRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, object);
-  });
+  GREYVisibilityCheckerBumpGeneration();
+  [[GREYAppStateTracker sharedInstance] trackPendingDrawLayoutPass];
   INVOKE_ORIGINAL_IMP(void, @selector(greyswizzled_setNeedsDisplay));
 }
 
 - (void)greyswizzled_setNeedsLayout {
-  GREYAppStateTrackerObject *object = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, self);
-  // Next runloop drain will perform the draw pass.
-  dispatch_async(dispatch_get_main_queue(), ^ {
-    UNTRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, object);
-  });
+  GREYVisibilityCheckerBumpGeneration();
+  [[GREYAppStateTracker sharedInstance] trackPendingDrawLayoutPass];
   INVOKE_ORIGINAL_IMP(void, @selector(greyswizzled_setNeedsLayout));
 }
 
 - (void)greyswizzled_setNeedsUpdateConstraints {
-  GREYAppStateTrackerObject *object = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, self);
-  // Next runloop drain will perform the draw pass.
-  dispatch_async(dispatch_get_main_queue(), ^ {
-    UNTRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, object);
-  });
+  GREYVisibilityCheckerBumpGeneration();
+  [[GREYAppStateTracker sharedInstance] trackPendingDrawLayoutPass];
   INVOKE_ORIGINAL_IMP(void, @selector(greyswizzled_setNeedsUpdateConstraints));
 }
 
@@ -122,6 +122,20 @@ typedef NS_ENUM(NSUInteger, GREYXCTestCaseStatus) {
  */
 - (NSString *)grey_localizedTestOutputsDirectory;
 
+/**
+ *  Writes @c JSONObject as JSON to the file named @c fileName in the test outputs directory of this
+ *  test, creating the directory if needed. Failures are logged.
+ *
+ *  @param JSONObject The object to be written, which must be valid for NSJSONSerialization.
+ *  @param fileName   The name of the file in the test outputs directory.
+ *  @param options    The options to serialize @c JSONObject with.
+ *
+ *  @return @c YES if the file was written, @c NO otherwise.
+ */
+- (BOOL)grey_writeJSONObject:(id)JSONObject
+      toTestOutputsFileNamed:(NSString *)fileName
+                     options:(NSJSONWritingOptions)options;
+
 /**
  *  Sets the value for the test status.
  *
@@ -151,6 +151,28 @@ NSString *const kGREYXCTestCaseNotificationKey = @"GREYXCTestCaseNotificationKey
   return localizedTestOutputsDir;
 }
 
+- (BOOL)grey_writeJSONObject:(id)JSONObject
+      toTestOutputsFileNamed:(NSString *)fileName
+                     options:(NSJSONWritingOptions)options {
+  NSString *directoryPath = [self grey_localizedTestOutputsDirectory];
+  NSError *error;
+  if (![[NSFileManager defaultManager] createDirectoryAtPath:directoryPath
+                                 withIntermediateDirectories:YES
+                                                  attributes:nil
+                                                       error:&error]) {
+    NSLog(@"Could not create test outputs directory \"%@\": %@", directoryPath,
+          [error localizedDescription]);
+    return NO;
+  }
+  NSData *data = [NSJSONSerialization dataWithJSONObject:JSONObject options:options error:&error];
+  NSString *filePath = [directoryPath stringByAppendingPathComponent:fileName];
+  if (!data || ![data writeToFile:filePath atomically:YES]) {
+    NSLog(@"Could not write JSON to file '%@'", filePath);
+    return NO;
+  }
+  return YES;
+}
+
 - (void)grey_markAsFailedAtLine:(NSUInteger)line
                          inFile:(NSString *)file
                     description:(NSString *)description {
@@ -47,6 +47,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSString *)idlingResourceDescription;
 
+@optional
+
+/**
+ *  Resources that return @c YES promise to call GREYUIThreadExecutor::signalIdleTransition every
+ *  time they go from busy to idle, from whichever thread the transition happens on. While only such
+ *  resources are busy, the main thread is allowed to sleep until one of them signals instead of
+ *  polling them continuously, if @c kGREYConfigKeyIdleTransitionSignalingEnabled is set to @c YES.
+ *
+ *  @return @c YES if the resource signals its busy to idle transitions, @c NO otherwise. Resources
+ *          that don't implement this method are assumed not to.
+ */
+- (BOOL)signalsIdleTransitions;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,109 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/**
+ *  @file GREYConfiguration+Internal.h
+ *  @brief Exposes GREYConfiguration's interfaces and methods that are otherwise private for use
+ *  by EarlGrey's internal components.
+ */
+
+#import <EarlGrey/GREYConfiguration.h>
+
+#include <stdatomic.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Typed values of the shared configuration for the keys that are read on hot paths, such as the
+ *  dispatch and CALayer animation hooks. Each field can be read with a plain atomic load instead of
+ *  a locked dictionary lookup. Read it through GREY_CONFIG_SNAPSHOT so that it is refreshed after
+ *  the configuration changes.
+ */
+typedef struct GREYConfigurationSnapshot {
+  /**
+   *  The value of @c kGREYConfigKeySynchronizationEnabled.
+   */
+  atomic_bool synchronizationEnabled;
+  /**
+   *  The value of @c kGREYConfigKeyCALayerModifyAnimations.
+   */
+  atomic_bool caLayerModifyAnimations;
+  /**
+   *  The value of @c kGREYConfigKeyCALayerMaxAnimationDuration.
+   */
+  _Atomic(double) caLayerMaxAnimationDuration;
+  /**
+   *  The value of @c kGREYConfigKeyDispatchAfterMaxTrackableDelay.
+   */
+  _Atomic(double) dispatchAfterMaxTrackableDelay;
+  /**
+   *  The value of @c kGREYConfigKeyDelayedPerformMaxTrackableDuration.
+   */
+  _Atomic(double) delayedPerformMaxTrackableDuration;
+  /**
+   *  The value of @c kGREYConfigKeyNSTimerMaxTrackableInterval.
+   */
+  _Atomic(double) nsTimerMaxTrackableInterval;
+} GREYConfigurationSnapshot;
+
+/**
+ *  The snapshot of the shared configuration. Only up to date if
+ *  @c gGREYConfigurationSnapshotIsValid is set.
+ */
+GREY_EXTERN GREYConfigurationSnapshot gGREYConfigurationSnapshot;
+
+/**
+ *  Whether @c gGREYConfigurationSnapshot is up to date. Cleared every time the configuration
+ *  changes.
+ */
+GREY_EXTERN atomic_bool gGREYConfigurationSnapshotIsValid;
+
+/**
+ *  Updates @c gGREYConfigurationSnapshot from the shared configuration and marks it as valid. Keys
+ *  set to a value that doesn't have the expected type are refreshed to their default value, or to
+ *  zero if that doesn't have the expected type either.
+ */
+GREY_EXTERN void GREYConfigurationRefreshSnapshot(void);
+
+/**
+ *  @return The up to date snapshot of the shared configuration.
+ */
+static inline GREYConfigurationSnapshot *GREYConfigurationGetSnapshot(void) {
+  if (!atomic_load_explicit(&gGREYConfigurationSnapshotIsValid, memory_order_acquire)) {
+    GREYConfigurationRefreshSnapshot();
+  }
+  return &gGREYConfigurationSnapshot;
+}
+
+/**
+ *  @return The value of the field @c __fieldName of the shared configuration's snapshot.
+ */
+#define GREY_CONFIG_SNAPSHOT(__fieldName) \
+  atomic_load_explicit(&GREYConfigurationGetSnapshot()->__fieldName, memory_order_relaxed)
+
+@interface GREYConfiguration (Internal)
+
+/**
+ *  @return A number that changes every time a value or a default value is set or the
+ *          configuration is reset. Values derived from the configuration can be cached along with
+ *          it and recomputed once it changes. Safe to call from any thread without locking.
+ */
+- (NSUInteger)changeCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -152,6 +152,124 @@ GREY_EXTERN NSString *const kGREYConfigKeyIncludeStatusBarWindow;
  */
 GREY_EXTERN NSString *const kGREYConfigKeyArtifactsDirLocation;
 
+/**
+ *  Configuration that enables/disables looking up elements matched by
+ *  GREYMatchers::matcherForAccessibilityID: in an index of the UI hierarchy rather than by
+ *  evaluating the complete matcher on every element of the hierarchy. A single element found
+ *  through the index is only returned once a traversal of the hierarchy confirms that no other
+ *  element has its accessibility identifier. Otherwise, the complete matcher is evaluated on the
+ *  entire hierarchy, so this pays off most for unique accessibility identifiers set on UIViews.
+ *
+ *  Accepted values: @c BOOL (i.e. @c YES or @c NO)
+ *  Default value: NO
+ */
+GREY_EXTERN NSString *const kGREYConfigKeyElementIndexEnabled;
+
+/**
+ *  Configuration that enables/disables skipping the descendants of hidden, transparent and
+ *  off-screen clipping views when searching for elements with a matcher that only accepts visible
+ *  elements, such as GREYMatchers::matcherForSufficientlyVisible. The elements in these subtrees
+ *  can't be visible, so pruning them doesn't change the result of the search.
+ *
+ *  Accepted values: @c BOOL (i.e. @c YES or @c NO)
+ *  Default value: NO
+ */
+GREY_EXTERN NSString *const kGREYConfigKeyInvisibleSubtreePruningEnabled;
+
+/**
+ *  Configuration that enables/disables letting the main thread sleep while waiting for idling
+ *  resources that signal their busy to idle transitions, as declared by
+ *  GREYIdlingResource::signalsIdleTransitions. The main thread is still woken up every 0.1 seconds
+ *  to poll the resources. When disabled, the run loop is kept awake and every idling resource is
+ *  polled on each pass until the app is idle.
+ *
+ *  Accepted values: @c BOOL (i.e. @c YES or @c NO)
+ *  Default value: NO
+ */
+GREY_EXTERN NSString *const kGREYConfigKeyIdleTransitionSignalingEnabled;
+
+/**
+ *  Configuration that enables/disables recording how long each synchronization waits on each
+ *  idling resource. The wait times of each test are written as JSON histograms to
+ *  @c sync_profile.json in the test's outputs directory when the test finishes.
+ *
+ *  Accepted values: @c BOOL (i.e. @c YES or @c NO)
+ *  Default value: NO
+ */
+GREY_EXTERN NSString *const kGREYConfigKeySyncProfilingEnabled;
+
+/**
+ *  Configuration that enables/disables tracing the phases of interactions, such as waiting for
+ *  the app to idle, searching for the element and performing the action. The spans of each test
+ *  are written in the Chrome trace event format to @c trace.json in the test's outputs directory
+ *  when the test finishes. The value is read at the start of every interaction.
+ *
+ *  Accepted values: @c BOOL (i.e. @c YES or @c NO)
+ *  Default value: NO
+ */
+GREY_EXTERN NSString *const kGREYConfigKeyTracingEnabled;
+
+/**
+ *  Configuration for the time in seconds that the main thread is first allowed to sleep between
+ *  polls of the idling resources while waiting for the app to idle. Every time the main thread is
+ *  woken up to poll, the interval is doubled up to
+ *  @c kGREYConfigKeySynchronizationBackoffMaxInterval. If 0, the run loop is kept awake and every
+ *  idling resource is polled on each pass until the app is idle.
+ *
+ *  Accepted values: @c double (non-negative)
+ *  Default value: 0
+ */
+GREY_EXTERN NSString *const kGREYConfigKeySynchronizationBackoffInitialInterval;
+
+/**
+ *  Configuration for the longest time in seconds that the main thread is allowed to sleep between
+ *  polls of the idling resources while backing off, if
+ *  @c kGREYConfigKeySynchronizationBackoffInitialInterval is greater than 0.
+ *
+ *  Accepted values: @c double (positive)
+ *  Default value: 0.1
+ */
+GREY_EXTERN NSString *const kGREYConfigKeySynchronizationBackoffMaxInterval;
+
+/**
+ *  Configuration that enables/disables fast-forwarding touch injection. When enabled, touches that
+ *  aren't timing sensitive are injected as soon as the previous touch has been delivered instead
+ *  of one per tick of the 60 Hz injection timer, and their timestamps are synthesized one tick
+ *  apart so that gesture velocities are computed as if they were delivered in real time. Touches
+ *  of expendable gestures, like swipes and pinches, and touches delayed by more than one tick,
+ *  like the end of a long press, are still delivered in real time.
+ *
+ *  Accepted values: @c BOOL (i.e. @c YES or @c NO)
+ *  Default value: NO
+ */
+GREY_EXTERN NSString *const kGREYConfigKeyTouchInjectionFastForwardEnabled;
+
+/**
+ *  Configuration that enables/disables planning the scroll amounts of search actions. When enabled,
+ *  a GREYScrollAction used as the search action of GREYInteraction::usingSearchAction:
+ *  onElementWithMatcher: starts by scrolling its given amount and doubles the amount after every
+ *  scroll that didn't reveal the element, up to three quarters of the scroll view's visible length
+ *  so that no content is skipped, and never past the remaining content of the scroll view.
+ *
+ *  Accepted values: @c BOOL (i.e. @c YES or @c NO)
+ *  Default value: NO
+ */
+GREY_EXTERN NSString *const kGREYConfigKeyScrollSearchPlanningEnabled;
+
+/**
+ *  Configuration that enables/disables scrolling by setting the content offset in search actions.
+ *  When enabled, a GREYScrollAction used as the search action of GREYInteraction::
+ *  usingSearchAction:onElementWithMatcher: moves the content of the scroll view one page at a time
+ *  by setting its content offset instead of injecting touches. Delegate callbacks and cell reuse
+ *  still happen for every page, but gesture recognizers and scrolling physics are not exercised,
+ *  so this should only be enabled for tests that scroll just to reveal content. Scroll views that
+ *  have scrolling disabled or paging enabled are still scrolled by injecting touches.
+ *
+ *  Accepted values: @c BOOL (i.e. @c YES or @c NO)
+ *  Default value: NO
+ */
+GREY_EXTERN NSString *const kGREYConfigKeyScrollSearchContentOffsetEnabled;
+
 /**
  *  Provides an interface for runtime configuration of EarlGrey's behavior.
  */
@@ -16,7 +16,10 @@
 
 #import "Common/GREYConfiguration.h"
 
+#include <stdatomic.h>
+
 #import "Additions/NSString+GREYAdditions.h"
+#import "Common/GREYConfiguration+Internal.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYLogger.h"
 #import "Common/GREYThrowDefines.h"
@@ -38,6 +41,73 @@ NSString *const kGREYConfigKeyDelayedPerformMaxTrackableDuration =
     @"GREYConfigKeyDelayedPerformMaxTrackableDuration";
 NSString *const kGREYConfigKeyIncludeStatusBarWindow = @"GREYConfigKeyIncludeStatusBarWindow";
 NSString *const kGREYConfigKeyArtifactsDirLocation = @"GREYConfigKeyArtifactsDirLocation";
+NSString *const kGREYConfigKeyElementIndexEnabled = @"GREYConfigKeyElementIndexEnabled";
+NSString *const kGREYConfigKeyInvisibleSubtreePruningEnabled =
+    @"GREYConfigKeyInvisibleSubtreePruningEnabled";
+NSString *const kGREYConfigKeyIdleTransitionSignalingEnabled =
+    @"GREYConfigKeyIdleTransitionSignalingEnabled";
+NSString *const kGREYConfigKeySyncProfilingEnabled = @"GREYConfigKeySyncProfilingEnabled";
+NSString *const kGREYConfigKeyTracingEnabled = @"GREYConfigKeyTracingEnabled";
+NSString *const kGREYConfigKeySynchronizationBackoffInitialInterval =
+    @"GREYConfigKeySynchronizationBackoffInitialInterval";
+NSString *const kGREYConfigKeySynchronizationBackoffMaxInterval =
+    @"GREYConfigKeySynchronizationBackoffMaxInterval";
+NSString *const kGREYConfigKeyTouchInjectionFastForwardEnabled =
+    @"GREYConfigKeyTouchInjectionFastForwardEnabled";
+NSString *const kGREYConfigKeyScrollSearchPlanningEnabled =
+    @"GREYConfigKeyScrollSearchPlanningEnabled";
+NSString *const kGREYConfigKeyScrollSearchContentOffsetEnabled =
+    @"GREYConfigKeyScrollSearchContentOffsetEnabled";
+
+GREYConfigurationSnapshot gGREYConfigurationSnapshot;
+atomic_bool gGREYConfigurationSnapshotIsValid;
+
+@interface GREYConfiguration ()
+
+/**
+ *  @return The @c NSValue that @c configKey is set to or, if it is set to a value of another type,
+ *          its default value. Only readers of the key through the typed getters see the type error,
+ *          so that a single misconfigured key doesn't break every reader of the snapshot.
+ */
+- (NSValue *)grey_snapshotValueForConfigKey:(NSString *)configKey;
+
+@end
+
+void GREYConfigurationRefreshSnapshot(void) {
+  GREYConfiguration *configuration = [GREYConfiguration sharedInstance];
+  // Refresh while holding the lock that setters hold while invalidating the snapshot, so that a
+  // snapshot of values that have since been changed is never marked as valid.
+  @synchronized(configuration) {
+    BOOL synchronizationEnabled =
+        [[configuration grey_snapshotValueForConfigKey:kGREYConfigKeySynchronizationEnabled]
+            boolValue];
+    BOOL caLayerModifyAnimations =
+        [[configuration grey_snapshotValueForConfigKey:kGREYConfigKeyCALayerModifyAnimations]
+            boolValue];
+    double caLayerMaxAnimationDuration =
+        [[configuration grey_snapshotValueForConfigKey:kGREYConfigKeyCALayerMaxAnimationDuration]
+            doubleValue];
+    double dispatchAfterMaxTrackableDelay =
+        [[configuration grey_snapshotValueForConfigKey:kGREYConfigKeyDispatchAfterMaxTrackableDelay]
+            doubleValue];
+    double delayedPerformMaxTrackableDuration = [[configuration
+        grey_snapshotValueForConfigKey:kGREYConfigKeyDelayedPerformMaxTrackableDuration]
+            doubleValue];
+    double nsTimerMaxTrackableInterval =
+        [[configuration grey_snapshotValueForConfigKey:kGREYConfigKeyNSTimerMaxTrackableInterval]
+            doubleValue];
+
+    GREYConfigurationSnapshot *snapshot = &gGREYConfigurationSnapshot;
+    atomic_store(&snapshot->synchronizationEnabled, synchronizationEnabled);
+    atomic_store(&snapshot->caLayerModifyAnimations, caLayerModifyAnimations);
+    atomic_store(&snapshot->caLayerMaxAnimationDuration, caLayerMaxAnimationDuration);
+    atomic_store(&snapshot->dispatchAfterMaxTrackableDelay, dispatchAfterMaxTrackableDelay);
+    atomic_store(&snapshot->delayedPerformMaxTrackableDuration,
+                 delayedPerformMaxTrackableDuration);
+    atomic_store(&snapshot->nsTimerMaxTrackableInterval, nsTimerMaxTrackableInterval);
+    atomic_store_explicit(&gGREYConfigurationSnapshotIsValid, true, memory_order_release);
+  }
+}
 
 @implementation GREYConfiguration {
   NSMutableDictionary *_defaultConfiguration; // Dict for storing the default configs
@@ -45,6 +115,7 @@ NSString *const kGREYConfigKeyArtifactsDirLocation = @"GREYConfigKeyArtifactsDir
   NSMutableDictionary *_mergedConfiguration; // Dict for storing the merged default/overridden dicts
   BOOL _needsMerge; // Indicates whether the merged configuration was invalidated due to a change
                     // in the default or overridden configurations
+  atomic_ulong _changeCount; // Incremented every time the configuration changes
 }
 
 - (instancetype)init {
@@ -71,6 +142,16 @@ NSString *const kGREYConfigKeyArtifactsDirLocation = @"GREYConfigKeyArtifactsDir
     [self setDefaultValue:@NO forConfigKey:kGREYConfigKeyIncludeStatusBarWindow];
     [self setDefaultValue:@(1.5) forConfigKey:kGREYConfigKeyDelayedPerformMaxTrackableDuration];
     [self setDefaultValue:@[] forConfigKey:kGREYConfigKeyURLBlacklistRegex];
+    [self setDefaultValue:@NO forConfigKey:kGREYConfigKeyElementIndexEnabled];
+    [self setDefaultValue:@NO forConfigKey:kGREYConfigKeyInvisibleSubtreePruningEnabled];
+    [self setDefaultValue:@NO forConfigKey:kGREYConfigKeyIdleTransitionSignalingEnabled];
+    [self setDefaultValue:@NO forConfigKey:kGREYConfigKeySyncProfilingEnabled];
+    [self setDefaultValue:@NO forConfigKey:kGREYConfigKeyTracingEnabled];
+    [self setDefaultValue:@0 forConfigKey:kGREYConfigKeySynchronizationBackoffInitialInterval];
+    [self setDefaultValue:@0.1 forConfigKey:kGREYConfigKeySynchronizationBackoffMaxInterval];
+    [self setDefaultValue:@NO forConfigKey:kGREYConfigKeyTouchInjectionFastForwardEnabled];
+    [self setDefaultValue:@NO forConfigKey:kGREYConfigKeyScrollSearchPlanningEnabled];
+    [self setDefaultValue:@NO forConfigKey:kGREYConfigKeyScrollSearchContentOffsetEnabled];
   }
   return self;
 }
@@ -94,6 +175,8 @@ NSString *const kGREYConfigKeyArtifactsDirLocation = @"GREYConfigKeyArtifactsDir
   @synchronized(self) {
     [_overridenConfiguration setObject:value forKey:configKey];
     _needsMerge = YES;
+    atomic_fetch_add(&_changeCount, 1);
+    atomic_store(&gGREYConfigurationSnapshotIsValid, false);
   }
   GREYLogVerbose(@"Config Key: %@ was set to: %@", configKey, value);
 }
@@ -106,6 +189,8 @@ NSString *const kGREYConfigKeyArtifactsDirLocation = @"GREYConfigKeyArtifactsDir
   @synchronized(self) {
     [_defaultConfiguration setObject:value forKey:configKey];
     _needsMerge = YES;
+    atomic_fetch_add(&_changeCount, 1);
+    atomic_store(&gGREYConfigurationSnapshotIsValid, false);
   }
   GREYLogVerbose(@"Default Value for Config Key: %@ was set to: %@", configKey, value);
 }
@@ -163,11 +248,31 @@ NSString *const kGREYConfigKeyArtifactsDirLocation = @"GREYConfigKeyArtifactsDir
     [_overridenConfiguration removeAllObjects];
     [_mergedConfiguration removeAllObjects];
     _needsMerge = YES;
+    atomic_fetch_add(&_changeCount, 1);
+    atomic_store(&gGREYConfigurationSnapshotIsValid, false);
   }
 }
 
+- (NSUInteger)changeCount {
+  return atomic_load(&_changeCount);
+}
+
 #pragma mark - Private
 
+- (NSValue *)grey_snapshotValueForConfigKey:(NSString *)configKey {
+  id value = [self valueForConfigKey:configKey];
+  if ([value isKindOfClass:[NSValue class]]) {
+    return value;
+  }
+  GREYLogVerbose(@"Config Key: %@ is set to a value of class %@, using its default value instead.",
+                 configKey,
+                 [value class]);
+  @synchronized(self) {
+    value = [_defaultConfiguration objectForKey:configKey];
+  }
+  return [value isKindOfClass:[NSValue class]] ? value : nil;
+}
+
 /**
  *  Validates the given @c configKey.
  *
@@ -38,6 +38,23 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (UIImage *)grey_takeScreenshotAfterScreenUpdates:(BOOL)afterScreenUpdates;
 
+/**
+ *  Provides a UIImage of the region of the screen enclosed by @c rectInPixels. Only the windows
+ *  that intersect the region are rendered and the resulting bitmap is only as large as the region,
+ *  so the cost of the capture scales with the size of the region rather than the screen.
+ *
+ *  @param rectInPixels       A pixel aligned rect in variable screen coordinates (in pixels) of
+ *                            the region to capture.
+ *  @param afterScreenUpdates A Boolean specifying if the screenshot is to be taken immediately or
+ *                            after a screen update.
+ *
+ *  @return A UIImage containing a screenshot of the given region or @c nil if the region is empty.
+ *
+ *  @remark This is available only for internal testing purposes.
+ */
++ (UIImage *_Nullable)grey_takeScreenshotOfRect:(CGRect)rectInPixels
+                             afterScreenUpdates:(BOOL)afterScreenUpdates;
+
 @end
 
 NS_ASSUME_NONNULL_END
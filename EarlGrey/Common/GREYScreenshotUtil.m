@@ -16,6 +16,7 @@
 
 #import "Common/GREYScreenshotUtil.h"
 
+#import "Additions/CGGeometry+GREYAdditions.h"
 #import "Additions/NSObject+GREYAdditions.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYThrowDefines.h"
@@ -48,60 +49,15 @@ static Class gUIModalItemHostingWindowClass;
   UIScreen *mainScreen = [UIScreen mainScreen];
   CGRect screenRect = [self grey_rectRotatedToStatusBarOrientation:mainScreen.bounds];
 
-  UIInterfaceOrientation orientation = [UIApplication sharedApplication].statusBarOrientation;
-
   // The bitmap context width and height are scaled, so we need to undo the scale adjustment.
   CGFloat contextWidth = CGBitmapContextGetWidth(bitmapContextRef) / mainScreen.scale;
   CGFloat contextHeight = CGBitmapContextGetHeight(bitmapContextRef) / mainScreen.scale;
   CGFloat xOffset = (contextWidth - screenRect.size.width) / 2;
   CGFloat yOffset = (contextHeight - screenRect.size.height) / 2;
-  for (UIWindow *window in [[GREYUIWindowProvider allWindows] reverseObjectEnumerator]) {
-    if (window.hidden || window.alpha == 0) {
-      continue;
-    }
-
-    CGContextSaveGState(bitmapContextRef);
-
-    CGRect windowRect = window.bounds;
-    CGPoint windowCenter = window.center;
-    CGPoint windowAnchor = window.layer.anchorPoint;
-
-    CGContextTranslateCTM(bitmapContextRef, windowCenter.x + xOffset, windowCenter.y + yOffset);
-    CGContextConcatCTM(bitmapContextRef, window.transform);
-    CGContextTranslateCTM(bitmapContextRef,
-                          -CGRectGetWidth(windowRect) * windowAnchor.x,
-                          -CGRectGetHeight(windowRect) * windowAnchor.y);
-    if (!iOS8_0_OR_ABOVE()) {
-      if (orientation == UIInterfaceOrientationLandscapeLeft) {
-        // Rotate pi/2
-        CGContextConcatCTM(bitmapContextRef, CGAffineTransformMake(0, 1, -1, 0, 0, 0));
-        CGContextTranslateCTM(bitmapContextRef, 0, -CGRectGetWidth(screenRect));
-      } else if (orientation == UIInterfaceOrientationLandscapeRight) {
-        // Rotate -pi/2
-        CGContextConcatCTM(bitmapContextRef, CGAffineTransformMake(0, -1, 1, 0, 0, 0));
-        CGContextTranslateCTM(bitmapContextRef, -CGRectGetHeight(screenRect), 0);
-      } else if (orientation == UIInterfaceOrientationPortraitUpsideDown) {
-        // Rotate pi
-        CGContextConcatCTM(bitmapContextRef, CGAffineTransformMake(-1, 0, 0, -1, 0, 0));
-        CGContextTranslateCTM(bitmapContextRef,
-                              -CGRectGetWidth(screenRect),
-                              -CGRectGetHeight(screenRect));
-      }
-    }
-
-    // This special case is for Alert-Views that for some reason do not render correctly.
-    if ([window isKindOfClass:gUIAlertControllerShimPresenterWindowClass] ||
-        [window isKindOfClass:gUIModalItemHostingWindowClass]) {
-      [window.layer renderInContext:UIGraphicsGetCurrentContext()];
-    } else {
-      BOOL success = [window drawViewHierarchyInRect:windowRect afterScreenUpdates:afterUpdates];
-      if (!success) {
-        NSLog(@"Failed to drawViewHierarchyInRect for window: %@", window);
-      }
-    }
-
-    CGContextRestoreGState(bitmapContextRef);
-  }
+  [self grey_drawWindowsInContext:bitmapContextRef
+                       withOffset:CGPointMake(xOffset, yOffset)
+                 intersectingRect:CGRectNull
+               afterScreenUpdates:afterUpdates];
 }
 
 + (UIImage *)takeScreenshot {
@@ -203,8 +159,134 @@ static Class gUIModalItemHostingWindowClass;
   return orientedScreenshot;
 }
 
++ (UIImage *)grey_takeScreenshotOfRect:(CGRect)rectInPixels
+                    afterScreenUpdates:(BOOL)afterScreenUpdates {
+  GREYFatalAssertWithMessage(CGRectEqualToRect(rectInPixels, CGRectIntegral(rectInPixels)),
+                             @"The screenshot rect must be pixel aligned.");
+  CGFloat scale = [UIScreen mainScreen].scale;
+  size_t width = (size_t)CGRectGetWidth(rectInPixels);
+  size_t height = (size_t)CGRectGetHeight(rectInPixels);
+  if (width == 0 || height == 0) {
+    return nil;
+  }
+
+  // The bitmap is created with the exact pixel dimensions of the rect instead of going through
+  // UIGraphicsBeginImageContextWithOptions, which would round the point size back to pixels.
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGContextRef bitmapContextRef =
+      CGBitmapContextCreate(NULL,
+                            width,
+                            height,
+                            8, // bits per component
+                            width * kBytesPerPixel, // bytes per row
+                            colorSpace,
+                            kCGImageAlphaNoneSkipFirst | kCGBitmapByteOrder32Big);
+  CGColorSpaceRelease(colorSpace);
+  if (!bitmapContextRef) {
+    return nil;
+  }
+
+  // Flip to UIKit's coordinate system, then move the region's origin to the context's origin so
+  // that anything outside of it is clipped by the bitmap bounds.
+  CGRect rectInPoints = CGRectPixelToPoint(rectInPixels);
+  CGContextTranslateCTM(bitmapContextRef, 0, height);
+  CGContextScaleCTM(bitmapContextRef, scale, -scale);
+  CGContextTranslateCTM(bitmapContextRef,
+                        -CGRectGetMinX(rectInPoints),
+                        -CGRectGetMinY(rectInPoints));
+
+  UIGraphicsPushContext(bitmapContextRef);
+  [self grey_drawWindowsInContext:bitmapContextRef
+                       withOffset:CGPointZero
+                 intersectingRect:rectInPoints
+               afterScreenUpdates:afterScreenUpdates];
+  UIGraphicsPopContext();
+
+  CGImageRef imageRef = CGBitmapContextCreateImage(bitmapContextRef);
+  UIImage *screenshot = [UIImage imageWithCGImage:imageRef
+                                            scale:scale
+                                      orientation:UIImageOrientationUp];
+  CGImageRelease(imageRef);
+  CGContextRelease(bitmapContextRef);
+  return screenshot;
+}
+
 #pragma mark - Private
 
+/**
+ *  Draws every visible window of the application in the given @c bitmapContextRef, translated by
+ *  @c offset. If @c rectInPoints is not @c CGRectNull, windows that do not intersect it are skipped
+ *  entirely, which avoids rendering window hierarchies that can't contribute to the drawn region.
+ *
+ *  @param bitmapContextRef Target bitmap context for rendering.
+ *  @param offset           The offset (in points) to apply to each window before drawing it.
+ *  @param rectInPoints     The region of the screen being drawn or @c CGRectNull to draw all
+ *                          windows.
+ *  @param afterUpdates     Boolean indicating whether to render before (@c NO) or after (@c YES)
+ *                          screen updates.
+ */
++ (void)grey_drawWindowsInContext:(CGContextRef)bitmapContextRef
+                       withOffset:(CGPoint)offset
+                 intersectingRect:(CGRect)rectInPoints
+               afterScreenUpdates:(BOOL)afterUpdates {
+  CGRect screenRect = [self grey_rectRotatedToStatusBarOrientation:[UIScreen mainScreen].bounds];
+  UIInterfaceOrientation orientation = [UIApplication sharedApplication].statusBarOrientation;
+  // On iOS 7, window frames are in fixed coordinates while the region is in variable coordinates,
+  // so windows can only be culled on iOS 8 and above.
+  BOOL cullWindows = !CGRectIsNull(rectInPoints) && iOS8_0_OR_ABOVE();
+
+  for (UIWindow *window in [[GREYUIWindowProvider allWindows] reverseObjectEnumerator]) {
+    if (window.hidden || window.alpha == 0) {
+      continue;
+    }
+    if (cullWindows && !CGRectIntersectsRect(window.frame, rectInPoints)) {
+      continue;
+    }
+
+    CGContextSaveGState(bitmapContextRef);
+
+    CGRect windowRect = window.bounds;
+    CGPoint windowCenter = window.center;
+    CGPoint windowAnchor = window.layer.anchorPoint;
+
+    CGContextTranslateCTM(bitmapContextRef, windowCenter.x + offset.x, windowCenter.y + offset.y);
+    CGContextConcatCTM(bitmapContextRef, window.transform);
+    CGContextTranslateCTM(bitmapContextRef,
+                          -CGRectGetWidth(windowRect) * windowAnchor.x,
+                          -CGRectGetHeight(windowRect) * windowAnchor.y);
+    if (!iOS8_0_OR_ABOVE()) {
+      if (orientation == UIInterfaceOrientationLandscapeLeft) {
+        // Rotate pi/2
+        CGContextConcatCTM(bitmapContextRef, CGAffineTransformMake(0, 1, -1, 0, 0, 0));
+        CGContextTranslateCTM(bitmapContextRef, 0, -CGRectGetWidth(screenRect));
+      } else if (orientation == UIInterfaceOrientationLandscapeRight) {
+        // Rotate -pi/2
+        CGContextConcatCTM(bitmapContextRef, CGAffineTransformMake(0, -1, 1, 0, 0, 0));
+        CGContextTranslateCTM(bitmapContextRef, -CGRectGetHeight(screenRect), 0);
+      } else if (orientation == UIInterfaceOrientationPortraitUpsideDown) {
+        // Rotate pi
+        CGContextConcatCTM(bitmapContextRef, CGAffineTransformMake(-1, 0, 0, -1, 0, 0));
+        CGContextTranslateCTM(bitmapContextRef,
+                              -CGRectGetWidth(screenRect),
+                              -CGRectGetHeight(screenRect));
+      }
+    }
+
+    // This special case is for Alert-Views that for some reason do not render correctly.
+    if ([window isKindOfClass:gUIAlertControllerShimPresenterWindowClass] ||
+        [window isKindOfClass:gUIModalItemHostingWindowClass]) {
+      [window.layer renderInContext:UIGraphicsGetCurrentContext()];
+    } else {
+      BOOL success = [window drawViewHierarchyInRect:windowRect afterScreenUpdates:afterUpdates];
+      if (!success) {
+        NSLog(@"Failed to drawViewHierarchyInRect for window: %@", window);
+      }
+    }
+
+    CGContextRestoreGState(bitmapContextRef);
+  }
+}
+
 + (CGRect)grey_rectRotatedToStatusBarOrientation:(CGRect)rect {
   UIInterfaceOrientation orientation = [UIApplication sharedApplication].statusBarOrientation;
   if (!iOS8_0_OR_ABOVE() && UIInterfaceOrientationIsLandscape(orientation)) {
@@ -0,0 +1,127 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/**
+ *  @file GREYTracer.h
+ *  @brief Records nested timing spans for the phases of every interaction and writes them per test
+ *         in the Chrome trace event format, so that test runs can be inspected in a trace viewer.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  The name of the file the trace of a test is written to.
+ */
+extern NSString *const kGREYTraceFileName;
+
+/**
+ *  Names of the spans recorded by EarlGrey.
+ */
+extern NSString *const kGREYTraceSpanPerformAction;
+extern NSString *const kGREYTraceSpanAssert;
+extern NSString *const kGREYTraceSpanSyncWait;
+extern NSString *const kGREYTraceSpanElementSearch;
+extern NSString *const kGREYTraceSpanMatcherEvaluation;
+extern NSString *const kGREYTraceSpanVisibilityRender;
+extern NSString *const kGREYTraceSpanActionExecution;
+extern NSString *const kGREYTraceSpanAssertionExecution;
+extern NSString *const kGREYTraceSpanPostActionDrain;
+
+/**
+ *  A span of time that is being traced.
+ */
+typedef struct GREYTraceSpan {
+  /**
+   *  The name of the span. It isn't retained, so it must be a constant string.
+   */
+  __unsafe_unretained NSString *_Nullable name;
+  /**
+   *  The time at which the span began, or 0 if the span isn't being recorded.
+   */
+  CFTimeInterval startTime;
+} GREYTraceSpan;
+
+/**
+ *  Begins a span for an interaction, which is where tracing is turned on or off: whether spans are
+ *  recorded is read from @c kGREYConfigKeyTracingEnabled here and applies until the next
+ *  interaction begins.
+ *
+ *  @param name The name of the span. It must be a constant string.
+ *
+ *  @return The span, which must be ended with GREYTraceEnd.
+ */
+GREYTraceSpan GREYTraceBeginInteraction(NSString *name);
+
+/**
+ *  Begins a span nested in the spans that are currently open. If tracing is off, this only checks a
+ *  flag and returns a span that won't be recorded.
+ *
+ *  @param name The name of the span. It must be a constant string.
+ *
+ *  @return The span, which must be ended with GREYTraceEnd.
+ */
+GREYTraceSpan GREYTraceBegin(NSString *name);
+
+/**
+ *  Ends @c span and records it if it was begun while tracing was on. Ending a span that has already
+ *  been ended does nothing.
+ *
+ *  @param span The span to end.
+ */
+void GREYTraceEnd(GREYTraceSpan *span);
+
+/**
+ *  Ends @c span like GREYTraceEnd, attaching @c arguments to it.
+ *
+ *  @param span      The span to end.
+ *  @param arguments Arguments to display with the span. They must be serializable as JSON.
+ */
+void GREYTraceEndWithArguments(GREYTraceSpan *span, NSDictionary<NSString *, id> *arguments);
+
+/**
+ *  Collects the spans recorded for the current test. When a test finishes, its spans, along with a
+ *  span for the test itself, are written to @c kGREYTraceFileName in the test outputs directory as
+ *  Chrome trace events. Timestamps share the same origin for all tests, so the traces of the tests
+ *  of a run can be merged into one.
+ */
+@interface GREYTracer : NSObject
+
+/**
+ *  @return The unique shared instance of the GREYTracer.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ *  @remark init is not an available initializer. Use the other initializers.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ *  @return The trace events recorded since the last reset.
+ */
+- (NSArray<NSDictionary<NSString *, id> *> *)traceEvents;
+
+/**
+ *  Discards the trace events recorded so far.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
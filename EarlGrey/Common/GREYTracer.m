@@ -0,0 +1,221 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#import "Common/GREYTracer.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#import <QuartzCore/QuartzCore.h>
+
+#import "Additions/XCTestCase+GREYAdditions.h"
+#import "Common/GREYConfiguration.h"
+
+// Extern.
+NSString *const kGREYTraceFileName = @"trace.json";
+NSString *const kGREYTraceSpanPerformAction = @"Perform Action";
+NSString *const kGREYTraceSpanAssert = @"Assert";
+NSString *const kGREYTraceSpanSyncWait = @"Sync Wait";
+NSString *const kGREYTraceSpanElementSearch = @"Element Search";
+NSString *const kGREYTraceSpanMatcherEvaluation = @"Matcher Evaluation";
+NSString *const kGREYTraceSpanVisibilityRender = @"Visibility Render";
+NSString *const kGREYTraceSpanActionExecution = @"Action Execution";
+NSString *const kGREYTraceSpanAssertionExecution = @"Assertion Execution";
+NSString *const kGREYTraceSpanPostActionDrain = @"Post-Action Drain";
+
+/**
+ *  Whether spans are being recorded, as last read from @c kGREYConfigKeyTracingEnabled.
+ */
+static atomic_bool gTracingEnabled;
+
+/**
+ *  Microseconds per second, the unit of Chrome trace event timestamps.
+ */
+static const double kMicrosecondsPerSecond = 1000000;
+
+@interface GREYTracer ()
+
+/**
+ *  Records a complete span on the current thread.
+ *
+ *  @param name      The name of the span.
+ *  @param category  The category of the span.
+ *  @param startTime The time at which the span began.
+ *  @param endTime   The time at which the span ended.
+ *  @param arguments Arguments to display with the span, or @c nil if there are none.
+ */
+- (void)grey_recordSpanNamed:(NSString *)name
+                    category:(NSString *)category
+                   startTime:(CFTimeInterval)startTime
+                     endTime:(CFTimeInterval)endTime
+                   arguments:(NSDictionary *)arguments;
+
+@end
+
+GREYTraceSpan GREYTraceBeginInteraction(NSString *name) {
+  atomic_store(&gTracingEnabled, GREY_CONFIG_BOOL(kGREYConfigKeyTracingEnabled));
+  return GREYTraceBegin(name);
+}
+
+GREYTraceSpan GREYTraceBegin(NSString *name) {
+  GREYTraceSpan span = { name, 0 };
+  if (atomic_load_explicit(&gTracingEnabled, memory_order_relaxed)) {
+    span.startTime = CACurrentMediaTime();
+  }
+  return span;
+}
+
+void GREYTraceEnd(GREYTraceSpan *span) {
+  GREYTraceEndWithArguments(span, nil);
+}
+
+void GREYTraceEndWithArguments(GREYTraceSpan *span, NSDictionary<NSString *, id> *arguments) {
+  if (span->startTime == 0) {
+    return;
+  }
+  [[GREYTracer sharedInstance] grey_recordSpanNamed:span->name
+                                           category:@"EarlGrey"
+                                          startTime:span->startTime
+                                            endTime:CACurrentMediaTime()
+                                          arguments:arguments];
+  span->startTime = 0;
+}
+
+@implementation GREYTracer {
+  /**
+   *  The trace events recorded for the current test.
+   */
+  NSMutableArray<NSDictionary<NSString *, id> *> *_traceEvents;
+  /**
+   *  The time at which the current test started.
+   */
+  CFTimeInterval _testStartTime;
+}
+
++ (void)load {
+  @autoreleasepool {
+    // Create the tracer before any test is set up, so that it observes every test from its start
+    // rather than only the tests after the first span was recorded.
+    [GREYTracer sharedInstance];
+  }
+}
+
++ (instancetype)sharedInstance {
+  static GREYTracer *instance = nil;
+  static dispatch_once_t token = 0;
+  dispatch_once(&token, ^{
+    instance = [[GREYTracer alloc] initOnce];
+  });
+  return instance;
+}
+
+/**
+ *  Initializes the tracer. Not thread-safe. Must be invoked under a race-free synchronized
+ *  environment by the caller.
+ *
+ *  @return The initialized instance.
+ */
+- (instancetype)initOnce {
+  self = [super init];
+  if (self) {
+    _traceEvents = [[NSMutableArray alloc] init];
+    _testStartTime = CACurrentMediaTime();
+    NSNotificationCenter *defaultNotificationCenter = [NSNotificationCenter defaultCenter];
+    [defaultNotificationCenter addObserver:self
+                                  selector:@selector(grey_testCaseWillSetUp:)
+                                      name:kGREYXCTestCaseInstanceWillSetUp
+                                    object:nil];
+    [defaultNotificationCenter addObserver:self
+                                  selector:@selector(grey_testCaseDidFinish:)
+                                      name:kGREYXCTestCaseInstanceDidFinish
+                                    object:nil];
+  }
+  return self;
+}
+
+- (NSArray<NSDictionary<NSString *, id> *> *)traceEvents {
+  @synchronized(self) {
+    return [_traceEvents copy];
+  }
+}
+
+- (void)reset {
+  @synchronized(self) {
+    [_traceEvents removeAllObjects];
+  }
+}
+
+#pragma mark - Private
+
+- (void)grey_recordSpanNamed:(NSString *)name
+                    category:(NSString *)category
+                   startTime:(CFTimeInterval)startTime
+                     endTime:(CFTimeInterval)endTime
+                   arguments:(NSDictionary *)arguments {
+  NSMutableDictionary *event = [@{ @"name" : name,
+                                   @"cat" : category,
+                                   @"ph" : @"X",
+                                   @"ts" : @(startTime * kMicrosecondsPerSecond),
+                                   @"dur" : @((endTime - startTime) * kMicrosecondsPerSecond),
+                                   @"pid" : @(getpid()),
+                                   @"tid" : @(pthread_mach_thread_np(pthread_self())) }
+                                mutableCopy];
+  if (arguments) {
+    event[@"args"] = arguments;
+  }
+  @synchronized(self) {
+    [_traceEvents addObject:event];
+  }
+}
+
+/**
+ *  Starts tracing the test that is being set up from scratch.
+ *
+ *  @param notification The notification posted when the test is about to be set up.
+ */
+- (void)grey_testCaseWillSetUp:(NSNotification *)notification {
+  [self reset];
+  _testStartTime = CACurrentMediaTime();
+}
+
+/**
+ *  Writes the spans of the test that finished, along with a span for the test, to its outputs
+ *  directory.
+ *
+ *  @param notification The notification posted when the test finished.
+ */
+- (void)grey_testCaseDidFinish:(NSNotification *)notification {
+  XCTestCase *testCase = notification.userInfo[kGREYXCTestCaseNotificationKey];
+  if (!testCase || [[self traceEvents] count] == 0) {
+    [self reset];
+    return;
+  }
+
+  NSString *testName = [NSString stringWithFormat:@"-[%@ %@]",
+                                                  [testCase grey_testClassName],
+                                                  [testCase grey_testMethodName]];
+  [self grey_recordSpanNamed:testName
+                    category:@"Test"
+                   startTime:_testStartTime
+                     endTime:CACurrentMediaTime()
+                   arguments:nil];
+  NSDictionary *trace = @{ @"traceEvents" : [self traceEvents], @"displayTimeUnit" : @"ms" };
+  [self reset];
+  [testCase grey_writeJSONObject:trace toTestOutputsFileNamed:kGREYTraceFileName options:0];
+}
+
+@end
@@ -0,0 +1,42 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/**
+ *  @file GREYVisibilityChecker+Internal.h
+ *  @brief Exposes GREYVisibilityChecker's interfaces that are used by the UIKit and QuartzCore
+ *  additions to keep the visibility checker's cache up to date.
+ */
+
+#import "Common/GREYVisibilityChecker.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Bumps the generation of the UI as seen by the visibility checker. Results cached by
+ *  GREYVisibilityChecker are reused across runloop drains only as long as the generation hasn't
+ *  changed since they were computed, so this must be called whenever the UI changes in a way that
+ *  may affect what is drawn on screen. It is cheap and can be called from any thread.
+ */
+void GREYVisibilityCheckerBumpGeneration(void);
+
+/**
+ *  @return The current generation of the UI as seen by the visibility checker.
+ *
+ *  @remark This is available only for internal testing purposes.
+ */
+unsigned long GREYVisibilityCheckerGeneration(void);
+
+NS_ASSUME_NONNULL_END
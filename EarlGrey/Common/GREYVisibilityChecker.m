@@ -14,9 +14,10 @@
 // limitations under the License.
 //
 
-#import "Common/GREYVisibilityChecker.h"
+#import "Common/GREYVisibilityChecker+Internal.h"
 
 #include <CoreGraphics/CoreGraphics.h>
+#include <stdatomic.h>
 
 #import "Additions/CGGeometry+GREYAdditions.h"
 #import "Additions/NSObject+GREYAdditions.h"
@@ -25,6 +26,9 @@
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYLogger.h"
 #import "Common/GREYScreenshotUtil+Internal.h"
+#import "Common/GREYTracer.h"
+#import "Common/GREYVisibilityKernels.h"
+#import "Synchronization/GREYAppStateTracker.h"
 
 static const NSUInteger kColorChannelsPerPixel = 4;
 
@@ -78,10 +82,38 @@ static UIImage *gLastActualAfterImage;
 @end
 
 /**
- *  Cache for storing recent visibility checks. This cache is invalidated on the next runloop drain.
+ *  Cache for storing recent visibility checks, keyed by the element's pointer. Elements are held
+ *  weakly so that entries go away with their elements and can't be picked up by another element
+ *  allocated at the same address. The cache is validated once per runloop drain and invalidated if
+ *  the UI generation has changed since it was filled.
  */
 static NSMapTable *gCache;
 
+/**
+ *  The UI generation, bumped by the UIKit and QuartzCore swizzles whenever the UI changes.
+ */
+static atomic_ulong gGeneration;
+
+/**
+ *  The UI generation at which the entries in @c gCache were computed.
+ */
+static unsigned long gCacheGeneration;
+
+/**
+ *  App states during which the screen changes without the UI generation being bumped, such as while
+ *  animations or scrolling are in flight. Nothing cached is kept across drains in these states.
+ */
+static const GREYAppState kGREYVisibilityUnstableStates =
+    kGREYPendingCAAnimation | kGREYPendingUIAnimation | kGREYPendingUIScrollViewScrolling;
+
+void GREYVisibilityCheckerBumpGeneration(void) {
+  atomic_fetch_add_explicit(&gGeneration, 1, memory_order_relaxed);
+}
+
+unsigned long GREYVisibilityCheckerGeneration(void) {
+  return atomic_load_explicit(&gGeneration, memory_order_relaxed);
+}
+
 #pragma mark - GREYVisibilityDiffBuffer
 
 GREYVisibilityDiffBuffer GREYVisibilityDiffBufferCreate(size_t width, size_t height) {
@@ -352,36 +384,29 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
 #pragma mark - Private
 
 /**
- *  @return The cached key for an @c element.
+ *  Invalidates the cache if the UI generation has changed since it was filled or if the screen might
+ *  be changing on its own. This is done at most once per runloop drain, so results are never
+ *  invalidated in the middle of a drain: a generation change during a drain only invalidates the
+ *  cache the first time it is validated in a later drain.
  */
-+ (NSString *)grey_keyForElement:(id)element {
-  return [NSString stringWithFormat:@"%p", element];
-}
-
-/**
- *  Saves a cache @c entry for an @c element and adds it for invalidation on the next runloop drain.
- *
- *  @param entry   The cache entry to be saved.
- *  @param element The element to which the entry is associated.
- */
-+ (void)grey_addCache:(GREYVisibilityCheckerCacheEntry *)entry forElement:(id)element {
-  if (!gCache) {
-    gCache = [NSMapTable strongToStrongObjectsMapTable];
++ (void)grey_validateCache {
+  static BOOL validatedInThisDrain = NO;
+  if (validatedInThisDrain) {
+    return;
   }
+  validatedInThisDrain = YES;
+  dispatch_async(dispatch_get_main_queue(), ^{
+    validatedInThisDrain = NO;
+  });
 
-  // Get the pointer value and store it as a string.
-  NSString *elementKey = [self grey_keyForElement:element];
-  [gCache setObject:entry forKey:elementKey];
-
-  // Set us up for invalidation on the next runloop drain.
-  static BOOL pendingInvalidation = NO;
-  if (!pendingInvalidation) {
-    pendingInvalidation = YES;
-    dispatch_async(dispatch_get_main_queue(), ^{
-      pendingInvalidation = NO;
-      [GREYVisibilityChecker grey_invalidateCache];
-    });
+  unsigned long generation = GREYVisibilityCheckerGeneration();
+  if ([gCache count] > 0) {
+    GREYAppState state = [[GREYAppStateTracker sharedInstance] currentState];
+    if (generation != gCacheGeneration || (state & kGREYVisibilityUnstableStates)) {
+      [self grey_invalidateCache];
+    }
   }
+  gCacheGeneration = generation;
 }
 
 /**
@@ -397,15 +422,19 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
   if (!element) {
     return nil;
   }
-  GREYVisibilityCheckerCacheEntry *entry;
-  if (gCache) {
-    NSString *elementKey = [self grey_keyForElement:element];
-    entry = [gCache objectForKey:elementKey];
+  if (!gCache) {
+    NSPointerFunctionsOptions keyOptions =
+        NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality;
+    gCache = [[NSMapTable alloc] initWithKeyOptions:keyOptions
+                                       valueOptions:NSPointerFunctionsStrongMemory
+                                           capacity:0];
   }
+  [self grey_validateCache];
 
+  GREYVisibilityCheckerCacheEntry *entry = [gCache objectForKey:element];
   if (!entry) {
     entry = [[GREYVisibilityCheckerCacheEntry alloc] init];
-    [self grey_addCache:entry forElement:element];
+    [gCache setObject:entry forKey:element];
   }
   return entry;
 }
@@ -578,13 +607,18 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
   // run are committed to the presentation layer.
   // @see
   // http://optshiftk.com/2013/11/better-documentation-for-catransaction-flush/
+  GREYTraceSpan renderSpan = GREYTraceBegin(kGREYTraceSpanVisibilityRender);
   [CATransaction begin];
   [CATransaction flush];
   [CATransaction commit];
-  UIImage *beforeScreenshot = [GREYScreenshotUtil grey_takeScreenshotAfterScreenUpdates:YES];
-  CGImageRef beforeImage =
-      CGImageCreateWithImageInRect(beforeScreenshot.CGImage, screenshotSearchRect_pixel);
+  // Only the search rect is rendered, which keeps the cost of the capture proportional to the
+  // element's area rather than the screen's.
+  UIImage *beforeScreenshot =
+      [GREYScreenshotUtil grey_takeScreenshotOfRect:screenshotSearchRect_pixel
+                                 afterScreenUpdates:YES];
+  CGImageRef beforeImage = CGImageRetain(beforeScreenshot.CGImage);
   if (!beforeImage) {
+    GREYTraceEnd(&renderSpan);
     return NO;
   }
 
@@ -624,9 +658,12 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
       [self grey_imageViewWithShiftedColorOfImage:beforeImage
                                       frameOffset:searchRectOffset
                                       orientation:beforeScreenshot.imageOrientation];
-  UIImage *afterScreenshot = [self grey_imageAfterAddingSubview:shiftedView toView:view];
-  CGImageRef afterImage =
-      CGImageCreateWithImageInRect(afterScreenshot.CGImage, screenshotSearchRect_pixel);
+  UIImage *afterScreenshot =
+      [self grey_imageAfterAddingSubview:shiftedView
+                                  toView:view
+                  andCaptureRectInPixels:screenshotSearchRect_pixel];
+  GREYTraceEnd(&renderSpan);
+  CGImageRef afterImage = CGImageRetain(afterScreenshot.CGImage);
   if (!afterImage) {
     GREYFatalAssertWithMessage(NO, @"afterImage should not be null");
     CGImageRelease(beforeImage);
@@ -641,10 +678,25 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
   return YES;
 }
 
-+ (UIImage *)grey_imageAfterAddingSubview:(UIView *)shiftedView toView:(UIView *)view {
+/**
+ *  Adds @c shiftedView on top of the subviews of @c view and captures the region of the screen
+ *  enclosed by @c rectInPixels before removing it again.
+ *
+ *  @param shiftedView  The view with shifted colors to be added to @c view.
+ *  @param view         The view whose visibility check is being performed.
+ *  @param rectInPixels The region of the screen (in pixels) to capture.
+ *
+ *  @return A screenshot of the given region with @c shiftedView added to @c view.
+ */
++ (UIImage *)grey_imageAfterAddingSubview:(UIView *)shiftedView
+                                   toView:(UIView *)view
+                   andCaptureRectInPixels:(CGRect)rectInPixels {
   GREYFatalAssert(shiftedView);
   GREYFatalAssert(view);
 
+  // Adding and removing the shifted view bumps the UI generation. Don't let that invalidate the
+  // cache, unless it was already stale.
+  unsigned long generationBeforeCheck = GREYVisibilityCheckerGeneration();
   UIImage *screenshot = [self grey_prepareView:view forVisibilityCheckAndPerformBlock:^id {
     [CATransaction begin];
     [CATransaction setDisableActions:YES];
@@ -653,10 +705,14 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
     [CATransaction flush];
     [CATransaction commit];
 
-    UIImage *shiftedImage = [GREYScreenshotUtil grey_takeScreenshotAfterScreenUpdates:YES];
+    UIImage *shiftedImage = [GREYScreenshotUtil grey_takeScreenshotOfRect:rectInPixels
+                                                       afterScreenUpdates:YES];
     [shiftedView removeFromSuperview];
     return shiftedImage;
   }];
+  if (gCacheGeneration == generationBeforeCheck) {
+    gCacheGeneration = GREYVisibilityCheckerGeneration();
+  }
   return screenshot;
 }
 
@@ -705,72 +761,6 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
   return retVal;
 }
 
-/**
- *  Given a list of values representing a histogram (values are the heights of the bars), this
- *  method returns the largest contiguous rectangle in that histogram.
- *
- *  @param histogram The array of values representing the histogram.
- *  @param length    The number of values in the histogram.
- *
- *  @return A CGRect of the largest rectangle in the given histogram.
- */
-+ (CGRect)grey_largestRectInHistogram:(uint16_t *)histogram length:(uint16_t)length {
-  uint16_t *leftNeighbors = malloc(sizeof(uint16_t) * length);
-  uint16_t *rightNeighbors = malloc(sizeof(uint16_t) * length);
-  uint16_t *leftStack = malloc(sizeof(uint16_t) * length);
-  uint16_t *rightStack = malloc(sizeof(uint16_t) * length);
-  // Index of the last element on the stack.
-  NSInteger leftStackIdx = -1;
-  NSInteger rightStackIdx = -1;
-  CGRect largestRect = CGRectZero;
-  CGFloat largestArea = 0;
-  // We make two passes at once, one from left to right and one from right to left.
-  for (uint16_t idx = 0; idx < length; idx++) {
-    uint16_t tailIdx = (length - 1) - idx;
-    // Find nearest column shorter than this one on either side.
-    while (leftStackIdx >= 0 && histogram[leftStack[leftStackIdx]] >= histogram[idx]) {
-      leftStackIdx--;
-    }
-    while (rightStackIdx >= 0 && histogram[rightStack[rightStackIdx]] >= histogram[tailIdx]) {
-      rightStackIdx--;
-    }
-    // Set the number of columns at least as tall as this one on either side.
-    if (leftStackIdx < 0) {
-      leftNeighbors[idx] = idx;
-    } else {
-      leftNeighbors[idx] = idx - leftStack[leftStackIdx] - 1;
-    }
-    if (rightStackIdx < 0) {
-      rightNeighbors[tailIdx] = length - tailIdx - 1;
-    } else {
-      rightNeighbors[tailIdx] = rightStack[rightStackIdx] - tailIdx - 1;
-    }
-    // Add the current index to the stack
-    leftStack[++leftStackIdx] = idx;
-    rightStack[++rightStackIdx] = tailIdx;
-  }
-  // Now we have the number of histogram bars immediately left and right of each bar that are at
-  // least as tall as the given bar. Now we can compute areas easily.
-  for (NSUInteger idx = 0; idx < length; idx++) {
-    CGFloat area = (leftNeighbors[idx] + rightNeighbors[idx] + 1) * histogram[idx];
-    if (area > largestArea) {
-      largestArea = area;
-      largestRect.origin.x = idx - leftNeighbors[idx];
-      largestRect.size.width = leftNeighbors[idx] + rightNeighbors[idx] + 1;
-      largestRect.size.height = histogram[idx];
-    }
-  }
-  free(leftStack);
-  leftStack = NULL;
-  free(rightStack);
-  rightStack = NULL;
-  free(leftNeighbors);
-  leftNeighbors = NULL;
-  free(rightNeighbors);
-  rightNeighbors = NULL;
-  return largestRect;
-}
-
 /**
  *  Calculates the number of pixel in @c afterImage that have different pixel intensity in
  *  @c beforeImage.
@@ -803,58 +793,74 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
   GREYFatalAssertWithMessage(pixelBuffer, @"pixelBuffer must not be null");
   unsigned char *shiftedPixelBuffer = grey_createImagePixelDataFromCGImageRef(afterImage, NULL);
   GREYFatalAssertWithMessage(shiftedPixelBuffer, @"shiftedPixelBuffer must not be null");
-  NSUInteger width = CGImageGetWidth(beforeImage);
-  NSUInteger height = CGImageGetHeight(beforeImage);
-  uint16_t *histograms = NULL;
-  // We only want to perform the relatively expensive rect computation if we've actually
-  // been asked for it.
-  if (outVisiblePixelRect) {
-    histograms = calloc((size_t)(width * height), sizeof(uint16_t));
-  }
+  size_t width = CGImageGetWidth(beforeImage);
+  size_t height = CGImageGetHeight(beforeImage);
+  // All the per-row state lives in a single scratch arena that is reused for every row, so memory
+  // use only grows with the width of the images. The largest rect search stack comes first as it
+  // has the strictest alignment, followed by one row of histogram and, if the comparison result
+  // isn't being stored in a diff buffer, one row of diff.
+  size_t stackSize = outVisiblePixelRect ? GREYLargestRectScratchSize(width) : 0;
+  size_t histogramSize = outVisiblePixelRect ? width * sizeof(uint32_t) : 0;
+  size_t diffRowSize = outDiffBufferOrNULL ? 0 : width;
+  size_t scratchArenaSize = stackSize + histogramSize + diffRowSize;
+  uint8_t *scratchArena = scratchArenaSize > 0 ? malloc(scratchArenaSize) : NULL;
+  GREYFatalAssertWithMessage(scratchArenaSize == 0 || scratchArena,
+                             @"scratchArena must not be null");
+  void *largestRectScratch = scratchArena;
+  uint32_t *histogram = (uint32_t *)(scratchArena + stackSize);
+  uint8_t *scratchDiffRow = scratchArena + stackSize + histogramSize;
+
   GREYVisiblePixelData visiblePixelData = {0, GREYCGPointNull};
+  CGRect largestRect = CGRectZero;
+  uint64_t largestArea = 0;
   // Make sure we go row-order to take advantage of data locality (cuts runtime in half).
-  for (NSUInteger y = 0; y < height; y++) {
-    for (NSUInteger x = 0; x < width; x++) {
-      NSUInteger currentPixelIndex = (y * width + x) * kColorChannelsPerPixel;
-      // We don't care about the first byte because we are dealing with XRGB format.
-      BOOL pixelHasDiff = grey_isPixelDifferent(&pixelBuffer[currentPixelIndex + 1],
-                                                &shiftedPixelBuffer[currentPixelIndex + 1]);
-      if (pixelHasDiff) {
-        visiblePixelData.visiblePixelCount++;
-        // Always pick the bottom and right-most pixel. We may want to consider using tax-cab
-        // formula to find a pixel that's closest to the center if we encounter problems with this
-        // approach.
-        visiblePixelData.visiblePixel.x = x;
-        visiblePixelData.visiblePixel.y = y;
+  for (size_t y = 0; y < height; y++) {
+    size_t rowPixelIndex = y * width * kColorChannelsPerPixel;
+    uint8_t *diffRow = outDiffBufferOrNULL
+        ? (uint8_t *)&outDiffBufferOrNULL->data[y * width]
+        : scratchDiffRow;
+    size_t rowVisiblePixelCount = GREYDiffPixels(&pixelBuffer[rowPixelIndex],
+                                                 &shiftedPixelBuffer[rowPixelIndex],
+                                                 width,
+                                                 diffRow);
+    if (rowVisiblePixelCount > 0) {
+      visiblePixelData.visiblePixelCount += rowVisiblePixelCount;
+      // Always pick the bottom and right-most pixel. We may want to consider using tax-cab
+      // formula to find a pixel that's closest to the center if we encounter problems with this
+      // approach.
+      size_t x = width - 1;
+      while (!diffRow[x]) {
+        x--;
       }
-      if (outVisiblePixelRect) {
-        if (y == 0) {
-          histograms[x] = pixelHasDiff ? 1 : 0;
-        } else {
-          histograms[y * width + x] = pixelHasDiff ? (histograms[(y - 1) * width + x] + 1) : 0;
+      visiblePixelData.visiblePixel.x = x;
+      visiblePixelData.visiblePixel.y = y;
+    }
+    // We only want to perform the relatively expensive rect computation if we've actually
+    // been asked for it. The histogram is updated in place, each row only depends on the one
+    // above it, and the largest rect is tracked as rows are diffed.
+    if (outVisiblePixelRect) {
+      GREYUpdateHistogramRow(histogram, y == 0 ? NULL : histogram, diffRow, width);
+      // A row without visible pixels can't contain a rect.
+      if (rowVisiblePixelCount > 0) {
+        GREYHistogramRect rowRect =
+            GREYLargestRectInHistogram(histogram, width, largestRectScratch);
+        uint64_t rowArea = (uint64_t)rowRect.width * rowRect.height;
+        if (rowArea > largestArea) {
+          largestArea = rowArea;
+          // Because our histograms point up, not down.
+          largestRect = CGRectMake(rowRect.x,
+                                   y + 1 - rowRect.height,
+                                   rowRect.width,
+                                   rowRect.height);
         }
       }
-      if (outDiffBufferOrNULL) {
-        GREYVisibilityDiffBufferSetVisibility(*outDiffBufferOrNULL, x, y, pixelHasDiff);
-      }
     }
   }
   if (outVisiblePixelRect) {
-    CGRect largestRect = CGRectZero;
-    for (NSUInteger idx = 0; idx < height; idx++) {
-      CGRect thisLargest =
-          [GREYVisibilityChecker grey_largestRectInHistogram:&histograms[idx * width]
-                                                      length:(uint16_t)width];
-      if (CGRectArea(thisLargest) > CGRectArea(largestRect)) {
-        // Because our histograms point up, not down.
-        thisLargest.origin.y = idx - thisLargest.size.height + 1;
-        largestRect = thisLargest;
-      }
-    }
     *outVisiblePixelRect = largestRect;
-    free(histograms);
-    histograms = NULL;
   }
+  free(scratchArena);
+  scratchArena = NULL;
   free(pixelBuffer);
   pixelBuffer = NULL;
   free(shiftedPixelBuffer);
@@ -885,21 +891,7 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
   // TODO: Find a good way to compute imagePixelData of before image only once without
   // negatively impacting the readability of code in visibility checker.
   unsigned char *shiftedImagePixels = grey_createImagePixelDataFromCGImageRef(imageRef, NULL);
-
-  for (NSUInteger i = 0; i < height * width; i++) {
-    NSUInteger currentPixelIndex = kColorChannelsPerPixel * i;
-    // We don't care about the [first] byte of the [X]RGB format.
-    for (unsigned char j = 1; j <= 2; j++) {
-      static const unsigned char kShiftIntensityAmount[] = {0, 10, 10, 10}; // Shift for X, R, G, B
-      unsigned char pixelIntensity = shiftedImagePixels[currentPixelIndex + j];
-      if (pixelIntensity >= kShiftIntensityAmount[j]) {
-        pixelIntensity = pixelIntensity - kShiftIntensityAmount[j];
-      } else {
-        pixelIntensity = pixelIntensity + kShiftIntensityAmount[j];
-      }
-      shiftedImagePixels[currentPixelIndex + j] = pixelIntensity;
-    }
-  }
+  GREYShiftPixelIntensities(shiftedImagePixels, height * width);
 
   CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
   CGContextRef bitmapContext =
@@ -930,20 +922,6 @@ inline void GREYVisibilityDiffBufferSetVisibility(GREYVisibilityDiffBuffer buffe
   return shiftedImageView;
 }
 
-/**
- *  @return @c true if the encoded rgb1[R, G, B] color values are different from rbg2[R, G, B]
- *          values, @c false otherwise.
- *  @todo Ideally, we should be testing that pixel colors are shifted by a certain amount instead of
- *        checking if they are simply different. However, the naive check for shifted colors doesn't
- *        work if pixels are overlapped by a translucent mask or have special layer effects applied
- *        to it. Because they are still visible to user and we want to avoid false-negatives that
- *        would cause the test to fail, we resort to a naive check that rbg1 and rgb2 are not the
- *        same without specifying the exact delta between them.
- */
-static inline bool grey_isPixelDifferent(unsigned char rgb1[], unsigned char rgb2[]) {
-  return abs(rgb1[0] - rgb2[0]) > 2 || abs(rgb1[1] - rgb2[1]) > 2 || abs(rgb1[2] - rgb2[2]) > 2;
-}
-
 #pragma mark - Package Internal
 
 + (UIImage *)grey_lastActualBeforeImage {
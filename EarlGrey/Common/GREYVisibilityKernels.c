@@ -0,0 +1,343 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "Common/GREYVisibilityKernels.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GREY_VISIBILITY_KERNELS_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GREY_VISIBILITY_KERNELS_SSE2 1
+#endif
+
+/**
+ *  Bytes per XRGB pixel.
+ */
+static const size_t kBytesPerPixel = 4;
+
+#pragma mark - Scalar
+
+/**
+ *  @return The shifted value of a single channel intensity.
+ */
+static inline uint8_t grey_shiftedIntensity(uint8_t intensity) {
+  if (intensity >= GREY_VISIBILITY_SHIFT_INTENSITY_AMOUNT) {
+    return (uint8_t)(intensity - GREY_VISIBILITY_SHIFT_INTENSITY_AMOUNT);
+  }
+  return (uint8_t)(intensity + GREY_VISIBILITY_SHIFT_INTENSITY_AMOUNT);
+}
+
+/**
+ *  @return @c 1 if the R, G, B channels of the XRGB pixels @c pixel1 and @c pixel2 differ by more
+ *          than the allowed tolerance, @c 0 otherwise.
+ *  @todo Ideally, we should be testing that pixel colors are shifted by a certain amount instead of
+ *        checking if they are simply different. However, the naive check for shifted colors doesn't
+ *        work if pixels are overlapped by a translucent mask or have special layer effects applied
+ *        to it. Because they are still visible to user and we want to avoid false-negatives that
+ *        would cause the test to fail, we resort to a naive check that the pixels are not the same
+ *        without specifying the exact delta between them.
+ */
+static inline uint8_t grey_isPixelDifferent(const uint8_t *pixel1, const uint8_t *pixel2) {
+  for (size_t channel = 1; channel < kBytesPerPixel; channel++) {
+    int delta = (int)pixel1[channel] - (int)pixel2[channel];
+    if (delta > GREY_VISIBILITY_CHANNEL_DIFF_TOLERANCE ||
+        delta < -GREY_VISIBILITY_CHANNEL_DIFF_TOLERANCE) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void GREYShiftPixelIntensitiesScalar(uint8_t *xrgbPixels, size_t pixelCount) {
+  for (size_t i = 0; i < pixelCount; i++) {
+    uint8_t *pixel = &xrgbPixels[i * kBytesPerPixel];
+    // Only the R and G channels are shifted.
+    pixel[1] = grey_shiftedIntensity(pixel[1]);
+    pixel[2] = grey_shiftedIntensity(pixel[2]);
+  }
+}
+
+size_t GREYDiffPixelsScalar(const uint8_t *beforePixels,
+                            const uint8_t *afterPixels,
+                            size_t pixelCount,
+                            uint8_t *outDiff) {
+  size_t count = 0;
+  for (size_t i = 0; i < pixelCount; i++) {
+    uint8_t isDifferent = grey_isPixelDifferent(&beforePixels[i * kBytesPerPixel],
+                                                &afterPixels[i * kBytesPerPixel]);
+    outDiff[i] = isDifferent;
+    count += isDifferent;
+  }
+  return count;
+}
+
+void GREYUpdateHistogramRowScalar(uint32_t *histogramRow,
+                                  const uint32_t *previousRowOrNULL,
+                                  const uint8_t *diffRow,
+                                  size_t width) {
+  for (size_t x = 0; x < width; x++) {
+    uint32_t previous = previousRowOrNULL ? previousRowOrNULL[x] : 0;
+    histogramRow[x] = diffRow[x] ? previous + 1 : 0;
+  }
+}
+
+#pragma mark - Largest Rectangle
+
+/**
+ *  An entry of the stack of bars used by GREYLargestRectInHistogram.
+ */
+typedef struct GREYHistogramStackEntry {
+  /** The leftmost index that the bar's rectangle extends to. */
+  size_t start;
+  /** The leftmost index of a bar with the same height and rectangle, used to break ties. */
+  size_t key;
+  /** The height of the bar. */
+  uint32_t height;
+} GREYHistogramStackEntry;
+
+size_t GREYLargestRectScratchSize(size_t length) {
+  return (length + 1) * sizeof(GREYHistogramStackEntry);
+}
+
+GREYHistogramRect GREYLargestRectInHistogram(const uint32_t *histogram,
+                                             size_t length,
+                                             void *scratch) {
+  GREYHistogramStackEntry *stack = (GREYHistogramStackEntry *)scratch;
+  size_t stackCount = 0;
+  GREYHistogramRect largestRect = {0, 0, 0};
+  uint64_t largestArea = 0;
+  size_t largestKey = SIZE_MAX;
+  // The stack holds bars of strictly increasing height. A bar is popped when a bar that is not
+  // taller than it is found, at which point its rectangle can't extend any further right. The
+  // extra iteration at the end uses a zero height bar to flush the stack.
+  for (size_t idx = 0; idx <= length; idx++) {
+    uint32_t height = (idx < length) ? histogram[idx] : 0;
+    size_t start = idx;
+    size_t key = idx;
+    while (stackCount > 0 && stack[stackCount - 1].height >= height) {
+      GREYHistogramStackEntry top = stack[--stackCount];
+      uint64_t area = (uint64_t)top.height * (idx - top.start);
+      if (area > largestArea || (area > 0 && area == largestArea && top.key < largestKey)) {
+        largestArea = area;
+        largestKey = top.key;
+        largestRect.x = top.start;
+        largestRect.width = idx - top.start;
+        largestRect.height = top.height;
+      }
+      // The current bar's rectangle extends at least as far left as every bar it pops, and bars
+      // of equal height describe the same rectangle so the leftmost one is kept for ties.
+      start = top.start;
+      if (top.height == height) {
+        key = top.key;
+      }
+    }
+    if (idx < length) {
+      stack[stackCount++] = (GREYHistogramStackEntry){start, key, height};
+    }
+  }
+  return largestRect;
+}
+
+#pragma mark - Vectorized
+
+#if GREY_VISIBILITY_KERNELS_NEON
+
+void GREYShiftPixelIntensities(uint8_t *xrgbPixels, size_t pixelCount) {
+  const uint8x16_t shift = vdupq_n_u8(GREY_VISIBILITY_SHIFT_INTENSITY_AMOUNT);
+  size_t i = 0;
+  for (; i + 16 <= pixelCount; i += 16) {
+    uint8_t *pixels = &xrgbPixels[i * kBytesPerPixel];
+    // De-interleaves 16 pixels into one vector per channel.
+    uint8x16x4_t channels = vld4q_u8(pixels);
+    for (int channel = 1; channel <= 2; channel++) {
+      uint8x16_t value = channels.val[channel];
+      uint8x16_t isAtLeastShift = vcgeq_u8(value, shift);
+      channels.val[channel] =
+          vbslq_u8(isAtLeastShift, vsubq_u8(value, shift), vaddq_u8(value, shift));
+    }
+    vst4q_u8(pixels, channels);
+  }
+  GREYShiftPixelIntensitiesScalar(&xrgbPixels[i * kBytesPerPixel], pixelCount - i);
+}
+
+size_t GREYDiffPixels(const uint8_t *beforePixels,
+                      const uint8_t *afterPixels,
+                      size_t pixelCount,
+                      uint8_t *outDiff) {
+  const uint8x16_t tolerance = vdupq_n_u8(GREY_VISIBILITY_CHANNEL_DIFF_TOLERANCE);
+  const uint8x16_t one = vdupq_n_u8(1);
+  size_t count = 0;
+  size_t i = 0;
+  for (; i + 16 <= pixelCount; i += 16) {
+    uint8x16x4_t before = vld4q_u8(&beforePixels[i * kBytesPerPixel]);
+    uint8x16x4_t after = vld4q_u8(&afterPixels[i * kBytesPerPixel]);
+    uint8x16_t isDifferent = vcgtq_u8(vabdq_u8(before.val[1], after.val[1]), tolerance);
+    isDifferent = vorrq_u8(isDifferent,
+                           vcgtq_u8(vabdq_u8(before.val[2], after.val[2]), tolerance));
+    isDifferent = vorrq_u8(isDifferent,
+                           vcgtq_u8(vabdq_u8(before.val[3], after.val[3]), tolerance));
+    uint8x16_t diff = vandq_u8(isDifferent, one);
+    vst1q_u8(&outDiff[i], diff);
+#if defined(__aarch64__)
+    count += vaddvq_u8(diff);
+#else
+    uint64x2_t sum = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(diff)));
+    count += (size_t)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+#endif
+  }
+  return count + GREYDiffPixelsScalar(&beforePixels[i * kBytesPerPixel],
+                                      &afterPixels[i * kBytesPerPixel],
+                                      pixelCount - i,
+                                      &outDiff[i]);
+}
+
+void GREYUpdateHistogramRow(uint32_t *histogramRow,
+                            const uint32_t *previousRowOrNULL,
+                            const uint8_t *diffRow,
+                            size_t width) {
+  const uint32x4_t one = vdupq_n_u32(1);
+  const uint32x4_t zero = vdupq_n_u32(0);
+  size_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    uint16x8_t diff = vmovl_u8(vld1_u8(&diffRow[x]));
+    uint32x4_t diffLow = vmovl_u16(vget_low_u16(diff));
+    uint32x4_t diffHigh = vmovl_u16(vget_high_u16(diff));
+    uint32x4_t previousLow = previousRowOrNULL ? vld1q_u32(&previousRowOrNULL[x]) : zero;
+    uint32x4_t previousHigh = previousRowOrNULL ? vld1q_u32(&previousRowOrNULL[x + 4]) : zero;
+    vst1q_u32(&histogramRow[x],
+              vbicq_u32(vaddq_u32(previousLow, one), vceqq_u32(diffLow, zero)));
+    vst1q_u32(&histogramRow[x + 4],
+              vbicq_u32(vaddq_u32(previousHigh, one), vceqq_u32(diffHigh, zero)));
+  }
+  GREYUpdateHistogramRowScalar(&histogramRow[x],
+                               previousRowOrNULL ? &previousRowOrNULL[x] : NULL,
+                               &diffRow[x],
+                               width - x);
+}
+
+#elif GREY_VISIBILITY_KERNELS_SSE2
+
+void GREYShiftPixelIntensities(uint8_t *xrgbPixels, size_t pixelCount) {
+  const __m128i shift = _mm_set1_epi8(GREY_VISIBILITY_SHIFT_INTENSITY_AMOUNT);
+  // Selects the R and G bytes of each little-endian 32 bit XRGB pixel.
+  const __m128i channelMask = _mm_set1_epi32(0x00FFFF00);
+  size_t i = 0;
+  for (; i + 4 <= pixelCount; i += 4) {
+    __m128i *pixels = (__m128i *)&xrgbPixels[i * kBytesPerPixel];
+    __m128i value = _mm_loadu_si128(pixels);
+    __m128i isAtLeastShift = _mm_cmpeq_epi8(_mm_max_epu8(value, shift), value);
+    __m128i shifted = _mm_or_si128(_mm_and_si128(isAtLeastShift, _mm_sub_epi8(value, shift)),
+                                   _mm_andnot_si128(isAtLeastShift, _mm_add_epi8(value, shift)));
+    value = _mm_or_si128(_mm_and_si128(channelMask, shifted),
+                         _mm_andnot_si128(channelMask, value));
+    _mm_storeu_si128(pixels, value);
+  }
+  GREYShiftPixelIntensitiesScalar(&xrgbPixels[i * kBytesPerPixel], pixelCount - i);
+}
+
+/**
+ *  @return A vector with all bits of a 32 bit lane set if the corresponding XRGB pixels in
+ *          @c beforePixels and @c afterPixels are the same, cleared otherwise.
+ */
+static inline __m128i grey_samePixelsMask(const uint8_t *beforePixels,
+                                          const uint8_t *afterPixels) {
+  const __m128i tolerance = _mm_set1_epi8(GREY_VISIBILITY_CHANNEL_DIFF_TOLERANCE);
+  // Selects the R, G and B bytes of each little-endian 32 bit XRGB pixel.
+  const __m128i channelMask = _mm_set1_epi32((int)0xFFFFFF00);
+  __m128i before = _mm_loadu_si128((const __m128i *)beforePixels);
+  __m128i after = _mm_loadu_si128((const __m128i *)afterPixels);
+  __m128i absDiff = _mm_or_si128(_mm_subs_epu8(before, after), _mm_subs_epu8(after, before));
+  // Non-zero only where the difference exceeds the tolerance.
+  __m128i excess = _mm_and_si128(_mm_subs_epu8(absDiff, tolerance), channelMask);
+  return _mm_cmpeq_epi32(excess, _mm_setzero_si128());
+}
+
+size_t GREYDiffPixels(const uint8_t *beforePixels,
+                      const uint8_t *afterPixels,
+                      size_t pixelCount,
+                      uint8_t *outDiff) {
+  const __m128i one = _mm_set1_epi8(1);
+  size_t count = 0;
+  size_t i = 0;
+  for (; i + 16 <= pixelCount; i += 16) {
+    const uint8_t *before = &beforePixels[i * kBytesPerPixel];
+    const uint8_t *after = &afterPixels[i * kBytesPerPixel];
+    __m128i same0 = grey_samePixelsMask(before, after);
+    __m128i same1 = grey_samePixelsMask(before + 16, after + 16);
+    __m128i same2 = grey_samePixelsMask(before + 32, after + 32);
+    __m128i same3 = grey_samePixelsMask(before + 48, after + 48);
+    // Narrow the 32 bit lane masks to one byte per pixel.
+    __m128i same = _mm_packs_epi16(_mm_packs_epi32(same0, same1), _mm_packs_epi32(same2, same3));
+    _mm_storeu_si128((__m128i *)&outDiff[i], _mm_andnot_si128(same, one));
+    count += (size_t)(16 - __builtin_popcount((unsigned)_mm_movemask_epi8(same)));
+  }
+  return count + GREYDiffPixelsScalar(&beforePixels[i * kBytesPerPixel],
+                                      &afterPixels[i * kBytesPerPixel],
+                                      pixelCount - i,
+                                      &outDiff[i]);
+}
+
+void GREYUpdateHistogramRow(uint32_t *histogramRow,
+                            const uint32_t *previousRowOrNULL,
+                            const uint8_t *diffRow,
+                            size_t width) {
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i zero = _mm_setzero_si128();
+  size_t x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i diff = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)&diffRow[x]), zero);
+    // All bits set for visible pixels, 0 otherwise.
+    __m128i isVisibleLow = _mm_sub_epi32(zero, _mm_unpacklo_epi16(diff, zero));
+    __m128i isVisibleHigh = _mm_sub_epi32(zero, _mm_unpackhi_epi16(diff, zero));
+    __m128i previousLow = zero;
+    __m128i previousHigh = zero;
+    if (previousRowOrNULL) {
+      previousLow = _mm_loadu_si128((const __m128i *)&previousRowOrNULL[x]);
+      previousHigh = _mm_loadu_si128((const __m128i *)&previousRowOrNULL[x + 4]);
+    }
+    _mm_storeu_si128((__m128i *)&histogramRow[x],
+                     _mm_and_si128(_mm_add_epi32(previousLow, one), isVisibleLow));
+    _mm_storeu_si128((__m128i *)&histogramRow[x + 4],
+                     _mm_and_si128(_mm_add_epi32(previousHigh, one), isVisibleHigh));
+  }
+  GREYUpdateHistogramRowScalar(&histogramRow[x],
+                               previousRowOrNULL ? &previousRowOrNULL[x] : NULL,
+                               &diffRow[x],
+                               width - x);
+}
+
+#else
+
+void GREYShiftPixelIntensities(uint8_t *xrgbPixels, size_t pixelCount) {
+  GREYShiftPixelIntensitiesScalar(xrgbPixels, pixelCount);
+}
+
+size_t GREYDiffPixels(const uint8_t *beforePixels,
+                      const uint8_t *afterPixels,
+                      size_t pixelCount,
+                      uint8_t *outDiff) {
+  return GREYDiffPixelsScalar(beforePixels, afterPixels, pixelCount, outDiff);
+}
+
+void GREYUpdateHistogramRow(uint32_t *histogramRow,
+                            const uint32_t *previousRowOrNULL,
+                            const uint8_t *diffRow,
+                            size_t width) {
+  GREYUpdateHistogramRowScalar(histogramRow, previousRowOrNULL, diffRow, width);
+}
+
+#endif
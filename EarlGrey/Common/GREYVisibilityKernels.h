@@ -0,0 +1,150 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/**
+ *  @file GREYVisibilityKernels.h
+ *  @brief Pixel processing kernels used by the visibility checker. The kernels operate on XRGB
+ *  buffers (4 bytes per pixel, the first byte being ignored) and are vectorized with NEON on ARM
+ *  and SSE2 on x86. Every kernel has a scalar counterpart that produces identical results and is
+ *  used for the tail of the buffer as well as on other architectures.
+ *
+ *  This header is plain C so that the kernels can be built and benchmarked outside of the
+ *  framework.
+ */
+
+#ifndef GREY_VISIBILITY_KERNELS_H
+#define GREY_VISIBILITY_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  The amount by which the R and G channels are shifted by GREYShiftPixelIntensities.
+ */
+#define GREY_VISIBILITY_SHIFT_INTENSITY_AMOUNT 10
+
+/**
+ *  The maximum difference between two channel values that is still considered the same color by
+ *  GREYDiffPixels.
+ */
+#define GREY_VISIBILITY_CHANNEL_DIFF_TOLERANCE 2
+
+/**
+ *  Shifts the R and G channels of every pixel in @c xrgbPixels in place. Channel values that are at
+ *  least GREY_VISIBILITY_SHIFT_INTENSITY_AMOUNT are decreased by that amount, smaller values are
+ *  increased by it. The X and B channels are left untouched.
+ *
+ *  @param xrgbPixels The XRGB pixels to shift.
+ *  @param pixelCount The number of pixels (not bytes) in @c xrgbPixels.
+ */
+void GREYShiftPixelIntensities(uint8_t *xrgbPixels, size_t pixelCount);
+
+/**
+ *  Compares @c pixelCount XRGB pixels of @c beforePixels and @c afterPixels. A pixel is different
+ *  if any of its R, G or B channels differ by more than GREY_VISIBILITY_CHANNEL_DIFF_TOLERANCE.
+ *
+ *  @param      beforePixels The XRGB pixels of the original image.
+ *  @param      afterPixels  The XRGB pixels of the color shifted image.
+ *  @param      pixelCount   The number of pixels to compare.
+ *  @param[out] outDiff      A buffer of at least @c pixelCount bytes that receives @c 1 for every
+ *                           pixel that is different and @c 0 otherwise.
+ *
+ *  @return The number of pixels that are different.
+ */
+size_t GREYDiffPixels(const uint8_t *beforePixels,
+                      const uint8_t *afterPixels,
+                      size_t pixelCount,
+                      uint8_t *outDiff);
+
+/**
+ *  Updates one row of a histogram of contiguous visible pixels: each value is the value in
+ *  @c previousRowOrNULL plus one if the corresponding pixel in @c diffRow is visible, zero
+ *  otherwise. @c histogramRow and @c previousRowOrNULL may point to the same buffer.
+ *
+ *  @param[out] histogramRow      The histogram row to update.
+ *  @param      previousRowOrNULL The histogram row above this one or @c NULL for the first row.
+ *  @param      diffRow           The diff row as produced by GREYDiffPixels.
+ *  @param      width             The number of values in the row.
+ */
+void GREYUpdateHistogramRow(uint32_t *histogramRow,
+                            const uint32_t *previousRowOrNULL,
+                            const uint8_t *diffRow,
+                            size_t width);
+
+/**
+ *  A rectangle found in a histogram, with its origin at the bottom of the histogram.
+ */
+typedef struct GREYHistogramRect {
+  /** The index of the leftmost bar of the rectangle. */
+  size_t x;
+  /** The number of bars the rectangle spans. */
+  size_t width;
+  /** The height of the rectangle. */
+  uint32_t height;
+} GREYHistogramRect;
+
+/**
+ *  @return The size in bytes of the scratch buffer needed by GREYLargestRectInHistogram for a
+ *          histogram of @c length values.
+ */
+size_t GREYLargestRectScratchSize(size_t length);
+
+/**
+ *  Finds the largest rectangle in a histogram in a single pass. If several rectangles have the
+ *  largest area, the one containing the leftmost bar that is exactly as tall as its rectangle is
+ *  returned. A histogram with no bars returns a rectangle with zero width and height.
+ *
+ *  @param histogram The values of the histogram (the heights of the bars).
+ *  @param length    The number of values in the histogram.
+ *  @param scratch   A buffer of at least GREYLargestRectScratchSize(length) bytes. It can be reused
+ *                   across calls to avoid allocating for every histogram.
+ *
+ *  @return The largest rectangle in the histogram.
+ */
+GREYHistogramRect GREYLargestRectInHistogram(const uint32_t *histogram,
+                                             size_t length,
+                                             void *scratch);
+
+/**
+ *  Scalar implementation of GREYShiftPixelIntensities.
+ */
+void GREYShiftPixelIntensitiesScalar(uint8_t *xrgbPixels, size_t pixelCount);
+
+/**
+ *  Scalar implementation of GREYDiffPixels.
+ */
+size_t GREYDiffPixelsScalar(const uint8_t *beforePixels,
+                            const uint8_t *afterPixels,
+                            size_t pixelCount,
+                            uint8_t *outDiff);
+
+/**
+ *  Scalar implementation of GREYUpdateHistogramRow.
+ */
+void GREYUpdateHistogramRowScalar(uint32_t *histogramRow,
+                                  const uint32_t *previousRowOrNULL,
+                                  const uint8_t *diffRow,
+                                  size_t width);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // GREY_VISIBILITY_KERNELS_H
@@ -31,6 +31,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, readonly) id<GREYMatcher> matcher;
 
+/**
+ *  The number of subtrees that were skipped by the last call to
+ *  GREYElementFinder::elementsMatchedInProvider: because their root view is hidden, transparent or
+ *  clips its subviews to bounds that lie outside the screen. Subtrees are only skipped when
+ *  @c kGREYConfigKeyInvisibleSubtreePruningEnabled is set to @c YES and the matcher only accepts
+ *  visible elements.
+ */
+@property(nonatomic, readonly) NSUInteger prunedSubtreeCount;
+
 /**
  *  @remark init is not an available initializer. Use the other initializers.
  */
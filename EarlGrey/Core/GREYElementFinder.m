@@ -16,9 +16,18 @@
 
 #import "Core/GREYElementFinder.h"
 
+#import <UIKit/UIKit.h>
+
+#import "Common/GREYConfiguration.h"
+#import "Common/GREYConstants.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYThrowDefines.h"
+#import "Common/GREYTracer.h"
+#import "Core/GREYElementIndex.h"
+#import "Matcher/GREYHierarchyMatchCache.h"
 #import "Matcher/GREYMatcher.h"
+#import "Matcher/GREYMatcherCost.h"
+#import "Provider/GREYElementProvider.h"
 #import "Provider/GREYProvider.h"
 
 @implementation GREYElementFinder
@@ -37,15 +46,172 @@
   GREYThrowOnNilParameter(elementProvider);
   GREYFatalAssertMainThread();
 
+  // Hierarchy walking matchers share their results across all the elements of a search.
+  __block NSArray *matchingElements;
+  [GREYHierarchyMatchCache performBlockWithNewCache:^{
+    matchingElements = [self grey_elementsMatchedInProvider:elementProvider];
+  }];
+  return matchingElements;
+}
+
+#pragma mark - Private
+
+/**
+ *  Performs the search of GREYElementFinder::elementsMatchedInProvider:.
+ *
+ *  @param elementProvider Provides elements to run through the matcher.
+ *
+ *  @return An array of matched elements.
+ */
+- (NSArray *)grey_elementsMatchedInProvider:(id<GREYProvider>)elementProvider {
+  _prunedSubtreeCount = 0;
+  NSArray *indexedElements = [self grey_elementsMatchedInIndexForProvider:elementProvider];
+  // Several matches must be returned in traversal order along with the ones the index might miss,
+  // which only the full search can provide. The index can also miss elements that share the
+  // identifier of a single match, e.g. through an overridden getter, so that has to be confirmed.
+  if (indexedElements.count == 1 &&
+      [self grey_isOnlyElementWithRequiredAccessibilityID:indexedElements[0]
+                                               inProvider:elementProvider]) {
+    return indexedElements;
+  }
+
+  NSEnumerator *enumerator;
+  __block NSUInteger prunedSubtreeCount = 0;
+  if ([elementProvider isKindOfClass:[GREYElementProvider class]] &&
+      GREYMatcherRequiresVisibility(_matcher) &&
+      GREY_CONFIG_BOOL(kGREYConfigKeyInvisibleSubtreePruningEnabled)) {
+    GREYElementProvider *provider = (GREYElementProvider *)elementProvider;
+    enumerator = [provider dataEnumeratorSkippingDescendantsPassingTest:^BOOL(id element) {
+      if ([GREYElementFinder grey_isSubtreeOfElementInvisible:element]) {
+        prunedSubtreeCount++;
+        return YES;
+      }
+      return NO;
+    }];
+  } else {
+    enumerator = [elementProvider dataEnumerator];
+  }
+
+  NSArray *matchingElements = [self grey_elementsMatchedInEnumerator:enumerator];
+  _prunedSubtreeCount = prunedSubtreeCount;
+  return matchingElements;
+}
+
+/**
+ *  Runs the elements of @c enumerator through the matcher, recording a single span for all of
+ *  them.
+ *
+ *  @param enumerator Enumerates the elements to run through the matcher.
+ *
+ *  @return An array of the matched elements, in the order of @c enumerator and without duplicates.
+ */
+- (NSArray *)grey_elementsMatchedInEnumerator:(NSEnumerator *)enumerator {
   NSMutableOrderedSet *matchingElements = [[NSMutableOrderedSet alloc] init];
+  NSUInteger evaluatedElementCount = 0;
+  GREYTraceSpan matcherSpan = GREYTraceBegin(kGREYTraceSpanMatcherEvaluation);
+  @try {
+    for (id element in enumerator) {
+      @autoreleasepool {
+        evaluatedElementCount++;
+        if ([_matcher matches:element]) {
+          [matchingElements addObject:element];
+        }
+      }
+    }
+  } @finally {
+    GREYTraceEndWithArguments(&matcherSpan, @{ @"evaluatedElements" : @(evaluatedElementCount) });
+  }
+  return [matchingElements array];
+}
+
+/**
+ *  @return @c YES if @c element is a view whose descendants can't be visible on screen, which is
+ *          the case if it is hidden or transparent, or if it clips its subviews to bounds that lie
+ *          entirely outside the screen. @c NO otherwise.
+ */
++ (BOOL)grey_isSubtreeOfElementInvisible:(id)element {
+  if (![element isKindOfClass:[UIView class]]) {
+    return NO;
+  }
+  UIView *view = element;
+  if (view.hidden || view.alpha < kGREYMinimumVisibleAlpha) {
+    return YES;
+  }
+  // Views that aren't in a window aren't rendered on screen, but they can still be matched against
+  // when they are provided as root elements, so only views in a window are considered off-screen.
+  UIWindow *window = view.window;
+  if (view.clipsToBounds && window) {
+    CGRect boundsInWindow = [view convertRect:view.bounds toView:nil];
+    CGRect boundsOnScreen = [window convertRect:boundsInWindow toWindow:nil];
+    return !CGRectIntersectsRect(boundsOnScreen, [[UIScreen mainScreen] bounds]);
+  }
+  return NO;
+}
+
+/**
+ *  Looks up the elements that are accepted by the matcher in the element index, if it is enabled
+ *  and the matcher requires an accessibility identifier.
+ *
+ *  @param elementProvider Provides elements to run through the matcher.
+ *
+ *  @return An array of matched elements, or @c nil if the index can't be used, which is also the
+ *          case if elements that aren't indexed have been seen with the required accessibility
+ *          identifier. Unless it holds exactly one element that no other element shares the
+ *          accessibility identifier with, the elements must be searched for in the entire hierarchy
+ *          as the index might be stale and isn't in traversal order.
+ */
+- (NSArray *)grey_elementsMatchedInIndexForProvider:(id<GREYProvider>)elementProvider {
+  if (![elementProvider isKindOfClass:[GREYElementProvider class]]) {
+    return nil;
+  }
+  NSString *accessibilityID = [GREYElementIndex accessibilityIDRequiredByMatcher:_matcher];
+  if (!accessibilityID) {
+    return nil;
+  }
+  GREYElementIndex *index = [GREYElementIndex sharedInstance];
+  if (!GREY_CONFIG_BOOL(kGREYConfigKeyElementIndexEnabled)) {
+    if ([index isActive]) {
+      [index deactivate];
+    }
+    return nil;
+  }
+
+  GREYElementProvider *provider = (GREYElementProvider *)elementProvider;
+  NSArray *rootElements = [[provider rootElementEnumerator] allObjects];
+  NSArray *indexedViews = [index viewsWithAccessibilityID:accessibilityID
+                              inHierarchiesOfRootElements:rootElements];
+  if ([index hasUnindexedElementsWithAccessibilityID:accessibilityID]) {
+    return nil;
+  }
+  return [self grey_elementsMatchedInEnumerator:[indexedViews objectEnumerator]];
+}
+
+/**
+ *  Traverses the elements of @c elementProvider to confirm a single match found in the element
+ *  index. Only accessibility identifiers are compared, which is much cheaper than evaluating the
+ *  complete matcher on every element.
+ *
+ *  @param indexedElement  The single element matched in the element index.
+ *  @param elementProvider Provides the elements that were searched.
+ *
+ *  @return @c YES if @c indexedElement is provided by @c elementProvider and no other element it
+ *          provides has the accessibility identifier required by the matcher, @c NO otherwise.
+ */
+- (BOOL)grey_isOnlyElementWithRequiredAccessibilityID:(id)indexedElement
+                                           inProvider:(id<GREYProvider>)elementProvider {
+  NSString *accessibilityID = [GREYElementIndex accessibilityIDRequiredByMatcher:_matcher];
+  BOOL providesIndexedElement = NO;
   for (id element in [elementProvider dataEnumerator]) {
     @autoreleasepool {
-      if ([_matcher matches:element]) {
-        [matchingElements addObject:element];
+      if (element == indexedElement) {
+        providesIndexedElement = YES;
+      } else if ([element respondsToSelector:@selector(accessibilityIdentifier)] &&
+                 [[element accessibilityIdentifier] isEqual:accessibilityID]) {
+        return NO;
       }
     }
   }
-  return [matchingElements array];
+  return providesIndexedElement;
 }
 
 @end
@@ -0,0 +1,123 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import <UIKit/UIKit.h>
+
+@protocol GREYMatcher;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  An index from accessibility identifiers to the views that have them, used to look up elements
+ *  matched by GREYMatchers::matcherForAccessibilityID: without traversing the entire UI hierarchy.
+ *  The index only holds weak references to the views.
+ *
+ *  The index is inactive until it is first queried, at which point the hierarchies being searched
+ *  are indexed. From then on, it is maintained incrementally by the UIView swizzles that add
+ *  subviews and set accessibility identifiers. Views whose accessibility identifier changes without
+ *  going through UIView::setAccessibilityIdentifier: can be missing from the index, which is why
+ *  every element it returns is verified and callers must fall back to a full search unless exactly
+ *  one element is found. Elements that aren't views, like accessibility elements, are never
+ *  indexed, but the identifiers they are seen with are recorded so that callers can tell when a
+ *  full search is needed to find them.
+ *
+ *  @remark The index is only used when @c kGREYConfigKeyElementIndexEnabled is set to @c YES.
+ */
+@interface GREYElementIndex : NSObject
+
+/**
+ *  @return The singleton instance.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ *  @remark init is not an available initializer. Use the singleton instance.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ *  @c YES if the index is being maintained, @c NO otherwise.
+ */
+@property(nonatomic, readonly, getter=isActive) BOOL active;
+
+/**
+ *  Adds @c view and all of its subviews to the index if the index is active.
+ *
+ *  @param view The view that was added to a view hierarchy.
+ */
+- (void)indexViewHierarchy:(UIView *)view;
+
+/**
+ *  Adds @c view to the index under its current accessibility identifier if the index is active.
+ *
+ *  @param view The view whose accessibility identifier was changed.
+ */
+- (void)indexView:(UIView *)view;
+
+/**
+ *  Activates the index if needed and returns the indexed views in the hierarchies of
+ *  @c rootElements that currently have the accessibility identifier @c accessibilityID.
+ *
+ *  @param accessibilityID The accessibility identifier to look up.
+ *  @param rootElements    The root elements of the hierarchies to look up the views in.
+ *
+ *  @return The views found in the index. It can miss views whose accessibility identifier was
+ *          changed without the index being notified.
+ */
+- (NSArray *)viewsWithAccessibilityID:(NSString *)accessibilityID
+          inHierarchiesOfRootElements:(NSArray *)rootElements;
+
+/**
+ *  Records that an element that isn't a view, and therefore isn't indexed, has the accessibility
+ *  identifier @c accessibilityID.
+ *
+ *  @param accessibilityID The accessibility identifier of the element.
+ */
+- (void)recordAccessibilityIDOfUnindexedElement:(NSString *)accessibilityID;
+
+/**
+ *  @param accessibilityID The accessibility identifier to look up.
+ *
+ *  @return @c YES if an element that isn't indexed has ever been seen with the accessibility
+ *          identifier @c accessibilityID, in which case elements that have it can only be found by
+ *          searching the entire hierarchy. @c NO otherwise.
+ */
+- (BOOL)hasUnindexedElementsWithAccessibilityID:(NSString *)accessibilityID;
+
+/**
+ *  Stops maintaining the index and discards its content.
+ */
+- (void)deactivate;
+
+/**
+ *  Marks @c matcher as only matching elements with the accessibility identifier
+ *  @c accessibilityID, which allows elements matched by it to be looked up in the index.
+ *
+ *  @param accessibilityID The accessibility identifier required by @c matcher.
+ *  @param matcher         The matcher to be marked.
+ */
++ (void)setAccessibilityID:(NSString *)accessibilityID
+         requiredByMatcher:(id<GREYMatcher>)matcher;
+
+/**
+ *  @return The accessibility identifier that an element must have to be matched by @c matcher, or
+ *          @c nil if the matcher doesn't require one.
+ */
++ (NSString *_Nullable)accessibilityIDRequiredByMatcher:(id<GREYMatcher>)matcher;
+
+@end
+
+NS_ASSUME_NONNULL_END
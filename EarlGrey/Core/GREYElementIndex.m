@@ -0,0 +1,206 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import "Core/GREYElementIndex.h"
+
+#include <objc/runtime.h>
+
+#import "Common/GREYFatalAsserts.h"
+#import "Common/GREYThrowDefines.h"
+#import "Matcher/GREYMatcher.h"
+#import "Traversal/GREYTraversalBFS.h"
+
+@implementation GREYElementIndex {
+  /**
+   *  A map from accessibility identifiers to weak hash tables of the views that had them when they
+   *  were indexed.
+   */
+  NSMutableDictionary<NSString *, NSHashTable<UIView *> *> *_viewsByAccessibilityID;
+
+  /**
+   *  The root elements whose hierarchies have been indexed.
+   */
+  NSHashTable *_indexedRootElements;
+
+  /**
+   *  The accessibility identifiers that elements that aren't indexed have been seen with. It is
+   *  kept when the index is deactivated, as these elements can be long lived.
+   */
+  NSMutableSet<NSString *> *_accessibilityIDsOfUnindexedElements;
+}
+
++ (instancetype)sharedInstance {
+  static GREYElementIndex *instance = nil;
+  static dispatch_once_t token = 0;
+  dispatch_once(&token, ^{
+    instance = [[GREYElementIndex alloc] initOnce];
+  });
+  return instance;
+}
+
+/**
+ *  Initializes the singleton instance.
+ */
+- (instancetype)initOnce {
+  self = [super init];
+  if (self) {
+    _viewsByAccessibilityID = [[NSMutableDictionary alloc] init];
+    _indexedRootElements = [NSHashTable weakObjectsHashTable];
+    _accessibilityIDsOfUnindexedElements = [[NSMutableSet alloc] init];
+  }
+  return self;
+}
+
+- (void)indexViewHierarchy:(UIView *)view {
+  if (!_active || ![self grey_isSafeToUpdate]) {
+    return;
+  }
+  [self grey_addView:view];
+  for (UIView *subview in view.subviews) {
+    [self indexViewHierarchy:subview];
+  }
+}
+
+- (void)indexView:(UIView *)view {
+  if (!_active || ![self grey_isSafeToUpdate]) {
+    return;
+  }
+  [self grey_addView:view];
+}
+
+- (NSArray *)viewsWithAccessibilityID:(NSString *)accessibilityID
+          inHierarchiesOfRootElements:(NSArray *)rootElements {
+  GREYThrowOnNilParameter(accessibilityID);
+  GREYThrowOnNilParameter(rootElements);
+  GREYFatalAssertMainThread();
+
+  if (!_active) {
+    // Start from scratch, as changes might have been missed while the index was inactive.
+    [self deactivate];
+    _active = YES;
+  }
+  // Index the hierarchies that haven't been seen yet. Subsequent changes to them are picked up by
+  // the swizzles.
+  for (id rootElement in rootElements) {
+    if (![_indexedRootElements containsObject:rootElement]) {
+      [_indexedRootElements addObject:rootElement];
+      GREYTraversalBFS *traversal =
+          [GREYTraversalBFS hierarchyForElementWithBFSTraversal:rootElement];
+      for (id element in traversal) {
+        if ([element isKindOfClass:[UIView class]]) {
+          [self grey_addView:element];
+        } else if ([element respondsToSelector:@selector(accessibilityIdentifier)]) {
+          NSString *accessibilityID = [element accessibilityIdentifier];
+          if (accessibilityID.length > 0) {
+            [_accessibilityIDsOfUnindexedElements addObject:accessibilityID];
+          }
+        }
+      }
+    }
+  }
+
+  NSSet *rootElementSet = [NSSet setWithArray:rootElements];
+  NSMutableArray *views = [[NSMutableArray alloc] init];
+  for (UIView *view in [_viewsByAccessibilityID objectForKey:accessibilityID]) {
+    // The identifier might have changed since the view was indexed.
+    if (![view.accessibilityIdentifier isEqualToString:accessibilityID]) {
+      continue;
+    }
+    for (UIView *ancestor = view; ancestor; ancestor = ancestor.superview) {
+      if ([rootElementSet containsObject:ancestor]) {
+        [views addObject:view];
+        break;
+      }
+    }
+  }
+  return views;
+}
+
+- (void)recordAccessibilityIDOfUnindexedElement:(NSString *)accessibilityID {
+  if (accessibilityID.length == 0) {
+    return;
+  }
+  if (![NSThread isMainThread]) {
+    NSString *accessibilityIDCopy = [accessibilityID copy];
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [self recordAccessibilityIDOfUnindexedElement:accessibilityIDCopy];
+    });
+    return;
+  }
+  [_accessibilityIDsOfUnindexedElements addObject:accessibilityID];
+}
+
+- (BOOL)hasUnindexedElementsWithAccessibilityID:(NSString *)accessibilityID {
+  GREYFatalAssertMainThread();
+  return [_accessibilityIDsOfUnindexedElements containsObject:accessibilityID];
+}
+
+- (void)deactivate {
+  _active = NO;
+  [_viewsByAccessibilityID removeAllObjects];
+  [_indexedRootElements removeAllObjects];
+}
+
++ (void)setAccessibilityID:(NSString *)accessibilityID
+         requiredByMatcher:(id<GREYMatcher>)matcher {
+  GREYThrowOnNilParameter(accessibilityID);
+  GREYThrowOnNilParameter(matcher);
+
+  objc_setAssociatedObject(matcher,
+                           @selector(accessibilityIDRequiredByMatcher:),
+                           accessibilityID,
+                           OBJC_ASSOCIATION_COPY_NONATOMIC);
+}
+
++ (NSString *)accessibilityIDRequiredByMatcher:(id<GREYMatcher>)matcher {
+  return objc_getAssociatedObject(matcher, @selector(accessibilityIDRequiredByMatcher:));
+}
+
+#pragma mark - Private
+
+/**
+ *  The index is only ever updated on the main thread. If UIKit is being used from another thread,
+ *  the index can't be kept up to date, so it is deactivated and rebuilt on the next lookup.
+ *
+ *  @return @c YES if the index can be updated on the current thread, @c NO otherwise.
+ */
+- (BOOL)grey_isSafeToUpdate {
+  if ([NSThread isMainThread]) {
+    return YES;
+  }
+  _active = NO;
+  return NO;
+}
+
+/**
+ *  Adds @c view to the index under its current accessibility identifier, if it has one.
+ *
+ *  @param view The view to be added.
+ */
+- (void)grey_addView:(UIView *)view {
+  NSString *accessibilityID = view.accessibilityIdentifier;
+  if (accessibilityID.length == 0) {
+    return;
+  }
+  NSHashTable *views = [_viewsByAccessibilityID objectForKey:accessibilityID];
+  if (!views) {
+    views = [NSHashTable weakObjectsHashTable];
+    [_viewsByAccessibilityID setObject:views forKey:accessibilityID];
+  }
+  [views addObject:view];
+}
+
+@end
@@ -17,6 +17,7 @@
 #import "Core/GREYElementInteraction.h"
 
 #import "Action/GREYAction.h"
+#import "Action/GREYScrollAction+Internal.h"
 #import "Additions/NSError+GREYAdditions.h"
 #import "Additions/NSObject+GREYAdditions.h"
 #import "Assertion/GREYAssertion.h"
@@ -32,6 +33,7 @@
 #import "Common/GREYLogger.h"
 #import "Common/GREYObjectFormatter.h"
 #import "Common/GREYStopwatch.h"
+#import "Common/GREYTracer.h"
 #import "Common/GREYThrowDefines.h"
 #import "Core/GREYElementFinder.h"
 #import "Core/GREYElementInteraction+Internal.h"
@@ -92,23 +94,32 @@
 
   GREYElementProvider *entireRootHierarchyProvider =
       [GREYElementProvider providerWithRootProvider:[strongDataSource rootElementProvider]];
-  id<GREYMatcher> elementMatcher = _elementMatcher;
-  if (_rootMatcher) {
-    elementMatcher = grey_allOf(elementMatcher, grey_ancestor(_rootMatcher), nil);
-  }
-  GREYElementFinder *elementFinder = [[GREYElementFinder alloc] initWithMatcher:elementMatcher];
   NSError *searchActionError = nil;
   CFTimeInterval timeoutTime = CACurrentMediaTime() + timeout;
   // We want the search action to be performed at least once.
   static unsigned short kMinimumIterationAttempts = 1;
   unsigned short numIterations = 0;
   BOOL timedOut = NO;
+  id<GREYAction> searchAction = _searchAction;
+  if ([searchAction isMemberOfClass:[GREYScrollAction class]]) {
+    BOOL plansAmounts = GREY_CONFIG_BOOL(kGREYConfigKeyScrollSearchPlanningEnabled);
+    BOOL setsContentOffset = GREY_CONFIG_BOOL(kGREYConfigKeyScrollSearchContentOffsetEnabled);
+    if (plansAmounts || setsContentOffset) {
+      // The search action is configured for this search only, and keeps the state of planned
+      // amounts across its scrolls, so a new one is needed.
+      GREYScrollAction *scrollAction = (GREYScrollAction *)searchAction;
+      searchAction = [scrollAction searchActionPlanningAmounts:plansAmounts
+                                          settingContentOffset:setsContentOffset];
+    }
+  }
   while (YES) {
     @autoreleasepool {
       // Find the element in the current UI hierarchy.
       GREYStopwatch *elementFinderStopwatch = [[GREYStopwatch alloc] init];
       [elementFinderStopwatch start];
-      NSArray *elements = [elementFinder elementsMatchedInProvider:entireRootHierarchyProvider];
+      GREYTraceSpan searchSpan = GREYTraceBegin(kGREYTraceSpanElementSearch);
+      NSArray *elements = [self grey_elementsMatchedInProvider:entireRootHierarchyProvider];
+      GREYTraceEndWithArguments(&searchSpan, @{ @"matchedElements" : @(elements.count) });
       [elementFinderStopwatch stop];
       GREYLogVerbose(@"Element found for matcher: %@\n with time: %f seconds",
                      _elementMatcher,
@@ -139,7 +150,7 @@
           [[GREYElementInteraction alloc] initWithElementMatcher:_searchActionElementMatcher];
       // Don't fail if this interaction error's out. It might still have revealed the element
       // we're looking for.
-      [interaction performAction:_searchAction error:&searchActionError];
+      [interaction performAction:searchAction error:&searchActionError];
 
       // After a search action, if we have timed out, then we drain the thread by passing 0.
       // Otherwise, passing negative will throw an exception.
@@ -209,6 +220,7 @@
   GREYLogVerbose(@"Action to perform: %@", [action name]);
   GREYStopwatch *stopwatch = [[GREYStopwatch alloc] init];
   [stopwatch start];
+  GREYTraceSpan interactionSpan = GREYTraceBeginInteraction(kGREYTraceSpanPerformAction);
 
   @autoreleasepool {
     NSError *executorError;
@@ -259,7 +271,16 @@
       GREYLogVerbose(@"Performing action: %@\n with matcher: %@\n with root matcher: %@",
                      [action name], _elementMatcher, _rootMatcher);
 
-      if (element && ![action perform:element error:&actionError]) {
+      BOOL actionPerformed = YES;
+      if (element) {
+        GREYTraceSpan actionSpan = GREYTraceBegin(kGREYTraceSpanActionExecution);
+        @try {
+          actionPerformed = [action perform:element error:&actionError];
+        } @finally {
+          GREYTraceEnd(&actionSpan);
+        }
+      }
+      if (!actionPerformed) {
         interactionFailed = YES;
         // Action didn't succeed yet no error was set.
         if (!actionError) {
@@ -313,9 +334,13 @@
                   userProvidedOutError:errorOrNil];
     }
     // Drain once to update idling resources and redraw the screen.
+    GREYTraceSpan drainSpan = GREYTraceBegin(kGREYTraceSpanPostActionDrain);
     [[GREYUIThreadExecutor sharedInstance] drainOnce];
+    GREYTraceEnd(&drainSpan);
 
     [stopwatch stop];
+    GREYTraceEndWithArguments(&interactionSpan, @{ @"action" : [action name],
+                                                   @"succeeded" : @(!actionFailed) });
     if (actionFailed) {
       GREYLogVerbose(@"Action failed: %@ with time: %f seconds",
                      [action name],
@@ -342,6 +367,7 @@
   GREYLogVerbose(@"Assertion to perform: %@", [assertion name]);
   GREYStopwatch *stopwatch = [[GREYStopwatch alloc] init];
   [stopwatch start];
+  GREYTraceSpan interactionSpan = GREYTraceBeginInteraction(kGREYTraceSpanAssert);
 
   @autoreleasepool {
     NSError *executorError;
@@ -396,9 +422,18 @@
       // we check the assertion directly and see if there was any issue. The only case where we
       // are completely sure we do not need to perform the action is in the case of a multiple
       // matcher.
+      BOOL assertionPassed = NO;
+      if (!multipleMatchesPresent) {
+        GREYTraceSpan assertionSpan = GREYTraceBegin(kGREYTraceSpanAssertionExecution);
+        @try {
+          assertionPassed = [assertion assert:element error:&assertionError];
+        } @finally {
+          GREYTraceEnd(&assertionSpan);
+        }
+      }
       if (multipleMatchesPresent) {
         interactionFailed = YES;
-      } else if (![assertion assert:element error:&assertionError]) {
+      } else if (!assertionPassed) {
         interactionFailed = YES;
         // Set the elementNotFoundError to the assertionError since the error has been utilized
         // already.
@@ -459,6 +494,8 @@
     }
 
     [stopwatch stop];
+    GREYTraceEndWithArguments(&interactionSpan, @{ @"assertion" : [assertion name],
+                                                   @"succeeded" : @(!assertionFailed) });
     if (assertionFailed) {
       GREYLogVerbose(@"Assertion failed: %@ with time: %f seconds",
                      [assertion name],
@@ -493,6 +530,44 @@
 
 # pragma mark - Private
 
+/**
+ *  Searches for the elements matched by the element matcher. If a root matcher is set, the root
+ *  element is searched for first and, if it is unique, only its hierarchy is searched.
+ *
+ *  @param entireRootHierarchyProvider Provides the entire hierarchy being interacted with.
+ *
+ *  @return An array of matched elements. If no matching element is found, then it is empty.
+ */
+- (NSArray *)grey_elementsMatchedInProvider:(GREYElementProvider *)entireRootHierarchyProvider {
+  if (!_rootMatcher) {
+    GREYElementFinder *elementFinder = [[GREYElementFinder alloc] initWithMatcher:_elementMatcher];
+    return [elementFinder elementsMatchedInProvider:entireRootHierarchyProvider];
+  }
+
+  GREYElementFinder *rootFinder = [[GREYElementFinder alloc] initWithMatcher:_rootMatcher];
+  NSArray *rootElements = [rootFinder elementsMatchedInProvider:entireRootHierarchyProvider];
+  if (rootElements.count == 0) {
+    return @[];
+  } else if (rootElements.count == 1) {
+    GREYElementFinder *elementFinder = [[GREYElementFinder alloc] initWithMatcher:_elementMatcher];
+    GREYElementProvider *rootHierarchyProvider =
+        [GREYElementProvider providerWithRootElements:rootElements];
+    NSMutableArray *elements =
+        [[elementFinder elementsMatchedInProvider:rootHierarchyProvider] mutableCopy];
+    // Only the descendants of the root element are in the root.
+    [elements removeObjectIdenticalTo:[rootElements firstObject]];
+    return elements;
+  }
+
+  // The hierarchies of multiple root elements can overlap, and enumerating them one after the other
+  // wouldn't preserve the order of the entire hierarchy, which atIndex: relies on. Instead, search
+  // the entire hierarchy for elements with a matching ancestor, whose results are memoized for the
+  // duration of the search.
+  id<GREYMatcher> elementMatcher = grey_allOf(_elementMatcher, grey_ancestor(_rootMatcher), nil);
+  GREYElementFinder *elementFinder = [[GREYElementFinder alloc] initWithMatcher:elementMatcher];
+  return [elementFinder elementsMatchedInProvider:entireRootHierarchyProvider];
+}
+
 /**
  *  From the set of matched elements, obtain one unique element for the provided matcher. In case
  *  there are multiple elements matched, then the one selected by the _@c index provided is chosen
@@ -18,6 +18,8 @@
 
 #import <EarlGrey/GREYDefines.h>
 
+@class GREYTouchPath;
+
 NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark - Error domain and codes
@@ -71,12 +73,13 @@ typedef NS_ENUM(NSInteger, GREYSyntheticEventInjectionErrorCode) {
 + (BOOL)shakeDeviceWithError:(__strong NSError **)errorOrNil;
 
 /**
- *  Touch along a specified path in a @c CGPoint array.
+ *  Touch along a specified touch path.
  *  This method blocks until all touches are delivered.
  *
- *  @param touchPath  An array of @c CGPoints. The first point in @c touchPath is the point where
-                      touch begins, and the last point in @c touchPath is the final touch point
-                      where touch ends. Points in @c touchPath must be in @c window coordinates.
+ *  @param touchPath  The path of @c CGPoints to touch along. The first point in @c touchPath is the
+ *                    point where touch begins, and the last point in @c touchPath is the final
+ *                    touch point where touch ends. Points in @c touchPath must be in @c window
+ *                    coordinates.
  *  @param window     The UIWindow that contains the points in the @c touchPath where
  *                    the touches are performed. Interaction will begin on the view inside
  *                    @c window which passes the hit-test for the first point in @c touchPath.
@@ -87,21 +90,21 @@ typedef NS_ENUM(NSInteger, GREYSyntheticEventInjectionErrorCode) {
  *                    use it to model time sensitive gestures like swipes where timing is more
  *                    important than accuracy. Is ignored if @c NO.
  */
-+ (void)touchAlongPath:(NSArray *)touchPath
-      relativeToWindow:(UIWindow *)window
-           forDuration:(NSTimeInterval)duration
-            expendable:(BOOL)expendable;
++ (void)touchAlongTouchPath:(GREYTouchPath *)touchPath
+           relativeToWindow:(UIWindow *)window
+                forDuration:(NSTimeInterval)duration
+                 expendable:(BOOL)expendable;
 
 /**
  *  Injects a multi touch sequence specified by the array of @c touchPaths in the specified @c
  *  duration.
- *  Note that a single touch path is an array of CGPoint structs identifying the path taken by it
- *  relative to the specified @c window. Here @c expendable indicates if the touch path must be
- *  delivered with accurate timing even if a few touch objects (excluding the last one) have to be
- *  skipped. Use it to model time sensitive gestures like pinch where timing is more important than
- *  accuracy.
+ *  Note that a single touch path is a GREYTouchPath of CGPoint structs identifying the path taken
+ *  by it relative to the specified @c window, and all touch paths must have the same number of
+ *  points. Here @c expendable indicates if the touch path must be delivered with accurate timing
+ *  even if a few touch objects (excluding the last one) have to be skipped. Use it to model time
+ *  sensitive gestures like pinch where timing is more important than accuracy.
  *
- *  @param touchPaths An array of @c touchpaths each of which are array of @c CGPoints.
+ *  @param touchPaths An array of @c touchpaths each of which is a GREYTouchPath of @c CGPoints.
  *                    The first point in @c touchPath is the point where touch begins, and the last
  *                    point in @c touchPath is the final touch point where touch ends. Points in @c
  *                    touchPath Points in @c touchPath must be in @c window coordinates.
@@ -115,7 +118,40 @@ typedef NS_ENUM(NSInteger, GREYSyntheticEventInjectionErrorCode) {
  *                    use it to model time sensitive gestures like swipes where timing is more
  *                    important than accuracy. Is ignored if @c NO.
  */
-+ (void)touchAlongMultiplePaths:(NSArray *)touchPaths
++ (void)touchAlongMultipleTouchPaths:(NSArray<GREYTouchPath *> *)touchPaths
+                    relativeToWindow:(UIWindow *)window
+                         forDuration:(NSTimeInterval)duration
+                          expendable:(BOOL)expendable;
+
+/**
+ *  Touch along a specified path in a @c CGPoint array.
+ *  This method blocks until all touches are delivered.
+ *
+ *  @param touchPath  An array of @c NSValue objects wrapping @c CGPoints, which is converted to a
+ *                    GREYTouchPath. See GREYSyntheticEvents::touchAlongTouchPath:relativeToWindow:
+ *                    forDuration:expendable: for the meaning of the parameters.
+ *  @param window     The UIWindow that contains the points in the @c touchPath.
+ *  @param duration   The time interval over which to space the touches evenly.
+ *  @param expendable Whether touches may be skipped in favor of accurate timing.
+ */
++ (void)touchAlongPath:(NSArray<NSValue *> *)touchPath
+      relativeToWindow:(UIWindow *)window
+           forDuration:(NSTimeInterval)duration
+            expendable:(BOOL)expendable;
+
+/**
+ *  Injects a multi touch sequence specified by the array of @c touchPaths in the specified @c
+ *  duration.
+ *
+ *  @param touchPaths An array of touch paths, each of which is an array of @c NSValue objects
+ *                    wrapping @c CGPoints and is converted to a GREYTouchPath. See
+ *                    GREYSyntheticEvents::touchAlongMultipleTouchPaths:relativeToWindow:
+ *                    forDuration:expendable: for the meaning of the parameters.
+ *  @param window     The UIWindow that contains the points in the @c touchPaths.
+ *  @param duration   The time interval over which to space the touches evenly.
+ *  @param expendable Whether touches may be skipped in favor of accurate timing.
+ */
++ (void)touchAlongMultiplePaths:(NSArray<NSArray<NSValue *> *> *)touchPaths
                relativeToWindow:(UIWindow *)window
                     forDuration:(NSTimeInterval)duration
                      expendable:(BOOL)expendable;
@@ -149,6 +185,24 @@ typedef NS_ENUM(NSInteger, GREYSyntheticEventInjectionErrorCode) {
            immediateDelivery:(BOOL)immediate
                   expendable:(BOOL)expendable;
 
+/**
+ *  Continues the current interaction by moving touch to the point at @c pointIndex of
+ *  @c touchPath. Behaves like
+ *  GREYSyntheticEvents::continueTouchAtPoint:immediateDelivery:expendable: without copying the
+ *  point out of @c touchPath.
+ *
+ *  @param touchPath  The touch path containing the point to move the touch to.
+ *  @param pointIndex The index of the point in @c touchPath.
+ *  @param immediate  If @c YES, this method blocks until touch is delivered, otherwise the touch is
+ *                    enqueued for delivery the next time runloop drains.
+ *  @param expendable @c YES indicates that this touch point is intended to be delivered in a timely
+ *                    manner rather than reliably. Is ignored if @c NO.
+ */
+- (void)continueTouchAlongPath:(GREYTouchPath *)touchPath
+                  atPointIndex:(NSUInteger)pointIndex
+             immediateDelivery:(BOOL)immediate
+                    expendable:(BOOL)expendable;
+
 /**
  *  Ends interaction started by GREYSyntheticEvents::beginTouchAtPoint:relativeToWindow.
  *  This method will block until all the touches since the beginning of the interaction have been
@@ -26,6 +26,7 @@
 #import "Common/GREYLogger.h"
 #import "Common/GREYThrowDefines.h"
 #import "Event/GREYTouchInjector.h"
+#import "Event/GREYTouchPath.h"
 #import "Synchronization/GREYUIThreadExecutor.h"
 
 #pragma mark - Extern
@@ -46,9 +47,14 @@ static const CFTimeInterval kRotationTimeout = 10.0;
   GREYTouchInjector *_touchInjector;
 
   /**
-   *  The last injected touch point.
+   *  The touch path containing the last injected touch point.
    */
-  NSValue *_lastInjectedTouchPoint;
+  GREYTouchPath *_lastInjectedTouchPath;
+
+  /**
+   *  The index of the last injected touch point in @c _lastInjectedTouchPath.
+   */
+  NSUInteger _lastInjectedTouchPointIndex;
 }
 
 + (BOOL)rotateDeviceToOrientation:(UIDeviceOrientation)deviceOrientation
@@ -146,120 +152,152 @@ static const CFTimeInterval kRotationTimeout = 10.0;
   return YES;
 }
 
-+ (void)touchAlongPath:(NSArray *)touchPath
++ (void)touchAlongPath:(NSArray<NSValue *> *)touchPath
       relativeToWindow:(UIWindow *)window
            forDuration:(NSTimeInterval)duration
             expendable:(BOOL)expendable {
-  [self touchAlongMultiplePaths:@[touchPath]
-               relativeToWindow:window
-                    forDuration:duration
-                     expendable:expendable];
+  [self touchAlongTouchPath:[GREYTouchPath touchPathWithPointValues:touchPath]
+           relativeToWindow:window
+                forDuration:duration
+                 expendable:expendable];
 }
 
-+ (void)touchAlongMultiplePaths:(NSArray *)touchPaths
++ (void)touchAlongMultiplePaths:(NSArray<NSArray<NSValue *> *> *)touchPaths
                relativeToWindow:(UIWindow *)window
                     forDuration:(NSTimeInterval)duration
                      expendable:(BOOL)expendable {
+  NSMutableArray<GREYTouchPath *> *convertedTouchPaths =
+      [[NSMutableArray alloc] initWithCapacity:touchPaths.count];
+  for (NSArray<NSValue *> *touchPath in touchPaths) {
+    [convertedTouchPaths addObject:[GREYTouchPath touchPathWithPointValues:touchPath]];
+  }
+  [self touchAlongMultipleTouchPaths:convertedTouchPaths
+                    relativeToWindow:window
+                         forDuration:duration
+                          expendable:expendable];
+}
+
++ (void)touchAlongTouchPath:(GREYTouchPath *)touchPath
+           relativeToWindow:(UIWindow *)window
+                forDuration:(NSTimeInterval)duration
+                 expendable:(BOOL)expendable {
+  [self touchAlongMultipleTouchPaths:@[touchPath]
+                    relativeToWindow:window
+                         forDuration:duration
+                          expendable:expendable];
+}
+
++ (void)touchAlongMultipleTouchPaths:(NSArray<GREYTouchPath *> *)touchPaths
+                    relativeToWindow:(UIWindow *)window
+                         forDuration:(NSTimeInterval)duration
+                          expendable:(BOOL)expendable {
   GREYThrowOnFailedCondition(touchPaths.count >= 1);
   GREYThrowOnFailedCondition(duration >= 0);
 
   NSUInteger firstTouchPathSize = [touchPaths[0] count];
+  GREYFatalAssertWithMessage(firstTouchPathSize > 0, @"Touch paths must not be empty.");
+  for (GREYTouchPath *touchPath in touchPaths) {
+    GREYFatalAssertWithMessage(touchPath.count == firstTouchPathSize,
+                               @"All touch paths must be of the same size.");
+  }
   GREYSyntheticEvents *eventGenerator = [[GREYSyntheticEvents alloc] init];
 
   // Inject "begin" event for the first points of each path.
-  [eventGenerator grey_beginTouchesAtPoints:[self grey_objectsAtIndex:0 ofArrays:touchPaths]
-                           relativeToWindow:window
-                          immediateDelivery:NO];
+  [eventGenerator grey_beginTouchesAlongPaths:touchPaths
+                                 atPointIndex:0
+                             relativeToWindow:window
+                            immediateDelivery:NO];
 
   // If the paths have a single point, then just inject an "end" event with the delay being the
   // provided duration. Otherwise, insert multiple "continue" events with delays being a fraction
   // of the duration, then inject an "end" event with no delay.
   if (firstTouchPathSize == 1) {
-    [eventGenerator grey_endTouchesAtPoints:[self grey_objectsAtIndex:firstTouchPathSize - 1
-                                                             ofArrays:touchPaths]
-          timeElapsedSinceLastTouchDelivery:duration];
+    [eventGenerator grey_endTouchesAlongPaths:touchPaths
+                                 atPointIndex:firstTouchPathSize - 1
+            timeElapsedSinceLastTouchDelivery:duration];
   } else {
     // Start injecting "continue touch" events, starting from the second position on the touch
-    // path as it was already injected as a "begin touch" event.
+    // path as it was already injected as a "begin touch" event. A single touch info covers all of
+    // them, with the delivery time of each touch computed from the delay between events.
     CFTimeInterval delayBetweenEachEvent = duration / (double)(firstTouchPathSize - 1);
 
-    for (NSUInteger i = 1; i < firstTouchPathSize; i++) {
-      [eventGenerator grey_continueTouchAtPoints:[self grey_objectsAtIndex:i ofArrays:touchPaths]
-          afterTimeElapsedSinceLastTouchDelivery:delayBetweenEachEvent
-                               immediateDelivery:NO
-                                      expendable:expendable];
-    }
+    [eventGenerator grey_continueTouchesAlongPaths:touchPaths
+                                      inPointRange:NSMakeRange(1, firstTouchPathSize - 1)
+            afterTimeElapsedSinceLastTouchDelivery:delayBetweenEachEvent
+                                 immediateDelivery:NO
+                                        expendable:expendable];
 
-    [eventGenerator grey_endTouchesAtPoints:[self grey_objectsAtIndex:firstTouchPathSize - 1
-                                                             ofArrays:touchPaths]
-          timeElapsedSinceLastTouchDelivery:0];
+    [eventGenerator grey_endTouchesAlongPaths:touchPaths
+                                 atPointIndex:firstTouchPathSize - 1
+            timeElapsedSinceLastTouchDelivery:0];
   }
 }
 
 - (void)beginTouchAtPoint:(CGPoint)point
          relativeToWindow:(UIWindow *)window
         immediateDelivery:(BOOL)immediate {
-  _lastInjectedTouchPoint = [NSValue valueWithCGPoint:point];
-  [self grey_beginTouchesAtPoints:@[_lastInjectedTouchPoint]
-                 relativeToWindow:window
-                immediateDelivery:immediate];
+  _lastInjectedTouchPath = [GREYTouchPath touchPathWithPoint:point];
+  _lastInjectedTouchPointIndex = 0;
+  [self grey_beginTouchesAlongPaths:@[_lastInjectedTouchPath]
+                       atPointIndex:0
+                   relativeToWindow:window
+                  immediateDelivery:immediate];
 }
 
 - (void)continueTouchAtPoint:(CGPoint)point
            immediateDelivery:(BOOL)immediate
                   expendable:(BOOL)expendable {
-  _lastInjectedTouchPoint = [NSValue valueWithCGPoint:point];
-  [self grey_continueTouchAtPoints:@[_lastInjectedTouchPoint]
-      afterTimeElapsedSinceLastTouchDelivery:0
-                           immediateDelivery:immediate
-                                  expendable:expendable];
+  [self continueTouchAlongPath:[GREYTouchPath touchPathWithPoint:point]
+                  atPointIndex:0
+             immediateDelivery:immediate
+                    expendable:expendable];
+}
+
+- (void)continueTouchAlongPath:(GREYTouchPath *)touchPath
+                  atPointIndex:(NSUInteger)pointIndex
+             immediateDelivery:(BOOL)immediate
+                    expendable:(BOOL)expendable {
+  _lastInjectedTouchPath = touchPath;
+  _lastInjectedTouchPointIndex = pointIndex;
+  [self grey_continueTouchesAlongPaths:@[touchPath]
+                          inPointRange:NSMakeRange(pointIndex, 1)
+afterTimeElapsedSinceLastTouchDelivery:0
+                     immediateDelivery:immediate
+                            expendable:expendable];
 }
 
 - (void)endTouch {
-  [self grey_endTouchesAtPoints:@[_lastInjectedTouchPoint]
-      timeElapsedSinceLastTouchDelivery:0];
+  [self grey_endTouchesAlongPaths:@[_lastInjectedTouchPath]
+                     atPointIndex:_lastInjectedTouchPointIndex
+timeElapsedSinceLastTouchDelivery:0];
 }
 
 #pragma mark - Private
 
-// Given an array containing multiple arrays, returns an array with the index'th element of each
-// array.
-+ (NSArray *)grey_objectsAtIndex:(NSUInteger)index ofArrays:(NSArray *)arrayOfArrays {
-  GREYFatalAssertWithMessage([arrayOfArrays count] > 0,
-                             @"arrayOfArrays must contain at least one element.");
-  NSUInteger firstArraySize = [arrayOfArrays[0] count];
-  GREYFatalAssertWithMessage(index < firstArraySize,
-                             @"index must be smaller than the size of the arrays.");
-
-  NSMutableArray *output = [[NSMutableArray alloc] initWithCapacity:[arrayOfArrays count]];
-  for (NSArray *array in arrayOfArrays) {
-    GREYFatalAssertWithMessage([array count] == firstArraySize,
-                               @"All arrays must be of the same size.");
-    [output addObject:array[index]];
-  }
-
-  return output;
-}
-
 /**
- *  Begins interaction with new touches starting at multiple @c points. Touch will be delivered to
- *  the hit test view in @c window under point and will not end until @c endTouch is called.
+ *  Begins interaction with new touches starting at the point at @c pointIndex of multiple
+ *  @c touchPaths. Touch will be delivered to the hit test view in @c window under point and will
+ *  not end until @c endTouch is called.
  *
- *  @param points    Multiple points where touches should start.
- *  @param window    The window that contains the coordinates of the touch points.
- *  @param immediate If @c YES, this method blocks until touch is delivered, otherwise the touch is
- *                   enqueued for delivery the next time runloop drains.
+ *  @param touchPaths Multiple touch paths, one for each touch.
+ *  @param pointIndex The index of the points of @c touchPaths where touches should start.
+ *  @param window     The window that contains the coordinates of the touch points.
+ *  @param immediate  If @c YES, this method blocks until touch is delivered, otherwise the touch is
+ *                    enqueued for delivery the next time runloop drains.
  */
-- (void)grey_beginTouchesAtPoints:(NSArray *)points
-                 relativeToWindow:(UIWindow *)window
-                immediateDelivery:(BOOL)immediate {
+- (void)grey_beginTouchesAlongPaths:(NSArray<GREYTouchPath *> *)touchPaths
+                       atPointIndex:(NSUInteger)pointIndex
+                   relativeToWindow:(UIWindow *)window
+                  immediateDelivery:(BOOL)immediate {
   GREYFatalAssertWithMessage(!_touchInjector,
                              @"Cannot call this method more than once until endTouch is called.");
   _touchInjector = [[GREYTouchInjector alloc] initWithWindow:window];
-  GREYTouchInfo *touchInfo = [[GREYTouchInfo alloc] initWithPoints:points
-                                                             phase:GREYTouchInfoPhaseTouchBegan
-                                   deliveryTimeDeltaSinceLastTouch:0
-                                                        expendable:NO];
+  GREYTouchInfo *touchInfo =
+      [[GREYTouchInfo alloc] initWithTouchPaths:touchPaths
+                                     pointRange:NSMakeRange(pointIndex, 1)
+                                          phase:GREYTouchInfoPhaseTouchBegan
+                deliveryTimeDeltaSinceLastTouch:0
+                                     expendable:NO];
   [_touchInjector enqueueTouchInfoForDelivery:touchInfo];
   if (immediate) {
     [_touchInjector waitUntilAllTouchesAreDeliveredUsingInjector];
@@ -267,23 +305,27 @@ static const CFTimeInterval kRotationTimeout = 10.0;
 }
 
 /**
- *  Enqueues the next touch to be delivered.
+ *  Enqueues the next touches to be delivered, one for each point in @c pointRange.
  *
- *  @param points     Multiple points at which the touches are to be made.
+ *  @param touchPaths Multiple touch paths, one for each touch.
+ *  @param pointRange The range of points of @c touchPaths at which the touches are to be made.
  *  @param seconds    An interval to wait after the every last touch event.
  *  @param immediate  if @c YES, this method blocks until touches are delivered, otherwise it is
  *                    enqueued for delivery the next time runloop drains.
- *  @param expendable Indicates that this touch point is intended to be delivered in a timely
+ *  @param expendable Indicates that these touch points are intended to be delivered in a timely
  *                    manner rather than reliably.
  */
-- (void)grey_continueTouchAtPoints:(NSArray *)points
-    afterTimeElapsedSinceLastTouchDelivery:(NSTimeInterval)seconds
-                         immediateDelivery:(BOOL)immediate
-                                expendable:(BOOL)expendable {
-  GREYTouchInfo *touchInfo = [[GREYTouchInfo alloc] initWithPoints:points
-                                                             phase:GREYTouchInfoPhaseTouchMoved
-                                   deliveryTimeDeltaSinceLastTouch:seconds
-                                                        expendable:expendable];
+- (void)grey_continueTouchesAlongPaths:(NSArray<GREYTouchPath *> *)touchPaths
+                          inPointRange:(NSRange)pointRange
+afterTimeElapsedSinceLastTouchDelivery:(NSTimeInterval)seconds
+                     immediateDelivery:(BOOL)immediate
+                            expendable:(BOOL)expendable {
+  GREYTouchInfo *touchInfo =
+      [[GREYTouchInfo alloc] initWithTouchPaths:touchPaths
+                                     pointRange:pointRange
+                                          phase:GREYTouchInfoPhaseTouchMoved
+                deliveryTimeDeltaSinceLastTouch:seconds
+                                     expendable:expendable];
   [_touchInjector enqueueTouchInfoForDelivery:touchInfo];
 
   if (immediate) {
@@ -291,12 +333,15 @@ static const CFTimeInterval kRotationTimeout = 10.0;
   }
 }
 
-- (void)grey_endTouchesAtPoints:(NSArray *)points
-    timeElapsedSinceLastTouchDelivery:(NSTimeInterval)seconds {
-  GREYTouchInfo *touchInfo = [[GREYTouchInfo alloc] initWithPoints:points
-                                                             phase:GREYTouchInfoPhaseTouchEnded
-                                   deliveryTimeDeltaSinceLastTouch:seconds
-                                                        expendable:NO];
+- (void)grey_endTouchesAlongPaths:(NSArray<GREYTouchPath *> *)touchPaths
+                     atPointIndex:(NSUInteger)pointIndex
+timeElapsedSinceLastTouchDelivery:(NSTimeInterval)seconds {
+  GREYTouchInfo *touchInfo =
+      [[GREYTouchInfo alloc] initWithTouchPaths:touchPaths
+                                     pointRange:NSMakeRange(pointIndex, 1)
+                                          phase:GREYTouchInfoPhaseTouchEnded
+                deliveryTimeDeltaSinceLastTouch:seconds
+                                     expendable:NO];
 
   [_touchInjector enqueueTouchInfoForDelivery:touchInfo];
   [_touchInjector waitUntilAllTouchesAreDeliveredUsingInjector];
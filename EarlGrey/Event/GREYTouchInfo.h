@@ -16,6 +16,8 @@
 
 #import <UIKit/UIKit.h>
 
+@class GREYTouchPath;
+
 /**
  *  An enum for what phase of a touch action a @c GREYTouchInfo object is in.
  */
@@ -28,14 +30,21 @@ typedef NS_ENUM(NSUInteger, GREYTouchInfoPhase) {
 NS_ASSUME_NONNULL_BEGIN
 
 /**
- *  An object to encapsulate essential information about a touch.
+ *  An object to encapsulate essential information about a run of touches along one or more touch
+ *  paths, one path per finger. Each touch in the run is delivered at the next point of every path.
  */
 @interface GREYTouchInfo : NSObject
 
 /**
- *  Points where touch should be delivered.
+ *  Paths along which touches should be delivered, one for each finger.
+ */
+@property(nonatomic, readonly) NSArray<GREYTouchPath *> *touchPaths;
+
+/**
+ *  The range of points of GREYTouchInfo::touchPaths where touches should be delivered, one touch
+ *  per point.
  */
-@property(nonatomic, readonly) NSArray *points;
+@property(nonatomic, readonly) NSRange pointRange;
 
 /**
  *  The phase (began, moved etc) of the touch object.
@@ -43,22 +52,25 @@ NS_ASSUME_NONNULL_BEGIN
 @property(nonatomic, assign) GREYTouchInfoPhase phase;
 
 /**
- *  Delays this touch for specified value since the last touch delivery.
+ *  Delays each touch for specified value since the delivery of the touch before it.
  */
 @property(nonatomic, readonly) NSTimeInterval deliveryTimeDeltaSinceLastTouch;
 /**
- *  Indicates that this touch can be dropped if system delivering the touches experiences a
+ *  Indicates that these touches can be dropped if system delivering the touches experiences a
  *  lag causing it to miss the expected delivery time.
  */
 @property(nonatomic, readonly, getter=isExpendable) BOOL expendable;
 
 /**
- *  Initializes this object to represent a touch at the the given @c points.
+ *  Initializes this object to represent touches at the given @c pointRange of the @c touchPaths.
  *
- *  @param points                         The CGPoints where the touches are to be delivered.
+ *  @param touchPaths                     The paths along which the touches are to be delivered,
+ *                                        one for each finger. Each path must contain every point
+ *                                        of @c pointRange.
+ *  @param pointRange                     The range of points of each path to deliver touches at.
  *  @param phase                          The current phase of each touch point.
- *  @param timeDeltaSinceLastTouchSeconds The relative injection time from the time last
- *                                        touch point was injected. It is also used as the
+ *  @param timeDeltaSinceLastTouchSeconds The relative injection time of each touch from the time
+ *                                        the touch before it was injected. It is also used as the
  *                                        expected delivery time.
  *  @param expendable                     Used for time sensitive touches, it specified if the
  *                                        touch can be dropped if system lag causes the system to
@@ -67,16 +79,25 @@ NS_ASSUME_NONNULL_BEGIN
  *
  *  @return An instance of GREYTouchInfo, initialized with all required data.
  */
-- (instancetype)initWithPoints:(NSArray *)points
-                              phase:(GREYTouchInfoPhase)phase
-    deliveryTimeDeltaSinceLastTouch:(NSTimeInterval)timeDeltaSinceLastTouchSeconds
-                         expendable:(BOOL)expendable NS_DESIGNATED_INITIALIZER;
+- (instancetype)initWithTouchPaths:(NSArray<GREYTouchPath *> *)touchPaths
+                        pointRange:(NSRange)pointRange
+                             phase:(GREYTouchInfoPhase)phase
+   deliveryTimeDeltaSinceLastTouch:(NSTimeInterval)timeDeltaSinceLastTouchSeconds
+                        expendable:(BOOL)expendable NS_DESIGNATED_INITIALIZER;
 
 /**
  *  @remark init is not an available initializer. Use the other initializers.
  */
 - (instancetype)init NS_UNAVAILABLE;
 
+/**
+ *  @param finger The index of the finger, must be less than the number of touch paths.
+ *  @param index  The index of the point in the finger's touch path.
+ *
+ *  @return The point at @c index of the touch path of @c finger.
+ */
+- (CGPoint)pointForFinger:(NSUInteger)finger atIndex:(NSUInteger)index;
+
 @end
 
 NS_ASSUME_NONNULL_END
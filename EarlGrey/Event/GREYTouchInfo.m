@@ -16,15 +16,28 @@
 
 #import "Event/GREYTouchInfo.h"
 
+#import "Common/GREYFatalAsserts.h"
+#import "Event/GREYTouchPath.h"
+
 @implementation GREYTouchInfo
 
-- (instancetype)initWithPoints:(NSArray *)points
-                                phase:(GREYTouchInfoPhase)phase
-      deliveryTimeDeltaSinceLastTouch:(NSTimeInterval)timeDeltaSinceLastTouchSeconds
-                           expendable:(BOOL)expendable {
+- (instancetype)initWithTouchPaths:(NSArray<GREYTouchPath *> *)touchPaths
+                        pointRange:(NSRange)pointRange
+                             phase:(GREYTouchInfoPhase)phase
+   deliveryTimeDeltaSinceLastTouch:(NSTimeInterval)timeDeltaSinceLastTouchSeconds
+                        expendable:(BOOL)expendable {
+  GREYFatalAssertWithMessage(touchPaths.count > 0, @"At least one touch path is required.");
+  GREYFatalAssertWithMessage(pointRange.length > 0, @"At least one touch point is required.");
+  for (GREYTouchPath *touchPath in touchPaths) {
+    GREYFatalAssertWithMessage(NSMaxRange(pointRange) <= touchPath.count,
+                               @"Touch path %@ doesn't contain the point range %@.",
+                               touchPath, NSStringFromRange(pointRange));
+  }
+
   self = [super init];
   if (self) {
-    _points = points;
+    _touchPaths = [touchPaths copy];
+    _pointRange = pointRange;
     _phase = phase;
     _deliveryTimeDeltaSinceLastTouch = timeDeltaSinceLastTouchSeconds;
     _expendable = expendable;
@@ -32,4 +45,8 @@
   return self;
 }
 
+- (CGPoint)pointForFinger:(NSUInteger)finger atIndex:(NSUInteger)index {
+  return [_touchPaths[finger] pointAtIndex:index];
+}
+
 @end
@@ -67,12 +67,12 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)initWithWindow:(UIWindow *)window NS_DESIGNATED_INITIALIZER;
 
 /**
- *  Enqueues @c touchInfo that will be materialized into a UITouch and delivered to application.
+ *  Enqueues @c touchInfo whose touches will be materialized into UITouches and delivered to
+ *  application, one touch for each point in its point range.
  *
  *  @param touchInfo The info that is used to create the UITouch. If it represents a last touch
- *                   in a sequence, the specified @c point value is ignored and injector
- *                   automatically picks the previous point where touch occurred to deliver
- *                   the last touch.
+ *                   in a sequence, the specified points are ignored and injector automatically
+ *                   picks the previous point where touch occurred to deliver the last touch.
  */
 - (void)enqueueTouchInfoForDelivery:(GREYTouchInfo *)touchInfo;
 
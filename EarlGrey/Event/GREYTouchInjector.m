@@ -24,9 +24,11 @@
 #import "Additions/UIWebView+GREYAdditions.h"
 #import "Assertion/GREYAssertionDefines.h"
 #import "Common/GREYAppleInternals.h"
+#import "Common/GREYConfiguration.h"
 #import "Common/GREYDefines.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYThrowDefines.h"
+#import "Event/GREYTouchPath.h"
 #import "Event/GREYZeroToleranceTimer.h"
 #import "Synchronization/GREYRunLoopSpinner.h"
 
@@ -45,6 +47,20 @@ static const NSTimeInterval kGREYTouchInjectionInterval = 1.0 / kGREYTouchInject
 static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
 #endif  // !defined(__IPHONE_12_0) || __IPHONE_OS_VERSION_MIN_REQUIRED < __IPHONE_12_0
 
+/**
+ *  @param uptime A time in seconds since system startup.
+ *
+ *  @return @c uptime in the units of @c mach_absolute_time.
+ */
+static uint64_t GREYMachAbsoluteTimeFromUptime(NSTimeInterval uptime) {
+  static mach_timebase_info_data_t timebase;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    mach_timebase_info(&timebase);
+  });
+  return (uint64_t)(uptime * NSEC_PER_SEC * timebase.denom / timebase.numer);
+}
+
 @interface GREYTouchInjector() <GREYZeroToleranceTimerTarget>
 @end
 
@@ -52,7 +68,10 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
   // Window to which touches will be delivered.
   UIWindow *_window;
   // List of objects that aid in creation of UITouches.
-  NSMutableArray *_enqueuedTouchInfoList;
+  NSMutableArray<GREYTouchInfo *> *_enqueuedTouchInfoList;
+  // The number of touches of the first touch info in |_enqueuedTouchInfoList| that have already
+  // been dequeued.
+  NSUInteger _dequeuedTouchesOfFirstTouchInfo;
   // A timer used for injecting touches.
   GREYZeroToleranceTimer *_timer;
   // Touch objects created to start the touch sequence for every
@@ -67,6 +86,23 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
   // whether an injected touch needs to be stationary or not.
   // May be nil.
   GREYTouchInfo *_previousTouchInfo;
+  // The index of the point of |_previousTouchInfo| where the previous touch was injected.
+  NSUInteger _previousTouchPointIndex;
+  // Whether touches that aren't timing sensitive are injected without waiting for the timer.
+  BOOL _fastForwardEnabled;
+  // The timestamp, in seconds since system startup, of the touches injected last while
+  // fast-forwarding was enabled, or 0 if none has been injected yet. It may run ahead of the
+  // system uptime.
+  NSTimeInterval _lastFastForwardedTouchTimestamp;
+  // The system uptime at which the touches timestamped |_lastFastForwardedTouchTimestamp| were
+  // injected.
+  NSTimeInterval _lastFastForwardedTouchUptime;
+  // The HID events of the touches injected last, one per finger. Each is kept alive while the
+  // UITouch it was set on may still refer to it, i.e. until the finger's next touch is injected or
+  // touch injection stops. The buffer itself is reused for every injection.
+  IOHIDEventRef *_hidEvents;
+  // The number of fingers |_hidEvents| has room for.
+  NSUInteger _hidEventsCapacity;
 }
 
 - (instancetype)initWithWindow:(UIWindow *)window {
@@ -78,10 +114,16 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
     _enqueuedTouchInfoList = [[NSMutableArray alloc] init];
     _state = kGREYTouchInjectorPendingStart;
     _ongoingUITouches = [[NSMutableArray alloc] init];
+    _fastForwardEnabled = GREY_CONFIG_BOOL(kGREYConfigKeyTouchInjectionFastForwardEnabled);
   }
   return self;
 }
 
+- (void)dealloc {
+  [self grey_releaseHIDEvents];
+  free(_hidEvents);
+}
+
 - (void)enqueueTouchInfoForDelivery:(GREYTouchInfo *)touchInfo {
   GREYFatalAssertMainThread();
   [_enqueuedTouchInfoList addObject:touchInfo];
@@ -112,6 +154,7 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
   if (_state == kGREYTouchInjectorPendingStart || _state == kGREYTouchInjectorStopped) {
     [self startInjecting];
   }
+  [self grey_fastForwardTouches];
 
   // Now wait for it to finish.
   GREYRunLoopSpinner *runLoopSpinner = [[GREYRunLoopSpinner alloc] init];
@@ -128,8 +171,10 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
 - (void)timerFiredWithZeroToleranceTimer:(GREYZeroToleranceTimer *)timer {
   GREYFatalAssertMainThread();
 
+  NSUInteger pointIndex;
   GREYTouchInfo *touchInfo =
-      [self grey_dequeueTouchInfoForDeliveryWithCurrentTime:CACurrentMediaTime()];
+      [self grey_dequeueTouchInfoForDeliveryWithCurrentTime:CACurrentMediaTime()
+                                              outPointIndex:&pointIndex];
   if (!touchInfo) {
     if (_enqueuedTouchInfoList.count == 0) {
       // Queue is empty - we are done delivering touches.
@@ -137,18 +182,88 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
     }
     return;
   }
+  [self grey_deliverTouchInfo:touchInfo atPointIndex:pointIndex];
+  [self grey_fastForwardTouches];
+}
+
+
+#pragma mark - Private
+
+/**
+ *  Updates the ongoing UITouches to the phase and location of the touch at @c pointIndex of
+ *  @c touchInfo and injects them.
+ *
+ *  @param touchInfo  The info that is used to create the UITouch.
+ *  @param pointIndex The index of the touch paths' points where the touches are delivered.
+ */
+- (void)grey_deliverTouchInfo:(GREYTouchInfo *)touchInfo atPointIndex:(NSUInteger)pointIndex {
   if ([_ongoingUITouches count] == 0) {
-    [self grey_extractAndChangeTouchToStartPhase:touchInfo];
+    [self grey_extractAndChangeTouchToStartPhase:touchInfo atPointIndex:pointIndex];
   } else if (touchInfo.phase == GREYTouchInfoPhaseTouchEnded) {
     [self grey_changeTouchToEndPhase:touchInfo];
   } else {
-    [self grey_changeTouchToMovePhase:touchInfo];
+    [self grey_changeTouchToMovePhase:touchInfo atPointIndex:pointIndex];
+  }
+  [self grey_injectTouches:touchInfo atPointIndex:pointIndex];
+}
+
+/**
+ *  If fast-forwarding is enabled, delivers the touches at the front of the queue one after the
+ *  other, without waiting for the timer, until a touch that must be delivered in real time is
+ *  reached. Stops injecting if the queue runs empty.
+ */
+- (void)grey_fastForwardTouches {
+  if (!_fastForwardEnabled) {
+    return;
+  }
+  while (_state == kGREYTouchInjectorStarted) {
+    GREYTouchInfo *touchInfo = [_enqueuedTouchInfoList firstObject];
+    if (!touchInfo) {
+      [self grey_stopTouchInjection];
+      return;
+    }
+    if (![self grey_canFastForwardTouchInfo:touchInfo]) {
+      return;
+    }
+    NSUInteger pointIndex = touchInfo.pointRange.location + _dequeuedTouchesOfFirstTouchInfo;
+    [self grey_removeEnqueuedTouches:1];
+    [self grey_deliverTouchInfo:touchInfo atPointIndex:pointIndex];
   }
-  [self grey_injectTouches:touchInfo];
 }
 
+/**
+ *  @return @c YES if fast-forwarding is enabled and the touches of @c touchInfo aren't timing
+ *          sensitive, i.e. they aren't expendable and they were meant to be delivered no later
+ *          than the next tick of the timer. @c NO otherwise.
+ */
+- (BOOL)grey_canFastForwardTouchInfo:(GREYTouchInfo *)touchInfo {
+  return (_fastForwardEnabled &&
+          !touchInfo.isExpendable &&
+          touchInfo.deliveryTimeDeltaSinceLastTouch <= kGREYTouchInjectionInterval);
+}
 
-#pragma mark - Private
+/**
+ *  @return The timestamp, in seconds since system startup, for the touches about to be injected.
+ *          While fast-forwarding is enabled it is after the timestamp of the touches this injector
+ *          injected before by the time that has really passed since, but at least by one injection
+ *          interval, so that touches injected back to back still appear one timer tick apart and
+ *          touches delayed on purpose keep their delay.
+ */
+- (NSTimeInterval)grey_timestampForInjectedTouches {
+  NSTimeInterval uptime = [[NSProcessInfo processInfo] systemUptime];
+  if (!_fastForwardEnabled) {
+    return uptime;
+  }
+  NSTimeInterval timestamp = uptime;
+  if (_lastFastForwardedTouchTimestamp > 0) {
+    NSTimeInterval elapsedTime = uptime - _lastFastForwardedTouchUptime;
+    timestamp =
+        _lastFastForwardedTouchTimestamp + MAX(elapsedTime, kGREYTouchInjectionInterval);
+  }
+  _lastFastForwardedTouchTimestamp = timestamp;
+  _lastFastForwardedTouchUptime = uptime;
+  return timestamp;
+}
 
 /**
  *  Helper method to return UITouch object at @c index from the @c ongoingTouches array.
@@ -165,11 +280,13 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
  *  Extracts UITouches from @c touchInfo object and inserts those in the ongoingTouches array.
  *  Phase of UITouch is set to UITouchPhaseBegan.
  *
- *  @param touchInfo The info that is used to create the UITouch.
+ *  @param touchInfo  The info that is used to create the UITouch.
+ *  @param pointIndex The index of the touch paths' points where the touches begin.
  */
-- (void)grey_extractAndChangeTouchToStartPhase:(GREYTouchInfo *)touchInfo {
-  for (NSValue *touchPoint in touchInfo.points) {
-    CGPoint point = [touchPoint CGPointValue];
+- (void)grey_extractAndChangeTouchToStartPhase:(GREYTouchInfo *)touchInfo
+                                  atPointIndex:(NSUInteger)pointIndex {
+  for (NSUInteger i = 0; i < [touchInfo.touchPaths count]; i++) {
+    CGPoint point = [touchInfo pointForFinger:i atIndex:pointIndex];
     UITouch *touch = [[UITouch alloc] initAtPoint:point relativeToWindow:_window];
     [touch setPhase:UITouchPhaseBegan];
     [_ongoingUITouches addObject:touch];
@@ -182,9 +299,9 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
  *  @param touchInfo The info that is used to create the UITouch.
  */
 - (void)grey_changeTouchToEndPhase:(GREYTouchInfo *)touchInfo {
-  for (NSUInteger i = 0; i < [touchInfo.points count]; i++) {
+  for (NSUInteger i = 0; i < [touchInfo.touchPaths count]; i++) {
     UITouch *touch = [self grey_UITouchForFinger:i];
-    CGPoint touchPoint = [[_previousTouchInfo.points objectAtIndex:i] CGPointValue];
+    CGPoint touchPoint = [_previousTouchInfo pointForFinger:i atIndex:_previousTouchPointIndex];
     [touch _setLocationInWindow:touchPoint resetPrevious:NO];
     [touch setPhase:UITouchPhaseEnded];
   }
@@ -194,14 +311,17 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
  *  Phase of UITouches is set to UITouchPhaseMoved and currentTouchLocation is set to the
  *  current touch point.
  *
- *  @param touchInfo The info that is used to create the UITouch.
+ *  @param touchInfo  The info that is used to create the UITouch.
+ *  @param pointIndex The index of the touch paths' points where the touches move to.
  */
-- (void)grey_changeTouchToMovePhase:(GREYTouchInfo *)touchInfo {
-  for (NSUInteger i = 0; i < [touchInfo.points count]; i++) {
-    CGPoint touchPoint = [[touchInfo.points objectAtIndex:i] CGPointValue];
+- (void)grey_changeTouchToMovePhase:(GREYTouchInfo *)touchInfo
+                       atPointIndex:(NSUInteger)pointIndex {
+  for (NSUInteger i = 0; i < [touchInfo.touchPaths count]; i++) {
+    CGPoint touchPoint = [touchInfo pointForFinger:i atIndex:pointIndex];
     UITouch *touch = [self grey_UITouchForFinger:i];
     [touch _setLocationInWindow:touchPoint resetPrevious:NO];
-    CGPoint previousTouchPoint = [[_previousTouchInfo.points objectAtIndex:i] CGPointValue];
+    CGPoint previousTouchPoint =
+        [_previousTouchInfo pointForFinger:i atIndex:_previousTouchPointIndex];
     if (CGPointEqualToPoint(previousTouchPoint, touchPoint)) {
       [touch setPhase:UITouchPhaseStationary];
     } else {
@@ -213,17 +333,19 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
 /**
  *  Inject touches to the application.
  *
- *  @param touchInfo The info that is used to create the UITouch.
+ *  @param touchInfo  The info that is used to create the UITouch.
+ *  @param pointIndex The index of the touch paths' points where the touches are injected.
  */
-- (void)grey_injectTouches:(GREYTouchInfo *)touchInfo {
+- (void)grey_injectTouches:(GREYTouchInfo *)touchInfo atPointIndex:(NSUInteger)pointIndex {
   UITouchesEvent *event = [[UIApplication sharedApplication] _touchesEvent];
   // Clean up before injecting touches.
   [event _clearTouches];
 
-  // Array to store all hidEvent references to be released later.
-  NSMutableArray *hidEvents = [NSMutableArray arrayWithCapacity:[_ongoingUITouches count]];
+  [self grey_reserveHIDEventsForFingers:[_ongoingUITouches count]];
 
-  uint64_t machAbsoluteTime = mach_absolute_time();
+  NSTimeInterval touchTimestamp = [self grey_timestampForInjectedTouches];
+  uint64_t machAbsoluteTime = _fastForwardEnabled ? GREYMachAbsoluteTimeFromUptime(touchTimestamp)
+                                                  : mach_absolute_time();
   AbsoluteTime timeStamp;
   timeStamp.hi = (UInt32)(machAbsoluteTime >> 32);
   timeStamp.lo = (UInt32)(machAbsoluteTime);
@@ -234,7 +356,7 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
     if (i == 0) {
       currentTouchView = currentTouch.view;
     }
-    [currentTouch setTimestamp:[[NSProcessInfo processInfo] systemUptime]];
+    [currentTouch setTimestamp:touchTimestamp];
 
     IOHIDDigitizerEventMask eventMask = (currentTouch.phase == UITouchPhaseMoved)
         ? kIOHIDDigitizerEventPosition
@@ -258,19 +380,24 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
                                                                   isRangeAndTouch,
                                                                   0);
 
-    [hidEvents addObject:[NSValue valueWithPointer:hidEvent]];
-
+    // The finger's previous HID event is released only once its touch refers to the new one.
+    IOHIDEventRef previousHIDEvent = _hidEvents[i];
+    _hidEvents[i] = hidEvent;
     if ([currentTouch respondsToSelector:@selector(_setHidEvent:)]) {
       [currentTouch _setHidEvent:hidEvent];
     }
+    if (previousHIDEvent) {
+      CFRelease(previousHIDEvent);
+    }
     [event _addTouch:currentTouch forDelayedDelivery:NO];
   }
-  [event _setHIDEvent:[[hidEvents objectAtIndex:0] pointerValue]];
+  [event _setHIDEvent:_hidEvents[0]];
   // iOS adds an autorelease pool around every event-based interaction.
   // We should mimic that if we want to relinquish bits in a timely manner.
   @autoreleasepool {
     _previousTouchDeliveryTime = CACurrentMediaTime();
     _previousTouchInfo = touchInfo;
+    _previousTouchPointIndex = pointIndex;
     BOOL touchViewContainsWKWebView = NO;
 
     @try {
@@ -308,12 +435,6 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
       if (!touchViewContainsWKWebView) {
         [event _clearTouches];
       }
-      // We need to release the event manually, otherwise it will leak.
-      for (NSValue *hidEventValue in hidEvents) {
-        IOHIDEventRef hidEvent = [hidEventValue pointerValue];
-        CFRelease(hidEvent);
-      }
-      [hidEvents removeAllObjects];
       if (touchInfo.phase == GREYTouchInfoPhaseTouchEnded) {
         [_ongoingUITouches removeAllObjects];
       }
@@ -322,44 +443,129 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
 }
 
 /**
- *  Stops touch injection by invalidating the current timer and clearing the touch info list.
+ *  Stops touch injection by invalidating the current timer, clearing the touch info list and
+ *  releasing the HID events of the touches injected last.
  */
 - (void)grey_stopTouchInjection {
   _state = kGREYTouchInjectorStopped;
   [_timer invalidate];
   _timer = nil;
   [_enqueuedTouchInfoList removeAllObjects];
+  _dequeuedTouchesOfFirstTouchInfo = 0;
+  [self grey_releaseHIDEvents];
+}
+
+/**
+ *  Grows @c _hidEvents, if needed, to have room for the HID events of @c fingerCount fingers.
+ *
+ *  @param fingerCount The number of fingers whose touches are about to be injected.
+ */
+- (void)grey_reserveHIDEventsForFingers:(NSUInteger)fingerCount {
+  if (fingerCount <= _hidEventsCapacity) {
+    return;
+  }
+  IOHIDEventRef *hidEvents = realloc(_hidEvents, fingerCount * sizeof(IOHIDEventRef));
+  GREYFatalAssertWithMessage(hidEvents, @"Failed to allocate HID events for %lu fingers.",
+                             (unsigned long)fingerCount);
+  memset(hidEvents + _hidEventsCapacity, 0,
+         (fingerCount - _hidEventsCapacity) * sizeof(IOHIDEventRef));
+  _hidEvents = hidEvents;
+  _hidEventsCapacity = fingerCount;
+}
+
+/**
+ *  Releases the HID events of the touches injected last. Their buffer is kept for reuse.
+ */
+- (void)grey_releaseHIDEvents {
+  for (NSUInteger i = 0; i < _hidEventsCapacity; i++) {
+    if (_hidEvents[i]) {
+      CFRelease(_hidEvents[i]);
+      _hidEvents[i] = NULL;
+    }
+  }
+}
+
+/**
+ *  @return The number of HID events currently retained by the injector.
+ */
+- (NSUInteger)grey_retainedHIDEventCount {
+  NSUInteger count = 0;
+  for (NSUInteger i = 0; i < _hidEventsCapacity; i++) {
+    if (_hidEvents[i]) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ *  Removes the given number of touches from the front of the queue, dropping every touch info
+ *  whose touches have all been removed.
+ *
+ *  @param touchCount The number of touches to remove.
+ */
+- (void)grey_removeEnqueuedTouches:(NSUInteger)touchCount {
+  while (touchCount > 0) {
+    GREYTouchInfo *touchInfo = [_enqueuedTouchInfoList firstObject];
+    NSUInteger pendingTouches = touchInfo.pointRange.length - _dequeuedTouchesOfFirstTouchInfo;
+    if (touchCount < pendingTouches) {
+      _dequeuedTouchesOfFirstTouchInfo += touchCount;
+      return;
+    }
+    [_enqueuedTouchInfoList removeObjectAtIndex:0];
+    _dequeuedTouchesOfFirstTouchInfo = 0;
+    touchCount -= pendingTouches;
+  }
 }
 
 /**
  *  Dequeues the next touch to be delivered based on @c currentTime.
  *
- *  @param currentTime The time for the next touch to be dequeued.
+ *  @param      currentTime      The time for the next touch to be dequeued.
+ *  @param[out] pointIndexOrNull The index of the touch paths' points where the dequeued touch
+ *                               is to be delivered.
  *
  *  @return The touch info for the next touch. If a touch could not be dequeued
  *          (which can happen if queue is empty or if we attempt to dequeue too early)
  *          @c nil is returned.
  */
-- (GREYTouchInfo *)grey_dequeueTouchInfoForDeliveryWithCurrentTime:(CFTimeInterval)currentTime {
+- (GREYTouchInfo *)grey_dequeueTouchInfoForDeliveryWithCurrentTime:(CFTimeInterval)currentTime
+                                                     outPointIndex:(NSUInteger *)pointIndexOrNull {
   if (_enqueuedTouchInfoList.count == 0) {
     return nil;
   }
-  // Count the number of stale touches.
+  // Count the number of stale touches. The delivery time of every touch of a touch info is computed
+  // from its delta, so that runs of expendable touches are skipped without visiting each of them.
   NSUInteger staleTouches = 0;
+  NSUInteger dequeuedTouches = _dequeuedTouchesOfFirstTouchInfo;
   CFTimeInterval simulatedPreviousDeliveryTime = _previousTouchDeliveryTime;
   for (GREYTouchInfo *touchInfo in _enqueuedTouchInfoList) {
-    simulatedPreviousDeliveryTime += touchInfo.deliveryTimeDeltaSinceLastTouch;
-    if (touchInfo.isExpendable &&
-        simulatedPreviousDeliveryTime < currentTime) {
-      staleTouches++;
+    if (!touchInfo.isExpendable) {
+      break;
+    }
+    NSUInteger pendingTouches = touchInfo.pointRange.length - dequeuedTouches;
+    dequeuedTouches = 0;
+    // The k-th pending touch is stale if simulatedPreviousDeliveryTime + k * delta < currentTime.
+    NSTimeInterval delta = touchInfo.deliveryTimeDeltaSinceLastTouch;
+    NSUInteger staleTouchesOfTouchInfo = 0;
+    if (delta <= 0) {
+      staleTouchesOfTouchInfo = (simulatedPreviousDeliveryTime < currentTime) ? pendingTouches : 0;
     } else {
+      double lastStaleTouch = ceil((currentTime - simulatedPreviousDeliveryTime) / delta) - 1;
+      if (lastStaleTouch > 0) {
+        staleTouchesOfTouchInfo = (NSUInteger)MIN(lastStaleTouch, (double)pendingTouches);
+      }
+    }
+    staleTouches += staleTouchesOfTouchInfo;
+    simulatedPreviousDeliveryTime += staleTouchesOfTouchInfo * delta;
+    if (staleTouchesOfTouchInfo < pendingTouches) {
       break;
     }
   }
 
   // Remove all but the last stale touch if any.
   NSUInteger touchesToRemove = (staleTouches > 1) ? (staleTouches - 1) : 0;
-  [_enqueuedTouchInfoList removeObjectsInRange:NSMakeRange(0, touchesToRemove)];
+  [self grey_removeEnqueuedTouches:touchesToRemove];
   GREYTouchInfo *dequeuedTouchInfo = [_enqueuedTouchInfoList firstObject];
 
   CFTimeInterval expectedTouchDeliveryTime =
@@ -368,7 +574,10 @@ static const NSTimeInterval kGREYMaxIntervalForUIWebViewResponse = 2.0;
     // This touch is scheduled to be delivered in the future.
     return nil;
   }
-  [_enqueuedTouchInfoList removeObjectAtIndex:0];
+  if (pointIndexOrNull) {
+    *pointIndexOrNull = dequeuedTouchInfo.pointRange.location + _dequeuedTouchesOfFirstTouchInfo;
+  }
+  [self grey_removeEnqueuedTouches:1];
   return dequeuedTouchInfo;
 }
 
@@ -0,0 +1,85 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  A path of touch points stored in a single contiguous @c CGPoint buffer, used to generate and
+ *  inject gestures without creating an object for every point along the path.
+ */
+@interface GREYTouchPath : NSObject
+
+/**
+ *  The number of points in the path.
+ */
+@property(nonatomic, readonly) NSUInteger count;
+
+/**
+ *  The contiguous buffer holding the points of the path. It is only valid until the path is
+ *  mutated or deallocated.
+ */
+@property(nonatomic, readonly) const CGPoint *points NS_RETURNS_INNER_POINTER;
+
+/**
+ *  The first point of the path. The path must not be empty.
+ */
+@property(nonatomic, readonly) CGPoint firstPoint;
+
+/**
+ *  The last point of the path. The path must not be empty.
+ */
+@property(nonatomic, readonly) CGPoint lastPoint;
+
+/**
+ *  @return A touch path made of the single given @c point.
+ */
++ (instancetype)touchPathWithPoint:(CGPoint)point;
+
+/**
+ *  @param pointValues An array of @c NSValue objects wrapping @c CGPoints.
+ *
+ *  @return A touch path made of the points wrapped by @c pointValues, in the same order.
+ */
++ (instancetype)touchPathWithPointValues:(NSArray<NSValue *> *)pointValues;
+
+/**
+ *  Initializes an empty touch path with room for @c capacity points before the buffer has to grow.
+ *
+ *  @param capacity The number of points expected to be appended to the path.
+ *
+ *  @return An empty touch path.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Appends @c point to the end of the path.
+ *
+ *  @param point The point to append.
+ */
+- (void)appendPoint:(CGPoint)point;
+
+/**
+ *  @param index The index of the point, must be less than GREYTouchPath::count.
+ *
+ *  @return The point at @c index of the path.
+ */
+- (CGPoint)pointAtIndex:(NSUInteger)index;
+
+@end
+
+NS_ASSUME_NONNULL_END
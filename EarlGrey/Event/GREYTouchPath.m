@@ -0,0 +1,112 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import "Event/GREYTouchPath.h"
+
+#import "Common/GREYFatalAsserts.h"
+
+/**
+ *  The smallest number of points a touch path has room for once its buffer had to grow. Touch paths
+ *  start with room for at least one point.
+ */
+static const NSUInteger kGREYTouchPathMinimumCapacity = 4;
+
+@implementation GREYTouchPath {
+  /**
+   *  The buffer holding the points of the path, with room for @c _capacity points.
+   */
+  CGPoint *_points;
+  /**
+   *  The number of points that fit in @c _points.
+   */
+  NSUInteger _capacity;
+}
+
++ (instancetype)touchPathWithPoint:(CGPoint)point {
+  GREYTouchPath *touchPath = [[self alloc] initWithCapacity:1];
+  [touchPath appendPoint:point];
+  return touchPath;
+}
+
++ (instancetype)touchPathWithPointValues:(NSArray<NSValue *> *)pointValues {
+  GREYTouchPath *touchPath = [[self alloc] initWithCapacity:pointValues.count];
+  for (NSValue *pointValue in pointValues) {
+    [touchPath appendPoint:[pointValue CGPointValue]];
+  }
+  return touchPath;
+}
+
+- (instancetype)init {
+  return [self initWithCapacity:0];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+  self = [super init];
+  if (self) {
+    _capacity = MAX(capacity, 1u);
+    _points = malloc(_capacity * sizeof(CGPoint));
+    GREYFatalAssertWithMessage(_points, @"Failed to allocate a touch path of %lu points.",
+                               (unsigned long)_capacity);
+  }
+  return self;
+}
+
+- (void)dealloc {
+  free(_points);
+}
+
+- (const CGPoint *)points {
+  return _points;
+}
+
+- (CGPoint)firstPoint {
+  return [self pointAtIndex:0];
+}
+
+- (CGPoint)lastPoint {
+  GREYFatalAssertWithMessage(_count > 0, @"Touch path is empty.");
+  return _points[_count - 1];
+}
+
+- (void)appendPoint:(CGPoint)point {
+  if (_count == _capacity) {
+    NSUInteger capacity = MAX(_capacity * 2, kGREYTouchPathMinimumCapacity);
+    CGPoint *points = realloc(_points, capacity * sizeof(CGPoint));
+    GREYFatalAssertWithMessage(points, @"Failed to grow a touch path to %lu points.",
+                               (unsigned long)capacity);
+    _points = points;
+    _capacity = capacity;
+  }
+  _points[_count++] = point;
+}
+
+- (CGPoint)pointAtIndex:(NSUInteger)index {
+  GREYFatalAssertWithMessage(index < _count, @"Index %lu is beyond the touch path of %lu points.",
+                             (unsigned long)index, (unsigned long)_count);
+  return _points[index];
+}
+
+- (NSString *)description {
+  NSMutableString *description =
+      [NSMutableString stringWithFormat:@"<%@: %p; points = (", [self class], self];
+  for (NSUInteger i = 0; i < _count; i++) {
+    [description appendFormat:@"%@%@", (i == 0 ? @"" : @", "), NSStringFromCGPoint(_points[i])];
+  }
+  [description appendString:@")>"];
+  return description;
+}
+
+@end
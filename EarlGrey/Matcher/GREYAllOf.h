@@ -23,9 +23,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 /**
  *  A matcher for combining multiple matchers with a logical @c AND operator, so that a match
- *  only occurs when all combined matchers match the element. The invocation of the matchers
- *  is in the same order in which they are passed. As soon as one matcher fails, the
- *  rest of the matchers are not invoked.
+ *  only occurs when all combined matchers match the element. Matchers that are cheap to evaluate,
+ *  such as property matchers, are invoked before expensive ones, such as the visibility matchers.
+ *  Otherwise, the invocation of the matchers is in the same order in which they are passed. As soon
+ *  as one matcher fails, the rest of the matchers are not invoked.
  */
 @interface GREYAllOf : GREYBaseMatcher
 
@@ -53,9 +54,9 @@ NS_ASSUME_NONNULL_BEGIN
  *  @param first      The first matcher in the list of matchers.
  *  @param second     The second matcher in the list of matchers.
  *  @param thirdOrNil The third matcher in the list of matchers, optionally the nil terminator.
- *  @param ...        Any more matchers to be added. Matchers are invoked in the order they are
- *                    specified and only if the preceding matcher passes. This va-arg must be
- *                    terminated with a @c nil value.
+ *  @param ...        Any more matchers to be added. Matchers of the same cost are invoked in the
+ *                    order they are specified and only if the preceding matcher passes. This
+ *                    va-arg must be terminated with a @c nil value.
  *
  *  @return An object conforming to GREYMatcher, initialized with the required matchers.
  */
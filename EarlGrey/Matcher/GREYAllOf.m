@@ -17,11 +17,14 @@
 #import "Matcher/GREYAllOf.h"
 
 #import "Common/GREYThrowDefines.h"
+#import "Core/GREYElementIndex.h"
 #import "Matcher/GREYDescription.h"
-#import "Matcher/GREYStringDescription.h"
+#import "Matcher/GREYMatcherCost.h"
 
 @implementation GREYAllOf {
   NSArray *_matchers;
+  // The matchers in the order they are evaluated by GREYAllOf::matches:, cheapest first.
+  NSArray *_evaluationOrder;
 }
 
 - (instancetype)initWithMatchers:(NSArray *)matchers {
@@ -30,6 +33,26 @@
   self = [super init];
   if (self) {
     _matchers = matchers;
+    _evaluationOrder = GREYMatchersSortedByCost(matchers);
+    // Every matcher is evaluated for elements that match, so this matcher is as expensive as the
+    // most expensive one.
+    GREYMatcherSetCost(self, GREYMatchersMaximumCost(matchers));
+    // Visibility is required if it is required by any of the matchers.
+    for (id<GREYMatcher> matcher in matchers) {
+      if (GREYMatcherRequiresVisibility(matcher)) {
+        GREYMatcherSetRequiresVisibility(self, YES);
+        break;
+      }
+    }
+    // All matchers must match, so an accessibility identifier required by one of them is required
+    // by this matcher too.
+    for (id<GREYMatcher> matcher in matchers) {
+      NSString *accessibilityID = [GREYElementIndex accessibilityIDRequiredByMatcher:matcher];
+      if (accessibilityID) {
+        [GREYElementIndex setAccessibilityID:accessibilityID requiredByMatcher:self];
+        break;
+      }
+    }
   }
   return self;
 }
@@ -37,10 +60,17 @@
 #pragma mark - GREYMatcher
 
 - (BOOL)matches:(id)item {
-  return [self matches:item describingMismatchTo:[[GREYStringDescription alloc] init]];
+  for (id matcher in _evaluationOrder) {
+    if (![matcher matches:item]) {
+      return NO;
+    }
+  }
+  return YES;
 }
 
 - (BOOL)matches:(id)item describingMismatchTo:(id<GREYDescription>)mismatchDescription {
+  // Matchers are evaluated in the order they were provided in so that the mismatch is described by
+  // the same matcher regardless of their cost.
   for (id matcher in _matchers) {
     if (![matcher matches:item describingMismatchTo:mismatchDescription]) {
       return NO;
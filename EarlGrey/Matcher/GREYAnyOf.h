@@ -23,9 +23,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 /**
  *  Matcher for combining multiple matchers with a logical @c OR operator, so that a match occurs
- *  when any of the matchers match the element. The invocation of the matchers is in the same
- *  order in which they are passed. As soon as one of the matchers succeeds, the rest are
- *  not invoked.
+ *  when any of the matchers match the element. Matchers that are cheap to evaluate, such as
+ *  property matchers, are invoked before expensive ones, such as the visibility matchers.
+ *  Otherwise, the invocation of the matchers is in the same order in which they are passed. As soon
+ *  as one of the matchers succeeds, the rest are not invoked.
  */
 @interface GREYAnyOf : GREYBaseMatcher
 
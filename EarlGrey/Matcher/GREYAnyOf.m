@@ -17,10 +17,13 @@
 #import "Matcher/GREYAnyOf.h"
 
 #import "Common/GREYThrowDefines.h"
+#import "Matcher/GREYMatcherCost.h"
 #import "Matcher/GREYStringDescription.h"
 
 @implementation GREYAnyOf {
   NSArray *_matchers;
+  // The matchers in the order they are evaluated by GREYAnyOf::matches:, cheapest first.
+  NSArray *_evaluationOrder;
 }
 
 - (instancetype)initWithMatchers:(NSArray *)matchers {
@@ -29,6 +32,16 @@
   self = [super init];
   if (self) {
     _matchers = matchers;
+    _evaluationOrder = GREYMatchersSortedByCost(matchers);
+    // Every matcher is evaluated for elements that do not match, so this matcher is as expensive as
+    // the most expensive one.
+    GREYMatcherSetCost(self, GREYMatchersMaximumCost(matchers));
+    // Visibility is only required if it is required by every alternative.
+    BOOL requiresVisibility = YES;
+    for (id<GREYMatcher> matcher in matchers) {
+      requiresVisibility = requiresVisibility && GREYMatcherRequiresVisibility(matcher);
+    }
+    GREYMatcherSetRequiresVisibility(self, requiresVisibility);
   }
   return self;
 }
@@ -36,7 +49,12 @@
 #pragma mark - GREYMatcher
 
 - (BOOL)matches:(id)item {
-  return [self matches:item describingMismatchTo:[[GREYStringDescription alloc] init]];
+  for (id matcher in _evaluationOrder) {
+    if ([matcher matches:item]) {
+      return YES;
+    }
+  }
+  return NO;
 }
 
 - (BOOL)matches:(id)item describingMismatchTo:(id<GREYDescription>)mismatchDescription {
@@ -0,0 +1,65 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Memoizes the results of matchers that walk the UI hierarchy, such as
+ *  GREYMatchers::matcherForAncestor: and GREYMatchers::matcherForDescendant:, for the duration of a
+ *  single element search. The hierarchy doesn't change while it is being searched, so the result
+ *  computed for an element while evaluating one candidate can be reused for all other candidates.
+ *
+ *  Results are stored per query, which is an object identifying the matcher whose results are being
+ *  memoized. Elements and queries are compared by pointer and retained until the search is over.
+ */
+@interface GREYHierarchyMatchCache : NSObject
+
+/**
+ *  @return The cache of the search being performed on the main thread, or @c nil if no search is
+ *          in progress or if called from any other thread.
+ */
++ (instancetype _Nullable)currentCache;
+
+/**
+ *  Invokes @c block with a new cache set as the current cache. The previous cache is restored when
+ *  @c block returns, which allows searches to be nested.
+ *
+ *  @param block The block performing the search.
+ */
++ (void)performBlockWithNewCache:(void (^)(void))block;
+
+/**
+ *  @param query   The object identifying the memoized matcher.
+ *  @param element The element the result was computed for.
+ *
+ *  @return The memoized result as a boolean NSNumber, or @c nil if there is none.
+ */
+- (NSNumber *_Nullable)resultOfQuery:(id)query forElement:(id)element;
+
+/**
+ *  Memoizes the @c result of @c query for @c element.
+ *
+ *  @param result  The result to be memoized.
+ *  @param query   The object identifying the memoized matcher.
+ *  @param element The element the result was computed for.
+ */
+- (void)setResult:(BOOL)result ofQuery:(id)query forElement:(id)element;
+
+@end
+
+NS_ASSUME_NONNULL_END
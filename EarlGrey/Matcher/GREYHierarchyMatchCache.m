@@ -0,0 +1,83 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import "Matcher/GREYHierarchyMatchCache.h"
+
+#import "Common/GREYFatalAsserts.h"
+
+/**
+ *  The cache of the search in progress on the main thread.
+ */
+static GREYHierarchyMatchCache *gCurrentCache;
+
+@implementation GREYHierarchyMatchCache {
+  /**
+   *  A map from queries to maps from elements to the memoized results.
+   */
+  NSMapTable<id, NSMapTable<id, NSNumber *> *> *_resultsByQuery;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _resultsByQuery = [self grey_newMapTable];
+  }
+  return self;
+}
+
++ (instancetype)currentCache {
+  return [NSThread isMainThread] ? gCurrentCache : nil;
+}
+
++ (void)performBlockWithNewCache:(void (^)(void))block {
+  GREYFatalAssertMainThread();
+
+  GREYHierarchyMatchCache *previousCache = gCurrentCache;
+  gCurrentCache = [[GREYHierarchyMatchCache alloc] init];
+  @try {
+    block();
+  } @finally {
+    gCurrentCache = previousCache;
+  }
+}
+
+- (NSNumber *)resultOfQuery:(id)query forElement:(id)element {
+  return [[_resultsByQuery objectForKey:query] objectForKey:element];
+}
+
+- (void)setResult:(BOOL)result ofQuery:(id)query forElement:(id)element {
+  NSMapTable *results = [_resultsByQuery objectForKey:query];
+  if (!results) {
+    results = [self grey_newMapTable];
+    [_resultsByQuery setObject:results forKey:query];
+  }
+  [results setObject:@(result) forKey:element];
+}
+
+#pragma mark - Private
+
+/**
+ *  @return A new map table that compares its keys by pointer, since elements can override
+ *          NSObject::isEqual:.
+ */
+- (NSMapTable *)grey_newMapTable {
+  return [[NSMapTable alloc] initWithKeyOptions:(NSPointerFunctionsStrongMemory |
+                                                 NSPointerFunctionsObjectPointerPersonality)
+                                   valueOptions:NSPointerFunctionsStrongMemory
+                                       capacity:0];
+}
+
+@end
@@ -0,0 +1,92 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+@protocol GREYMatcher;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  The relative cost of evaluating a matcher against a single element. GREYAllOf and GREYAnyOf
+ *  evaluate their matchers from the cheapest to the most expensive class so that cheap matchers can
+ *  short-circuit the expensive ones. Matchers of the same class are evaluated in the order they
+ *  were provided in.
+ */
+typedef NS_ENUM(NSInteger, GREYMatcherCost) {
+  /**
+   *  The matcher reads properties of the element. This is the cost of every matcher that is not
+   *  explicitly assigned one.
+   */
+  kGREYMatcherCostProperty = 0,
+  /**
+   *  The matcher computes geometry or queries state that is not held by the element.
+   */
+  kGREYMatcherCostStructural,
+  /**
+   *  The matcher walks the ancestors or descendants of the element, or searches the UI hierarchy.
+   */
+  kGREYMatcherCostHierarchyWalk,
+  /**
+   *  The matcher renders the element, such as the visibility matchers.
+   */
+  kGREYMatcherCostPixelRender,
+};
+
+/**
+ *  @return The cost class assigned to @c matcher, or @c kGREYMatcherCostProperty if it has none.
+ */
+GREYMatcherCost GREYMatcherCostOf(id<GREYMatcher> matcher);
+
+/**
+ *  Assigns a cost class to @c matcher.
+ *
+ *  @param matcher The matcher whose cost class is being set.
+ *  @param cost    The cost of evaluating @c matcher against a single element.
+ *
+ *  @return The provided @c matcher.
+ */
+id<GREYMatcher> GREYMatcherSetCost(id<GREYMatcher> matcher, GREYMatcherCost cost);
+
+/**
+ *  @return The matchers in @c matchers sorted by cost class, cheapest first. The order of matchers
+ *          of the same cost class is preserved.
+ */
+NSArray *GREYMatchersSortedByCost(NSArray *matchers);
+
+/**
+ *  @return The highest cost class of the matchers in @c matchers.
+ */
+GREYMatcherCost GREYMatchersMaximumCost(NSArray *matchers);
+
+/**
+ *  @return @c YES if @c matcher has been marked as only accepting elements that are at least
+ *          partially visible on screen, @c NO otherwise.
+ */
+BOOL GREYMatcherRequiresVisibility(id<GREYMatcher> matcher);
+
+/**
+ *  Marks whether @c matcher only accepts elements that are at least partially visible on screen.
+ *  Searches with such a matcher can skip the descendants of views that can't be visible.
+ *
+ *  @param matcher            The matcher being marked.
+ *  @param requiresVisibility Whether @c matcher only accepts visible elements.
+ *
+ *  @return The provided @c matcher.
+ */
+id<GREYMatcher> GREYMatcherSetRequiresVisibility(id<GREYMatcher> matcher, BOOL requiresVisibility);
+
+NS_ASSUME_NONNULL_END
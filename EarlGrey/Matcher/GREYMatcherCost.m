@@ -0,0 +1,87 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import "Matcher/GREYMatcherCost.h"
+
+#import <objc/runtime.h>
+
+#import "Matcher/GREYMatcher.h"
+
+GREYMatcherCost GREYMatcherCostOf(id<GREYMatcher> matcher) {
+  NSNumber *cost = objc_getAssociatedObject(matcher, @selector(GREYMatcherCostOf));
+  if (!cost) {
+    return kGREYMatcherCostProperty;
+  }
+  return (GREYMatcherCost)MIN(MAX(cost.integerValue, kGREYMatcherCostProperty),
+                              kGREYMatcherCostPixelRender);
+}
+
+id<GREYMatcher> GREYMatcherSetCost(id<GREYMatcher> matcher, GREYMatcherCost cost) {
+  objc_setAssociatedObject(matcher,
+                           @selector(GREYMatcherCostOf),
+                           @(cost),
+                           OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+  return matcher;
+}
+
+NSArray *GREYMatchersSortedByCost(NSArray *matchers) {
+  NSUInteger count = matchers.count;
+  if (count < 2) {
+    return matchers;
+  }
+  GREYMatcherCost costs[count];
+  BOOL sorted = YES;
+  for (NSUInteger i = 0; i < count; i++) {
+    costs[i] = GREYMatcherCostOf(matchers[i]);
+    if (i > 0 && costs[i] < costs[i - 1]) {
+      sorted = NO;
+    }
+  }
+  if (sorted) {
+    return matchers;
+  }
+  // Bucket the matchers by cost class, which keeps the sort stable.
+  NSMutableArray *sortedMatchers = [[NSMutableArray alloc] initWithCapacity:count];
+  for (GREYMatcherCost cost = kGREYMatcherCostProperty; cost <= kGREYMatcherCostPixelRender;
+       cost++) {
+    for (NSUInteger i = 0; i < count; i++) {
+      if (costs[i] == cost) {
+        [sortedMatchers addObject:matchers[i]];
+      }
+    }
+  }
+  return sortedMatchers;
+}
+
+GREYMatcherCost GREYMatchersMaximumCost(NSArray *matchers) {
+  GREYMatcherCost maximumCost = kGREYMatcherCostProperty;
+  for (id<GREYMatcher> matcher in matchers) {
+    maximumCost = MAX(maximumCost, GREYMatcherCostOf(matcher));
+  }
+  return maximumCost;
+}
+
+BOOL GREYMatcherRequiresVisibility(id<GREYMatcher> matcher) {
+  return [objc_getAssociatedObject(matcher, @selector(GREYMatcherRequiresVisibility)) boolValue];
+}
+
+id<GREYMatcher> GREYMatcherSetRequiresVisibility(id<GREYMatcher> matcher, BOOL requiresVisibility) {
+  objc_setAssociatedObject(matcher,
+                           @selector(GREYMatcherRequiresVisibility),
+                           requiresVisibility ? @YES : nil,
+                           OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+  return matcher;
+}
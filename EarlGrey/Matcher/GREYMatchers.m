@@ -33,6 +33,7 @@
 #import "Common/GREYThrowDefines.h"
 #import "Common/GREYVisibilityChecker.h"
 #import "Core/GREYElementFinder.h"
+#import "Core/GREYElementIndex.h"
 #import "Core/GREYElementInteraction.h"
 #import "Core/GREYElementInteraction+Internal.h"
 #import "Matcher/GREYAllOf.h"
@@ -40,10 +41,13 @@
 #import "Matcher/GREYElementMatcherBlock.h"
 #import "Matcher/GREYLayoutConstraint.h"
 #import "Matcher/GREYHCMatcher.h"
+#import "Matcher/GREYHierarchyMatchCache.h"
 #import "Matcher/GREYMatcher.h"
+#import "Matcher/GREYMatcherCost.h"
 #import "Matcher/GREYNot.h"
 #import "Provider/GREYElementProvider.h"
 #import "Provider/GREYUIWindowProvider.h"
+#import "Traversal/GREYTraversal.h"
 
 // The minimum percentage of an element's accessibility frame that must be visible before EarlGrey
 // considers the element to be sufficiently visible.
@@ -112,10 +116,16 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
     [description appendText:[NSString stringWithFormat:@"accessibilityID('%@')",
                                                        accessibilityID]];
   };
-  return grey_allOf(grey_respondsToSelector(@selector(accessibilityIdentifier)),
-                    [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
-                                                         descriptionBlock:describe],
-                    nil);
+  id<GREYMatcher> matcher =
+      grey_allOf(grey_respondsToSelector(@selector(accessibilityIdentifier)),
+                 [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
+                                                      descriptionBlock:describe],
+                 nil);
+  // Allow elements matched by this matcher to be looked up by their identifier.
+  if (accessibilityID) {
+    [GREYElementIndex setAccessibilityID:accessibilityID requiredByMatcher:matcher];
+  }
+  return matcher;
 }
 
 + (id<GREYMatcher>)matcherForAccessibilityValue:(NSString *)value {
@@ -217,7 +227,9 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
   DescribeToBlock describe = ^void(id<GREYDescription> description) {
     [description appendText:@"isSystemAlertViewShown"];
   };
-  return [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches descriptionBlock:describe];
+  id<GREYMatcher> matcher = [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
+                                                                 descriptionBlock:describe];
+  return GREYMatcherSetCost(matcher, kGREYMatcherCostStructural);
 }
 
 + (id<GREYMatcher>)matcherForMinimumVisiblePercent:(CGFloat)percent {
@@ -230,7 +242,10 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
     [description appendText:
         [NSString stringWithFormat:@"matcherForMinimumVisiblePercent(>=%f)", percent]];
   };
-  return [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches descriptionBlock:describe];
+  id<GREYMatcher> matcher = [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
+                                                                 descriptionBlock:describe];
+  GREYMatcherSetCost(matcher, kGREYMatcherCostPixelRender);
+  return GREYMatcherSetRequiresVisibility(matcher, YES);
 }
 
 + (id<GREYMatcher>)matcherForSufficientlyVisible {
@@ -243,7 +258,10 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
         [NSString stringWithFormat:@"matcherForSufficientlyVisible(>=%f)",
                                    kElementSufficientlyVisiblePercentage]];
   };
-  return [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches descriptionBlock:describe];
+  id<GREYMatcher> matcher = [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
+                                                                 descriptionBlock:describe];
+  GREYMatcherSetCost(matcher, kGREYMatcherCostPixelRender);
+  return GREYMatcherSetRequiresVisibility(matcher, YES);
 }
 
 + (id<GREYMatcher>)matcherForInteractable {
@@ -253,7 +271,10 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
   DescribeToBlock describe = ^void(id<GREYDescription> description) {
     [description appendText:@"interactable"];
   };
-  return [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches descriptionBlock:describe];
+  id<GREYMatcher> matcher = [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
+                                                                 descriptionBlock:describe];
+  GREYMatcherSetCost(matcher, kGREYMatcherCostPixelRender);
+  return GREYMatcherSetRequiresVisibility(matcher, YES);
 }
 
 + (id<GREYMatcher>)matcherForNotVisible {
@@ -263,7 +284,9 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
   DescribeToBlock describe = ^void(id<GREYDescription> description) {
     [description appendText:@"notVisible"];
   };
-  return [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches descriptionBlock:describe];
+  id<GREYMatcher> matcher = [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
+                                                                 descriptionBlock:describe];
+  return GREYMatcherSetCost(matcher, kGREYMatcherCostPixelRender);
 }
 
 + (id<GREYMatcher>)matcherForAccessibilityElement {
@@ -327,37 +350,69 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
 }
 
 + (id<GREYMatcher>)matcherForAncestor:(id<GREYMatcher>)ancestorMatcher {
+  // Identifies the results of this matcher in the hierarchy match cache.
+  id query = [[NSObject alloc] init];
   MatchesBlock matches = ^BOOL(id element) {
+    GREYHierarchyMatchCache *cache = [GREYHierarchyMatchCache currentCache];
+    NSMutableArray *walkedElements = cache ? [[NSMutableArray alloc] init] : nil;
+    BOOL hasMatchingAncestor = NO;
     id parent = element;
     while (parent) {
+      NSNumber *cachedResult = [cache resultOfQuery:query forElement:parent];
+      if (cachedResult) {
+        hasMatchingAncestor = [cachedResult boolValue];
+        break;
+      }
+      [walkedElements addObject:parent];
       if ([parent isKindOfClass:[UIView class]]) {
         parent = [parent superview];
       } else {
         parent = [parent accessibilityContainer];
       }
       if (parent && [ancestorMatcher matches:parent]) {
-        return YES;
+        hasMatchingAncestor = YES;
+        break;
       }
     }
-    return NO;
+    // None of the ancestors that were walked past matched, so every walked element has the same
+    // result as the element the walk stopped at.
+    for (id walkedElement in walkedElements) {
+      [cache setResult:hasMatchingAncestor ofQuery:query forElement:walkedElement];
+    }
+    return hasMatchingAncestor;
   };
   DescribeToBlock describe = ^void(id<GREYDescription> description) {
     NSString *desc = [NSString stringWithFormat:@"ancestorThatMatches(%@)", ancestorMatcher];
     [description appendText:desc];
   };
+  id<GREYMatcher> matcher = [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
+                                                                 descriptionBlock:describe];
   return grey_allOf(grey_anyOf(grey_kindOfClass([UIView class]),
                                grey_respondsToSelector(@selector(accessibilityContainer)),
                                nil),
-                    [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
-                                                         descriptionBlock:describe],
+                    GREYMatcherSetCost(matcher, MAX(kGREYMatcherCostHierarchyWalk,
+                                                    GREYMatcherCostOf(ancestorMatcher))),
                     nil);
 }
 
 + (id<GREYMatcher>)matcherForDescendant:(id<GREYMatcher>)descendantMatcher {
+  // Identifies the results of this matcher in the hierarchy match cache.
+  id query = [[NSObject alloc] init];
   MatchesBlock matches = ^BOOL(id element) {
     if (element == nil) {
       return NO;
     }
+    GREYHierarchyMatchCache *cache = [GREYHierarchyMatchCache currentCache];
+    if (cache) {
+      NSUInteger dependencyDepth;
+      return [GREYMatchers grey_element:element
+                  hasDescendantMatching:descendantMatcher
+                                  query:query
+                                  cache:cache
+                              traversal:[[GREYTraversal alloc] init]
+                     elementsInProgress:[[NSMutableArray alloc] init]
+                        dependencyDepth:&dependencyDepth];
+    }
     GREYElementProvider *elementProvider =
         [[GREYElementProvider alloc] initWithRootElements:@[ element ]];
     NSEnumerator *elementEnumerator = [elementProvider dataEnumerator];
@@ -373,7 +428,10 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
     [description appendText:[NSString stringWithFormat:@"descendantThatMatches(%@)",
                                 descendantMatcher]];
   };
-  return [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches descriptionBlock:describe];
+  id<GREYMatcher> matcher = [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
+                                                                 descriptionBlock:describe];
+  return GREYMatcherSetCost(matcher, MAX(kGREYMatcherCostHierarchyWalk,
+                                          GREYMatcherCostOf(descendantMatcher)));
 }
 
 + (id<GREYMatcher>)matcherForButtonTitle:(NSString *)title {
@@ -594,7 +652,9 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
     [description appendText:name];
   };
   // Nil elements do not have layout for matching layout constraints.
-  return [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches descriptionBlock:describe];
+  id<GREYMatcher> matcher = [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matches
+                                                                 descriptionBlock:describe];
+  return GREYMatcherSetCost(matcher, kGREYMatcherCostHierarchyWalk);
 }
 
 + (id<GREYMatcher>)matcherForNil {
@@ -674,6 +734,82 @@ static const double kElementSufficientlyVisiblePercentage = 0.75;
 
 #pragma mark - Private
 
+/**
+ *  Checks whether any descendant of @c element is matched by @c descendantMatcher, reusing and
+ *  memoizing the results computed for other elements of the same search.
+ *
+ *  A cycle in the hierarchy leads back to an element whose descendants are still being checked.
+ *  Such an element is taken to have no matching descendant, so the results that rely on it aren't
+ *  final, and only get memoized once the element they rely on has been checked.
+ *
+ *  @param element                 The element whose descendants are checked.
+ *  @param descendantMatcher       The matcher for the descendants.
+ *  @param query                   The object identifying the results of the descendant matcher.
+ *  @param cache                   The cache of the search in progress.
+ *  @param traversal               The traversal used to explore the children of elements.
+ *  @param elementsInProgress      The elements whose descendants are being checked, from the
+ *                                 outermost one.
+ *  @param[out] outDependencyDepth The index in @c elementsInProgress of the outermost element that
+ *                                 the result relies on, or @c NSNotFound if the result is final.
+ *
+ *  @return @c YES if a descendant of @c element is matched by @c descendantMatcher, @c NO
+ *          otherwise.
+ */
++ (BOOL)grey_element:(id)element
+    hasDescendantMatching:(id<GREYMatcher>)descendantMatcher
+                    query:(id)query
+                    cache:(GREYHierarchyMatchCache *)cache
+                traversal:(GREYTraversal *)traversal
+       elementsInProgress:(NSMutableArray *)elementsInProgress
+          dependencyDepth:(NSUInteger *)outDependencyDepth {
+  *outDependencyDepth = NSNotFound;
+  NSNumber *cachedResult = [cache resultOfQuery:query forElement:element];
+  if (cachedResult) {
+    return [cachedResult boolValue];
+  }
+  NSUInteger depthInProgress = [elementsInProgress indexOfObjectIdenticalTo:element];
+  if (depthInProgress != NSNotFound) {
+    *outDependencyDepth = depthInProgress;
+    return NO;
+  }
+
+  NSUInteger depth = elementsInProgress.count;
+  [elementsInProgress addObject:element];
+  BOOL hasMatchingDescendant = NO;
+  NSUInteger dependencyDepth = NSNotFound;
+  for (id child in [traversal exploreImmediateChildren:element]) {
+    if (child == element) {
+      continue;
+    }
+    if ([descendantMatcher matches:child]) {
+      hasMatchingDescendant = YES;
+      break;
+    }
+    NSUInteger childDependencyDepth;
+    if ([self grey_element:child
+            hasDescendantMatching:descendantMatcher
+                            query:query
+                            cache:cache
+                        traversal:traversal
+               elementsInProgress:elementsInProgress
+                  dependencyDepth:&childDependencyDepth]) {
+      hasMatchingDescendant = YES;
+      break;
+    }
+    dependencyDepth = MIN(dependencyDepth, childDependencyDepth);
+  }
+  [elementsInProgress removeLastObject];
+
+  // A matching descendant is final no matter what else is in progress, and so is the lack of one
+  // once every element it relied on, which may include this one, has been checked.
+  if (hasMatchingDescendant || dependencyDepth >= depth) {
+    [cache setResult:hasMatchingDescendant ofQuery:query forElement:element];
+  } else {
+    *outDependencyDepth = dependencyDepth;
+  }
+  return hasMatchingDescendant;
+}
+
 /**
  * @return @c YES if the strings have the same string values, @c NO otherwise.
  */
@@ -17,6 +17,7 @@
 #import "Matcher/GREYNot.h"
 
 #import "Common/GREYThrowDefines.h"
+#import "Matcher/GREYMatcherCost.h"
 
 @implementation GREYNot {
   id<GREYMatcher> _matcher;
@@ -28,6 +29,7 @@
   self = [super init];
   if (self) {
     _matcher = matcher;
+    GREYMatcherSetCost(self, GREYMatcherCostOf(matcher));
   }
   return self;
 }
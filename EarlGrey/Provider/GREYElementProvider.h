@@ -104,6 +104,22 @@ NS_ASSUME_NONNULL_BEGIN
                       orRootElements:(NSArray *_Nullable)rootElements
                           orElements:(NSArray *_Nullable)elements NS_DESIGNATED_INITIALIZER;
 
+/**
+ *  @return An enumerator for the elements whose hierarchies are enumerated by
+ *          GREYElementProvider::dataEnumerator, without their descendants.
+ */
+- (NSEnumerator *)rootElementEnumerator;
+
+/**
+ *  @param predicate A block invoked on every enumerated element. If it returns @c YES, the
+ *                   descendants of the element are not enumerated.
+ *
+ *  @return An enumerator for the elements in the provider, except for the descendants of the
+ *          elements that pass @c predicate.
+ */
+- (NSEnumerator *)dataEnumeratorSkippingDescendantsPassingTest:
+    (BOOL (^_Nullable)(id element))predicate;
+
 #pragma mark - GREYProvider
 
 /**
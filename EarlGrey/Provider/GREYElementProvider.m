@@ -16,15 +16,120 @@
 
 #import "Provider/GREYElementProvider.h"
 
-#include <objc/runtime.h>
-
 #import "Assertion/GREYAssertionDefines.h"
 #import "Common/GREYConstants.h"
 #import "Common/GREYDefines.h"
 #import "Common/GREYFatalAsserts.h"
-#import "Provider/GREYDataEnumerator.h"
 #import "Traversal/GREYTraversalBFS.h"
 
+/**
+ *  Enumerates the hierarchies of a sequence of root elements one after the other, each in a BFS
+ *  fashion. Fast enumeration is forwarded to the underlying GREYTraversalBFS objects so that the
+ *  elements are handed out in batches rather than one message at a time.
+ */
+@interface GREYElementProviderEnumerator : NSEnumerator
+
+/**
+ *  Initializes the enumerator with the enumerator of the root elements.
+ *
+ *  @param rootEnumerator An enumerator of the elements whose hierarchies are to be enumerated.
+ *  @param predicate      If not @c nil, the descendants of the elements that pass this block are
+ *                        not enumerated.
+ *
+ *  @return An instance of GREYElementProviderEnumerator.
+ */
+- (instancetype)initWithRootEnumerator:(NSEnumerator *)rootEnumerator
+        skippingDescendantsPassingTest:(BOOL (^)(id element))predicate;
+
+@end
+
+@implementation GREYElementProviderEnumerator {
+  /**
+   *  The enumerator of the root elements.
+   */
+  NSEnumerator *_rootEnumerator;
+
+  /**
+   *  The traversal of the hierarchy of the current root element.
+   */
+  GREYTraversalBFS *_traversal;
+
+  /**
+   *  The fast enumeration state of @c _traversal.
+   */
+  NSFastEnumerationState _traversalState;
+
+  /**
+   *  The block deciding which descendants are skipped by every traversal, if any.
+   */
+  BOOL (^_skipDescendantsPredicate)(id element);
+}
+
+- (instancetype)initWithRootEnumerator:(NSEnumerator *)rootEnumerator
+        skippingDescendantsPassingTest:(BOOL (^)(id element))predicate {
+  self = [super init];
+  if (self) {
+    _rootEnumerator = rootEnumerator;
+    _skipDescendantsPredicate = [predicate copy];
+  }
+  return self;
+}
+
+- (id)nextObject {
+  id objToReturn = [_traversal nextObject];
+  while (!objToReturn) {
+    if (![self grey_startTraversalOfNextRootElement]) {
+      return nil;
+    }
+    objToReturn = [_traversal nextObject];
+  }
+  return objToReturn;
+}
+
+- (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+                                  objects:(id __unsafe_unretained _Nullable [_Nonnull])buffer
+                                    count:(NSUInteger)len {
+  if (state->state == 0) {
+    state->state = 1;
+    state->mutationsPtr = &state->extra[0];
+  }
+  while (YES) {
+    NSUInteger count = [_traversal countByEnumeratingWithState:&_traversalState
+                                                       objects:buffer
+                                                         count:len];
+    if (count > 0) {
+      state->itemsPtr = _traversalState.itemsPtr;
+      return count;
+    }
+    if (![self grey_startTraversalOfNextRootElement]) {
+      return 0;
+    }
+  }
+}
+
+#pragma mark - Private
+
+/**
+ *  Replaces the current traversal with a traversal of the next root element.
+ *
+ *  @return @c YES if there was a next root element, @c NO otherwise.
+ */
+- (BOOL)grey_startTraversalOfNextRootElement {
+  id nextElement = [_rootEnumerator nextObject];
+  if (!nextElement) {
+    _traversal = nil;
+    return NO;
+  }
+  // The GREYTraversalBFS object does all the hierarchy unrolling. In other words, the element
+  // provider relies on the GREYTraversalBFS object for its needs.
+  _traversal = [GREYTraversalBFS hierarchyForElementWithBFSTraversal:nextElement
+                                       skippingDescendantsPassingTest:_skipDescendantsPredicate];
+  _traversalState = (NSFastEnumerationState){0};
+  return YES;
+}
+
+@end
+
 @implementation GREYElementProvider {
   id<GREYProvider> _rootProvider;
   NSArray *_rootElements;
@@ -72,39 +177,28 @@
   return self;
 }
 
-#pragma mark - GREYProvider
-
-- (NSEnumerator *)dataEnumerator {
-  GREYFatalAssertMainThread();
-
-  NSEnumerator *enumerator;
+- (NSEnumerator *)rootElementEnumerator {
   if (_rootElements) {
-    enumerator = [_rootElements objectEnumerator];
+    return [_rootElements objectEnumerator];
   } else if (_rootProvider) {
-    enumerator = [_rootProvider dataEnumerator];
+    return [_rootProvider dataEnumerator];
   } else {
-    enumerator = [_elements objectEnumerator];
+    return [_elements objectEnumerator];
   }
+}
 
-  NSObject *userInfo = [[NSObject alloc] init];
-  return [[GREYDataEnumerator alloc] initWithUserInfo:userInfo block:^id(NSObject *userinfo) {
-    GREYTraversalBFS *traversal = objc_getAssociatedObject(userInfo, @selector(dataEnumerator));
-    id objToReturn = [traversal nextObject];
-    if (!objToReturn) {
-      id nextElement = [enumerator nextObject];
-      if (nextElement) {
-        // The GREYTraversalBFS object does all the hierarchy unrolling. In other words, the element
-        // provider relies on the GREYTraversalBFS object for its needs.
-        traversal = [GREYTraversalBFS hierarchyForElementWithBFSTraversal:nextElement];
-        objc_setAssociatedObject(userInfo,
-                                 @selector(dataEnumerator),
-                                 traversal,
-                                 OBJC_ASSOCIATION_RETAIN_NONATOMIC);
-        objToReturn = [traversal nextObject];
-      }
-    }
-    return objToReturn;
-  }];
+- (NSEnumerator *)dataEnumeratorSkippingDescendantsPassingTest:(BOOL (^)(id element))predicate {
+  GREYFatalAssertMainThread();
+
+  NSEnumerator *enumerator = [self rootElementEnumerator];
+  return [[GREYElementProviderEnumerator alloc] initWithRootEnumerator:enumerator
+                                        skippingDescendantsPassingTest:predicate];
+}
+
+#pragma mark - GREYProvider
+
+- (NSEnumerator *)dataEnumerator {
+  return [self dataEnumeratorSkippingDescendantsPassingTest:nil];
 }
 
 @end
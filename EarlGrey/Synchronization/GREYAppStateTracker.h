@@ -122,6 +122,14 @@ typedef NS_OPTIONS(NSUInteger, GREYAppState) {
  */
 - (GREYAppStateTrackerObject * _Nullable)trackState:(GREYAppState)state forObject:(id)object;
 
+/**
+ *  Tracks a pending draw or layout pass of the app as @c kGREYPendingDrawLayoutPass. The state is
+ *  untracked once the main run loop is about to sleep or exit, after Core Animation has committed
+ *  the pass. Unlike tracking the state for each object that needs a pass, repeated calls until
+ *  then are coalesced into the same pending pass and are cheap.
+ */
+- (void)trackPendingDrawLayoutPass;
+
 /**
  *  Untracks the state for the object with the specified id. For untracking, it does not matter
  *  if the state has been added to being ignored.
@@ -151,6 +159,14 @@ typedef NS_OPTIONS(NSUInteger, GREYAppState) {
  */
 - (void)clearIgnoredStates;
 
+/**
+ *  @param state The state to be named.
+ *
+ *  @return The names of the GREYAppState flags set in @c state, separated by @c |, or
+ *          @c kGREYIdle if none is set.
+ */
+- (NSString *)grey_nameOfState:(GREYAppState)state;
+
 /**
  *  Clears all states that are tracked by the GREYAppStateTracker singleton.
  *
@@ -18,6 +18,7 @@
 
 #include <objc/runtime.h>
 #include <pthread.h>
+#include <stdatomic.h>
 
 #import "Additions/NSObject+GREYAdditions.h"
 #import "Common/GREYConfiguration.h"
@@ -27,6 +28,7 @@
 #import "Common/GREYThrowDefines.h"
 #import "Synchronization/GREYAppStateTrackerObject.h"
 #import "Synchronization/GREYObjectDeallocationTracker.h"
+#import "Synchronization/GREYUIThreadExecutor.h"
 
 /**
  *  Enum to specify the type of operation that is being performed on an object.
@@ -43,9 +45,25 @@ typedef NS_ENUM(NSUInteger, GREYStateOperation) {
 static pthread_mutex_t gStateLock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
 
 /**
- *  The number of app states that exist. Used as a hint in creating @c _stateDictionary.
+ *  The number of app states that exist, one per bit of GREYAppState.
  */
-static const unsigned short kNumGREYAppStates = 12;
+#define GREY_NUM_APP_STATES 12
+
+/**
+ *  The order of the observer untracking the pending draw or layout pass. It must come after the
+ *  Core Animation observer committing the pass, which has an order of 2000000, and before the
+ *  observers of the run loop spinner checking for idleness, which have an order of @c LONG_MAX.
+ */
+static const CFIndex kDrawLayoutPassObserverOrder = 2000001;
+
+/**
+ *  Stands for the pending draw or layout pass of the app in the tracked objects.
+ */
+@interface GREYDrawLayoutPass : NSObject
+@end
+
+@implementation GREYDrawLayoutPass
+@end
 
 @interface GREYAppStateTracker() <GREYObjectDeallocationTrackerDelegate>
 
@@ -63,14 +81,33 @@ static const unsigned short kNumGREYAppStates = 12;
    */
   GREYAppState _ignoredAppState;
   /**
-   *  The current state of the app. Access should be guarded by @c gStateLock lock.
+   *  The current state of the app. Modifications should be guarded by @c gStateLock lock, but it
+   *  can be read without taking the lock.
    */
-  GREYAppState _currentState;
+  atomic_ulong _currentState;
   /**
-   *  A dictionary that maps the state to the number of objects that are currently in that state.
+   *  The number of objects that are currently in each state, indexed by the bit of the state.
    *  Access should be guarded by @c gStateLock lock.
    */
-  NSMutableDictionary<NSNumber *, NSNumber *> *_stateDictionary;
+  NSUInteger _stateCounts[GREY_NUM_APP_STATES];
+  /**
+   *  The object tracked for the pending draw or layout pass of the app.
+   */
+  GREYDrawLayoutPass *_drawLayoutPass;
+  /**
+   *  The GREYAppStateTrackerObject of @c _drawLayoutPass while it is tracked.
+   *  Access should be guarded by @c gStateLock lock.
+   */
+  GREYAppStateTrackerObject *_drawLayoutPassTrackerObject;
+  /**
+   *  Whether @c _drawLayoutPass is tracked. Modifications should be guarded by @c gStateLock lock,
+   *  but it can be read without taking the lock.
+   */
+  atomic_bool _drawLayoutPassPending;
+  /**
+   *  The main run loop observer that untracks @c _drawLayoutPass.
+   */
+  CFRunLoopObserverRef _drawLayoutPassObserver;
 }
 
 + (instancetype)sharedInstance {
@@ -91,10 +128,20 @@ static const unsigned short kNumGREYAppStates = 12;
 - (instancetype)initOnce {
   self = [super init];
   if (self) {
-    _currentState = kGREYIdle;
+    atomic_init(&_currentState, kGREYIdle);
     _externalTrackerObjects = [[NSMutableSet alloc] init];
     _ignoredAppState = kGREYIdle;
-    _stateDictionary = [[NSMutableDictionary alloc] initWithCapacity:kNumGREYAppStates];
+    _drawLayoutPass = [[GREYDrawLayoutPass alloc] init];
+    _drawLayoutPassObserver =
+        CFRunLoopObserverCreateWithHandler(NULL,
+                                           kCFRunLoopBeforeWaiting | kCFRunLoopExit,
+                                           true,
+                                           kDrawLayoutPassObserverOrder,
+                                           ^(CFRunLoopObserverRef observer,
+                                             CFRunLoopActivity activity) {
+      [self grey_untrackPendingDrawLayoutPass];
+    });
+    CFRunLoopAddObserver(CFRunLoopGetMain(), _drawLayoutPassObserver, kCFRunLoopCommonModes);
   }
   return self;
 }
@@ -107,6 +154,29 @@ orInternalObjectDeallocationTracker:nil
     orExternalAppStateTrackerObject:nil];
 }
 
+- (void)trackPendingDrawLayoutPass {
+  if (atomic_load(&_drawLayoutPassPending)) {
+    return;
+  }
+  [self grey_performBlockInCriticalSection:^id {
+    if (!atomic_exchange(&_drawLayoutPassPending, true)) {
+      _drawLayoutPassTrackerObject = [self trackState:kGREYPendingDrawLayoutPass
+                                            forObject:_drawLayoutPass];
+    }
+    return nil;
+  }];
+  if ([NSThread isMainThread]) {
+    // The observer is only added to the common modes up front, but the pass may have been
+    // requested while the run loop runs in another mode.
+    CFRunLoopRef mainRunLoop = CFRunLoopGetMain();
+    CFStringRef currentMode = CFRunLoopCopyCurrentMode(mainRunLoop);
+    if (currentMode) {
+      CFRunLoopAddObserver(mainRunLoop, _drawLayoutPassObserver, currentMode);
+      CFRelease(currentMode);
+    }
+  }
+}
+
 - (void)untrackState:(GREYAppState)state forObject:(GREYAppStateTrackerObject *)object {
   [self grey_changeState:state
                      usingOperation:kGREYUnTrackState
@@ -116,9 +186,7 @@ orInternalObjectDeallocationTracker:nil
 }
 
 - (GREYAppState)currentState {
-  return [[self grey_performBlockInCriticalSection:^id {
-    return @(_currentState);
-  }] unsignedIntegerValue];
+  return (GREYAppState)atomic_load_explicit(&_currentState, memory_order_acquire);
 }
 
 /**
@@ -179,8 +247,44 @@ orInternalObjectDeallocationTracker:nil
   return [self description];
 }
 
+- (BOOL)signalsIdleTransitions {
+  return YES;
+}
+
 #pragma mark - Private
 
+- (NSString *)grey_nameOfState:(GREYAppState)state {
+  if (state == kGREYIdle) {
+    return @"kGREYIdle";
+  }
+  static const struct {
+    GREYAppState state;
+    __unsafe_unretained NSString *name;
+  } kStateNames[] = {
+    { kGREYPendingDrawLayoutPass, @"kGREYPendingDrawLayoutPass" },
+    { kGREYPendingViewsToAppear, @"kGREYPendingViewsToAppear" },
+    { kGREYPendingViewsToDisappear, @"kGREYPendingViewsToDisappear" },
+    { kGREYPendingKeyboardTransition, @"kGREYPendingKeyboardTransition" },
+    { kGREYPendingCAAnimation, @"kGREYPendingCAAnimation" },
+    { kGREYPendingUIAnimation, @"kGREYPendingUIAnimation" },
+    { kGREYPendingRootViewControllerToAppear, @"kGREYPendingRootViewControllerToAppear" },
+    { kGREYPendingUIWebViewAsyncRequest, @"kGREYPendingUIWebViewAsyncRequest" },
+    { kGREYPendingNetworkRequest, @"kGREYPendingNetworkRequest" },
+    { kGREYPendingGestureRecognition, @"kGREYPendingGestureRecognition" },
+    { kGREYPendingUIScrollViewScrolling, @"kGREYPendingUIScrollViewScrolling" },
+    { kGREYIgnoringSystemWideUserInteraction, @"kGREYIgnoringSystemWideUserInteraction" },
+  };
+  NSMutableArray<NSString *> *names = [[NSMutableArray alloc] init];
+  for (size_t i = 0; i < sizeof(kStateNames) / sizeof(kStateNames[0]); i++) {
+    if (state & kStateNames[i].state) {
+      [names addObject:kStateNames[i].name];
+      state &= ~kStateNames[i].state;
+    }
+  }
+  GREYFatalAssertWithMessage(state == 0, @"Did we forget to name some states?");
+  return [names componentsJoinedByString:@" | "];
+}
+
 - (NSString *)grey_stringFromState:(GREYAppState)state {
   NSMutableArray *eventStateString = [[NSMutableArray alloc] init];
   if (state == kGREYIdle) {
@@ -261,6 +365,22 @@ orInternalObjectDeallocationTracker:nil
   return retVal;
 }
 
+/**
+ *  Untracks the pending draw or layout pass, if any.
+ */
+- (void)grey_untrackPendingDrawLayoutPass {
+  if (!atomic_load(&_drawLayoutPassPending)) {
+    return;
+  }
+  [self grey_performBlockInCriticalSection:^id {
+    if (atomic_exchange(&_drawLayoutPassPending, false) && _drawLayoutPassTrackerObject) {
+      [self untrackState:kGREYPendingDrawLayoutPass forObject:_drawLayoutPassTrackerObject];
+    }
+    _drawLayoutPassTrackerObject = nil;
+    return nil;
+  }];
+}
+
 - (NSString *)grey_descriptionForObject:(id)object {
   return [NSString stringWithFormat:@"%@:%p", NSStringFromClass([object class]), object];
 }
@@ -370,6 +490,11 @@ orInternalObjectDeallocationTracker:nil
       } else {
         newState = track ? (originalState | modifiedState) : (originalState & ~modifiedState);
       }
+      // Objects being tracked for a state they are already in, such as views that are repeatedly
+      // asked to lay out, need no update as long as they are already part of the map.
+      if (newState == originalState && externalObjectExistsAlready) {
+        return appStateTrackerObjectExternal;
+      }
 
       // We update the @c _currentState so that we can provide quick information if the app is idle
       // or not.
@@ -406,90 +531,37 @@ orInternalObjectDeallocationTracker:nil
 }
 
 - (void)objectChangingFromState:(GREYAppState)originalState toState:(GREYAppState)newState {
-  if (originalState != kGREYIdle) {
-    [self grey_adjustGlobalCountByOneForState:originalState increment:YES];
-  }
-  if (newState != kGREYIdle) {
-    [self grey_adjustGlobalCountByOneForState:newState increment:NO];
-  }
-}
-
-- (void)grey_adjustGlobalCountByOneForState:(GREYAppState)state increment:(BOOL)increment {
-  // The @c state could be a combination of multiple states, hence, we need to check against
-  // every state.
-  if (state & kGREYPendingDrawLayoutPass) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingDrawLayoutPass
-                                                increment:increment];
-  }
-  if (state & kGREYPendingViewsToAppear) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingViewsToAppear
-                                                increment:increment];
-  }
-  if (state & kGREYPendingViewsToDisappear) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingViewsToDisappear
-                                                increment:increment];
-  }
-  if (state & kGREYPendingKeyboardTransition) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingKeyboardTransition
-                                                increment:increment];
-  }
-  if (state & kGREYPendingCAAnimation) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingCAAnimation
-                                                increment:increment];
-  }
-  if (state & kGREYPendingUIAnimation) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingUIAnimation
-                                                increment:increment];
-  }
-  if (state & kGREYPendingRootViewControllerToAppear) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingRootViewControllerToAppear
-                                                increment:increment];
-  }
-  if (state & kGREYPendingUIWebViewAsyncRequest) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingUIWebViewAsyncRequest
-                                                increment:increment];
-  }
-  if (state & kGREYPendingNetworkRequest) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingNetworkRequest
-                                                increment:increment];
-  }
-  if (state & kGREYPendingGestureRecognition) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingGestureRecognition
-                                                increment:increment];
-  }
-  if (state & kGREYPendingUIScrollViewScrolling) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYPendingUIScrollViewScrolling
-                                                increment:increment];
-  }
-  if (state & kGREYIgnoringSystemWideUserInteraction) {
-    [self grey_updateGlobalCountByOneInDictionaryForState:kGREYIgnoringSystemWideUserInteraction
-                                                increment:increment];
-  }
-}
-
-- (void)grey_updateGlobalCountByOneInDictionaryForState:(GREYAppState)state
-                                              increment:(BOOL)increment {
-  NSNumber *numElements = [_stateDictionary objectForKey:@(state)];
-  NSUInteger count = 1;
-  if (numElements) {
-    count = [numElements unsignedIntegerValue];
-  }
-  if (increment) {
-    count -= 1;
-    [_stateDictionary setObject:[NSNumber numberWithUnsignedInteger:count] forKey:@(state)];
-    if (count == 0) {
-      _currentState = _currentState & ~state;
+  // Only the states that the object enters or leaves change the counts.
+  GREYAppState leftStates = originalState & ~newState;
+  GREYAppState enteredStates = newState & ~originalState;
+  GREYAppState clearedStates = kGREYIdle;
+  GREYAppState setStates = kGREYIdle;
+  while (leftStates) {
+    unsigned int bit = (unsigned int)__builtin_ctzl(leftStates);
+    leftStates &= leftStates - 1;
+    GREYFatalAssertWithMessage(_stateCounts[bit] > 0, @"State count must not become negative.");
+    if (--_stateCounts[bit] == 0) {
+      clearedStates |= (1UL << bit);
     }
-  } else {
-    if (!numElements) {
-      count = 0;
+  }
+  while (enteredStates) {
+    unsigned int bit = (unsigned int)__builtin_ctzl(enteredStates);
+    enteredStates &= enteredStates - 1;
+    GREYFatalAssertWithMessage(bit < GREY_NUM_APP_STATES, @"Unknown state %lu.", 1UL << bit);
+    if (_stateCounts[bit]++ == 0) {
+      setStates |= (1UL << bit);
     }
-    count += 1;
-    [_stateDictionary setObject:[NSNumber numberWithUnsignedInteger:count] forKey:@(state)];
-    if ((count == 1) && (_currentState & state) == 0) {
-      _currentState = _currentState | state;
+  }
+  if (clearedStates) {
+    GREYAppState previousState =
+        atomic_fetch_and_explicit(&_currentState, ~clearedStates, memory_order_release);
+    if (!setStates && (previousState & ~clearedStates) == kGREYIdle) {
+      [[GREYUIThreadExecutor sharedInstance] signalIdleTransition];
     }
   }
+  if (setStates) {
+    atomic_fetch_or_explicit(&_currentState, setStates, memory_order_release);
+  }
 }
 
 #pragma mark - Methods Only For Testing
@@ -508,8 +580,12 @@ orInternalObjectDeallocationTracker:nil
 
 - (void)grey_clearState {
   [self grey_performBlockInCriticalSection:^id {
-    _currentState = kGREYIdle;
-    [_stateDictionary removeAllObjects];
+    memset(_stateCounts, 0, sizeof(_stateCounts));
+    atomic_store(&_drawLayoutPassPending, false);
+    _drawLayoutPassTrackerObject = nil;
+    if (atomic_exchange_explicit(&_currentState, kGREYIdle, memory_order_release) != kGREYIdle) {
+      [[GREYUIThreadExecutor sharedInstance] signalIdleTransition];
+    }
     // We get rid of the strong reference from internal to external object so that the external
     // object can get deallocated.
     for (GREYAppStateTrackerObject *externalObject in _externalTrackerObjects) {
@@ -64,4 +64,9 @@
   return trackerIsIdle;
 }
 
+- (BOOL)signalsIdleTransitions {
+  // The tracker signals when its last pending block completes.
+  return YES;
+}
+
 @end
@@ -0,0 +1,44 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/**
+ *  @file  GREYDispatchQueueTracker+Internal.h
+ *  @brief Exposes the values GREYDispatchQueueTracker uses to look up global queues that aren't
+ *         part of the public SDK, for testing purposes.
+ */
+
+#import <EarlGrey/GREYDefines.h>
+
+#import "Synchronization/GREYDispatchQueueTracker.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  The QoS class of the maintenance global queue, which isn't part of the public SDK.
+ *
+ *  @remark This is available only for internal testing purposes.
+ */
+GREY_EXTERN const qos_class_t kGREYQOSClassMaintenance;
+
+/**
+ *  The flag that selects the overcommitting variant of a global queue, which isn't part of the
+ *  public SDK.
+ *
+ *  @remark This is available only for internal testing purposes.
+ */
+GREY_EXTERN const unsigned long kGREYDispatchQueueOvercommit;
+
+NS_ASSUME_NONNULL_END
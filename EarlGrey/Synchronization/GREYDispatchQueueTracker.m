@@ -14,15 +14,16 @@
 // limitations under the License.
 //
 
-#import "Synchronization/GREYDispatchQueueTracker.h"
+#import "Synchronization/GREYDispatchQueueTracker+Internal.h"
 
 #include <dlfcn.h>
 #include <fishhook.h>
 #include <stdatomic.h>
 
-#import "Common/GREYConfiguration.h"
+#import "Common/GREYConfiguration+Internal.h"
 #import "Common/GREYFatalAsserts.h"
 #import "Common/GREYThrowDefines.h"
+#import "Synchronization/GREYUIThreadExecutor.h"
 
 /**
  *  A pointer to the original implementation of @c dispatch_after.
@@ -60,10 +61,102 @@ static void (*grey_original_dispatch_sync_f)(dispatch_queue_t queue,
                                              dispatch_function_t work);
 
 /**
- *  Used to find the @c GREYDispatchQueueTracker instance corresponding to a dispatch queue, if
- *  one exists.
+ *  The key under which a queue's @c GREYDispatchQueueTrackerReference is set as queue specific
+ *  data.
  */
-static NSMapTable *gDispatchQueueToTracker;
+static const void *const kTrackerReferenceKey = &kTrackerReferenceKey;
+
+const qos_class_t kGREYQOSClassMaintenance = (qos_class_t)0x05;
+
+const unsigned long kGREYDispatchQueueOvercommit = 0x2;
+
+/**
+ *  The number of global queues that are looked up without a lock: the six QoS classes, each in its
+ *  regular and its overcommitting variant.
+ */
+static const size_t kNumGlobalQueues = 12;
+
+/**
+ *  The global queues, which don't allow setting queue specific data. Entries are @c NULL for the
+ *  variants that aren't available on this OS.
+ */
+static dispatch_queue_t gGlobalQueues[kNumGlobalQueues];
+
+/**
+ *  The tracker references of the queues in @c gGlobalQueues, at the same indices. They are created
+ *  once and never replaced.
+ */
+static void *gGlobalQueueTrackerReferences[kNumGlobalQueues];
+
+/**
+ *  The prefix of the labels of the root queues of libdispatch, the global queues among them.
+ */
+static const char *const kRootQueueLabelPrefix = "com.apple.root.";
+
+/**
+ *  Maps the root queues that aren't in @c gGlobalQueues to their tracker references. Like the
+ *  global queues, they don't allow setting queue specific data, so they are looked up under a lock
+ *  on this map table.
+ */
+static NSMapTable *gRootQueueTrackerReferences;
+
+/**
+ *  A tracked block or @c dispatch_*_f task, forwarded to the original @c dispatch_*_f functions in
+ *  place of a wrapper block.
+ */
+typedef struct GREYTrackedTask {
+  /**
+   *  The tracker of the queue that the task was dispatched to. Retained for asynchronous tasks.
+   */
+  void *tracker;
+  /**
+   *  The function of a @c dispatch_*_f task or @c NULL if the task is a block.
+   */
+  dispatch_function_t work;
+  /**
+   *  The context of a @c dispatch_*_f task or the block. Blocks are retained for asynchronous
+   *  tasks.
+   */
+  void *context;
+} GREYTrackedTask;
+
+/**
+ *  The number of asynchronous tasks that can be pending at once without allocating their
+ *  @c GREYTrackedTask.
+ */
+static const size_t kTrackedTaskPoolSize = 64;
+
+/**
+ *  The pooled tasks.
+ */
+static GREYTrackedTask gTrackedTaskPool[kTrackedTaskPoolSize];
+
+/**
+ *  Whether the pooled task at the same index in @c gTrackedTaskPool is in use.
+ */
+static atomic_bool gTrackedTaskPoolSlotsInUse[kTrackedTaskPoolSize];
+
+/**
+ *  The slot at which the next search for a free pooled task starts.
+ */
+static atomic_uint gTrackedTaskPoolNextSlot;
+
+/**
+ *  Weakly references the tracker of a dispatch queue. A reference is created the first time a queue
+ *  is tracked and lives as long as the queue, so that looking up the tracker of a queue doesn't
+ *  require any global lock.
+ */
+@interface GREYDispatchQueueTrackerReference : NSObject
+
+/**
+ *  The tracker of the queue or @c nil if it has been deallocated.
+ */
+@property(atomic, weak) GREYDispatchQueueTracker *tracker;
+
+@end
+
+@implementation GREYDispatchQueueTrackerReference
+@end
 
 @interface GREYDispatchQueueTracker ()
 
@@ -77,17 +170,57 @@ static NSMapTable *gDispatchQueueToTracker;
 - (void)grey_dispatchAsyncCallWithContext:(void *)context work:(dispatch_function_t)work;
 - (void)grey_dispatchSyncCallWithContext:(void *)context work:(dispatch_function_t)work;
 
+- (void)grey_blockDidComplete;
+
 @end
 
+/**
+ *  @return @c YES if @c queue is a root queue of libdispatch, @c NO otherwise.
+ */
+static BOOL grey_isRootQueue(dispatch_queue_t queue) {
+  const char *label = dispatch_queue_get_label(queue);
+  return label && strncmp(label, kRootQueueLabelPrefix, strlen(kRootQueueLabelPrefix)) == 0;
+}
+
+/**
+ *  @return The reference to the tracker of @c queue or @c NULL if @c queue has never been tracked.
+ */
+static void *grey_getTrackerReferenceForQueue(dispatch_queue_t queue) {
+  // Queues without specific data return NULL right away, which is what most queues of the app do.
+  void *reference = dispatch_queue_get_specific(queue, kTrackerReferenceKey);
+  if (!reference) {
+    for (size_t i = 0; i < kNumGlobalQueues; i++) {
+      if (queue == gGlobalQueues[i]) {
+        return gGlobalQueueTrackerReferences[i];
+      }
+    }
+    if (grey_isRootQueue(queue)) {
+      @synchronized(gRootQueueTrackerReferences) {
+        reference = (__bridge void *)[gRootQueueTrackerReferences objectForKey:queue];
+      }
+    }
+  }
+  return reference;
+}
+
 /**
  * @return The @c GREYDispatchQueueTracker associated with @c queue or @c nil if there is none.
  */
 static GREYDispatchQueueTracker *grey_getTrackerForQueue(dispatch_queue_t queue) {
-  GREYDispatchQueueTracker *tracker = nil;
-  @synchronized(gDispatchQueueToTracker) {
-    tracker = [gDispatchQueueToTracker objectForKey:queue];
+  void *reference = grey_getTrackerReferenceForQueue(queue);
+  if (!reference) {
+    return nil;
   }
-  return tracker;
+  return ((__bridge GREYDispatchQueueTrackerReference *)reference).tracker;
+}
+
+/**
+ *  Releases a queue's tracker reference when the queue is deallocated.
+ *
+ *  @param reference The reference to be released.
+ */
+static void grey_releaseTrackerReference(void *reference) {
+  CFRelease(reference);
 }
 
 /**
@@ -196,6 +329,83 @@ static void grey_dispatch_sync_f(dispatch_queue_t queue, void *context, dispatch
   }
 }
 
+/**
+ *  @return A free task from the pool or a newly allocated one if all of them are in use.
+ */
+static GREYTrackedTask *grey_acquireTrackedTask(void) {
+  unsigned int firstSlot = atomic_fetch_add_explicit(&gTrackedTaskPoolNextSlot, 1,
+                                                     memory_order_relaxed);
+  for (size_t i = 0; i < kTrackedTaskPoolSize; i++) {
+    size_t slot = (firstSlot + i) % kTrackedTaskPoolSize;
+    atomic_bool *inUse = &gTrackedTaskPoolSlotsInUse[slot];
+    if (!atomic_load_explicit(inUse, memory_order_relaxed) &&
+        !atomic_exchange_explicit(inUse, true, memory_order_acquire)) {
+      return &gTrackedTaskPool[slot];
+    }
+  }
+  return malloc(sizeof(GREYTrackedTask));
+}
+
+/**
+ *  Returns @c task to the pool or frees it if it was allocated because the pool was exhausted.
+ *
+ *  @param task The task to be released.
+ */
+static void grey_releaseTrackedTask(GREYTrackedTask *task) {
+  if (task >= gTrackedTaskPool && task < gTrackedTaskPool + kTrackedTaskPoolSize) {
+    atomic_store_explicit(&gTrackedTaskPoolSlotsInUse[task - gTrackedTaskPool], false,
+                          memory_order_release);
+  } else {
+    free(task);
+  }
+}
+
+/**
+ *  Performs @c task and marks it as completed with its tracker.
+ *
+ *  @param task The task to be performed.
+ */
+static void grey_performTrackedTask(GREYTrackedTask *task) {
+  if (task->work) {
+    task->work(task->context);
+  } else {
+    ((__bridge dispatch_block_t)task->context)();
+  }
+  [(__bridge GREYDispatchQueueTracker *)task->tracker grey_blockDidComplete];
+}
+
+/**
+ *  @c dispatch_function_t performing a synchronous @c GREYTrackedTask.
+ *
+ *  @param context The @c GREYTrackedTask to be performed.
+ */
+static void grey_performSyncTrackedTask(void *context) {
+  grey_performTrackedTask(context);
+}
+
+/**
+ *  @c dispatch_function_t performing an asynchronous @c GREYTrackedTask and then releasing it.
+ *
+ *  @param context The @c GREYTrackedTask to be performed.
+ */
+static void grey_performAsyncTrackedTask(void *context) {
+  GREYTrackedTask *task = context;
+  grey_performTrackedTask(task);
+  if (!task->work) {
+    CFRelease(task->context);
+  }
+  CFRelease(task->tracker);
+  grey_releaseTrackedTask(task);
+}
+
+/**
+ *  @return The value of @c kGREYConfigKeyDispatchAfterMaxTrackableDelay in nanoseconds.
+ */
+static int64_t grey_maxTrackableDelay(void) {
+  CFTimeInterval maxDelay = GREY_CONFIG_SNAPSHOT(dispatchAfterMaxTrackableDelay);
+  return (int64_t)(maxDelay * NSEC_PER_SEC);
+}
+
 @implementation GREYDispatchQueueTracker {
   __weak dispatch_queue_t _dispatchQueue;
   __block atomic_int _pendingBlocks;
@@ -203,7 +413,21 @@ static void grey_dispatch_sync_f(dispatch_queue_t queue, void *context, dispatch
 
 + (void)load {
   @autoreleasepool {
-    gDispatchQueueToTracker = [NSMapTable weakToWeakObjectsMapTable];
+    const qos_class_t globalQueueQOSClasses[kNumGlobalQueues / 2] = {
+      QOS_CLASS_USER_INTERACTIVE,
+      QOS_CLASS_USER_INITIATED,
+      QOS_CLASS_DEFAULT,
+      QOS_CLASS_UTILITY,
+      QOS_CLASS_BACKGROUND,
+      kGREYQOSClassMaintenance,
+    };
+    for (size_t i = 0; i < kNumGlobalQueues; i++) {
+      unsigned long flags = (i % 2) ? kGREYDispatchQueueOvercommit : 0;
+      gGlobalQueues[i] = dispatch_get_global_queue(globalQueueQOSClasses[i / 2], flags);
+      gGlobalQueueTrackerReferences[i] =
+          (void *)CFBridgingRetain([[GREYDispatchQueueTrackerReference alloc] init]);
+    }
+    gRootQueueTrackerReferences = [NSMapTable weakToStrongObjectsMapTable];
 
     dispatch_queue_t dummyQueue = dispatch_queue_create("GREYDummyQueue", DISPATCH_QUEUE_SERIAL);
     GREYFatalAssertWithMessage(dummyQueue, @"dummmyQueue must not be nil");
@@ -248,12 +472,34 @@ static void grey_dispatch_sync_f(dispatch_queue_t queue, void *context, dispatch
 + (instancetype)trackerForDispatchQueue:(dispatch_queue_t)queue {
   GREYThrowOnNilParameter(queue);
 
-  @synchronized(gDispatchQueueToTracker) {
-    GREYDispatchQueueTracker *tracker = grey_getTrackerForQueue(queue);
+  @synchronized(self) {
+    void *reference = grey_getTrackerReferenceForQueue(queue);
+    if (!reference) {
+      // The reference is never replaced once set, so that lookups racing with this method never
+      // see it released.
+      if (grey_isRootQueue(queue)) {
+        // Root queues crash when setting queue specific data, so fall back to the map table.
+        GREYDispatchQueueTrackerReference *rootQueueReference =
+            [[GREYDispatchQueueTrackerReference alloc] init];
+        @synchronized(gRootQueueTrackerReferences) {
+          [gRootQueueTrackerReferences setObject:rootQueueReference forKey:queue];
+        }
+        reference = (__bridge void *)rootQueueReference;
+      } else {
+        reference = (void *)CFBridgingRetain([[GREYDispatchQueueTrackerReference alloc] init]);
+        dispatch_queue_set_specific(queue,
+                                    kTrackerReferenceKey,
+                                    reference,
+                                    grey_releaseTrackerReference);
+      }
+    }
+    GREYDispatchQueueTrackerReference *trackerReference =
+        (__bridge GREYDispatchQueueTrackerReference *)reference;
+    GREYDispatchQueueTracker *tracker = trackerReference.tracker;
     if (!tracker) {
       tracker = [[GREYDispatchQueueTracker alloc] initWithDispatchQueue:queue];
-      // Register this tracker with dispatch queue. Both entries are weakly held.
-      [gDispatchQueueToTracker setObject:tracker forKey:queue];
+      // Register this tracker with dispatch queue. The tracker is weakly held.
+      trackerReference.tracker = tracker;
     }
     return tracker;
   }
@@ -295,67 +541,94 @@ static void grey_dispatch_sync_f(dispatch_queue_t queue, void *context, dispatch
 
 #pragma mark - Private
 
-- (void)grey_dispatchAfterCallWithTime:(dispatch_time_t)when block:(dispatch_block_t)block {
-  CFTimeInterval maxDelay = GREY_CONFIG_DOUBLE(kGREYConfigKeyDispatchAfterMaxTrackableDelay);
-  dispatch_time_t trackDelay = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(maxDelay * NSEC_PER_SEC));
+/**
+ *  Marks a tracked block or task as completed, signaling the transition to idle if it was the last
+ *  pending one.
+ */
+- (void)grey_blockDidComplete {
+  if (atomic_fetch_sub(&_pendingBlocks, 1) == 1) {
+    [[GREYUIThreadExecutor sharedInstance] signalIdleTransition];
+  }
+}
 
+- (void)grey_dispatchAfterCallWithTime:(dispatch_time_t)when block:(dispatch_block_t)block {
+  dispatch_time_t trackDelay = dispatch_time(DISPATCH_TIME_NOW, grey_maxTrackableDelay());
   if (trackDelay >= when) {
-    atomic_fetch_add(&_pendingBlocks, 1);
-    grey_original_dispatch_after(when, _dispatchQueue, ^{
-      block();
-      atomic_fetch_sub(&_pendingBlocks, 1);
-    });
+    void *retainedBlock = (void *)CFBridgingRetain([block copy]);
+    grey_original_dispatch_after_f(when,
+                                   _dispatchQueue,
+                                   [self grey_asyncTrackedTaskWithContext:retainedBlock work:NULL],
+                                   grey_performAsyncTrackedTask);
   } else {
     grey_original_dispatch_after(when, _dispatchQueue, block);
   }
 }
 
 - (void)grey_dispatchAsyncCallWithBlock:(dispatch_block_t)block {
-  atomic_fetch_add(&_pendingBlocks, 1);
-  grey_original_dispatch_async(_dispatchQueue, ^{
-    block();
-    atomic_fetch_sub(&_pendingBlocks, 1);
-  });
+  void *retainedBlock = (void *)CFBridgingRetain([block copy]);
+  grey_original_dispatch_async_f(_dispatchQueue,
+                                 [self grey_asyncTrackedTaskWithContext:retainedBlock work:NULL],
+                                 grey_performAsyncTrackedTask);
 }
 
 - (void)grey_dispatchSyncCallWithBlock:(dispatch_block_t)block {
-  atomic_fetch_add(&_pendingBlocks, 1);
-  grey_original_dispatch_sync(_dispatchQueue, ^{
-    block();
-    atomic_fetch_sub(&_pendingBlocks, 1);
-  });
+  [self grey_dispatchSyncTrackedTaskWithContext:(__bridge void *)block work:NULL];
 }
 
 - (void)grey_dispatchAfterCallWithTime:(dispatch_time_t)when
                                context:(void *)context
                                   work:(dispatch_function_t)work {
-  CFTimeInterval maxDelay = GREY_CONFIG_DOUBLE(kGREYConfigKeyDispatchAfterMaxTrackableDelay);
-  dispatch_time_t trackDelay = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(maxDelay * NSEC_PER_SEC));
+  dispatch_time_t trackDelay = dispatch_time(DISPATCH_TIME_NOW, grey_maxTrackableDelay());
   if (trackDelay >= when) {
-    atomic_fetch_add(&_pendingBlocks, 1);
-    grey_original_dispatch_after(when, _dispatchQueue, ^{
-      work(context);
-      atomic_fetch_sub(&_pendingBlocks, 1);
-    });
+    grey_original_dispatch_after_f(when,
+                                   _dispatchQueue,
+                                   [self grey_asyncTrackedTaskWithContext:context work:work],
+                                   grey_performAsyncTrackedTask);
   } else {
     grey_original_dispatch_after_f(when, _dispatchQueue, context, work);
   }
 }
 
 - (void)grey_dispatchAsyncCallWithContext:(void *)context work:(dispatch_function_t)work {
-  atomic_fetch_add(&_pendingBlocks, 1);
-  grey_original_dispatch_async(_dispatchQueue, ^{
-    work(context);
-    atomic_fetch_sub(&_pendingBlocks, 1);
-  });
+  grey_original_dispatch_async_f(_dispatchQueue,
+                                 [self grey_asyncTrackedTaskWithContext:context work:work],
+                                 grey_performAsyncTrackedTask);
 }
 
 - (void)grey_dispatchSyncCallWithContext:(void *)context work:(dispatch_function_t)work {
+  [self grey_dispatchSyncTrackedTaskWithContext:context work:work];
+}
+
+/**
+ *  Marks a new asynchronous task as pending and returns it, retaining the tracker until it is
+ *  performed.
+ *
+ *  @param context The context of a @c dispatch_*_f task or the retained block.
+ *  @param work    The function of a @c dispatch_*_f task or @c NULL if the task is a block.
+ *
+ *  @return A task to be performed by grey_performAsyncTrackedTask.
+ */
+- (GREYTrackedTask *)grey_asyncTrackedTaskWithContext:(void *)context
+                                                 work:(dispatch_function_t)work {
+  atomic_fetch_add(&_pendingBlocks, 1);
+  GREYTrackedTask *task = grey_acquireTrackedTask();
+  task->tracker = (void *)CFBridgingRetain(self);
+  task->work = work;
+  task->context = context;
+  return task;
+}
+
+/**
+ *  Marks a new synchronous task as pending and performs it on the tracked queue. The task lives on
+ *  the stack since @c dispatch_sync_f doesn't return until it has been performed.
+ *
+ *  @param context The context of a @c dispatch_*_f task or the block.
+ *  @param work    The function of a @c dispatch_*_f task or @c NULL if the task is a block.
+ */
+- (void)grey_dispatchSyncTrackedTaskWithContext:(void *)context work:(dispatch_function_t)work {
   atomic_fetch_add(&_pendingBlocks, 1);
-  grey_original_dispatch_sync(_dispatchQueue, ^{
-    work(context);
-    atomic_fetch_sub(&_pendingBlocks, 1);
-  });
+  GREYTrackedTask task = { (__bridge void *)self, work, context };
+  grey_original_dispatch_sync_f(_dispatchQueue, &task, grey_performSyncTrackedTask);
 }
 
 @end
@@ -64,6 +64,26 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic) CFTimeInterval maxSleepInterval;
 
+/**
+ *  The time in seconds that the current thread is first allowed to sleep while running in the
+ *  active mode that we started spinning. Default is 0, which allows sleeping for up to
+ *  @c maxSleepInterval from the start.
+ *
+ *  If greater than 0, the allowed sleep time starts at @c initialSleepInterval and doubles every
+ *  time the run loop is woken up to check the stop condition, up to @c maxSleepInterval. This keeps
+ *  the stop condition checked often right after spinning starts without keeping the thread busy if
+ *  it stays unmet. Has no effect if @c maxSleepInterval is 0.
+ */
+@property(nonatomic) CFTimeInterval initialSleepInterval;
+
+/**
+ *  This block is invoked before the run loop goes to sleep in the active mode when
+ *  @c maxSleepInterval is greater than 0 and the stop condition isn't met. If it returns @c NO,
+ *  the run loop is woken up right away as though @c maxSleepInterval were 0. Default is @c nil,
+ *  which always allows the run loop to sleep.
+ */
+@property(copy, nonatomic, nullable) BOOL (^sleepConditionBlock)(void);
+
 /**
  *  The minimum number of times that the run loop should be drained in the active mode before
  *  checking the stop condition. Default is 2.
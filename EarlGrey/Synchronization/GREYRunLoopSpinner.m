@@ -26,13 +26,33 @@
  */
 static const NSUInteger kDefaultMinRunLoopDrains = 2;
 
-/**
- *  No-op timer handler block.
- */
-static void (^noopTimerHandler)(CFRunLoopTimerRef timer) = ^(CFRunLoopTimerRef timer){};
-
 @implementation GREYRunLoopSpinner {
   BOOL _spinning;
+  /**
+   *  The stop condition of the current spin.
+   */
+  BOOL (^_stopConditionBlock)(void);
+  /**
+   *  Whether the stop condition was met while draining the active mode.
+   */
+  BOOL _conditionMet;
+  /**
+   *  The mode that the condition checking observer and the wake up timer were added to, or @c nil
+   *  if they haven't been. They are kept across drains for as long as the active mode is the same.
+   */
+  NSString *_observedMode;
+  /**
+   *  The observer checking the stop condition in @c _observedMode.
+   */
+  CFRunLoopObserverRef _conditionCheckingObserver;
+  /**
+   *  The timer waking up the run loop in @c _observedMode, if sleeping is bounded.
+   */
+  CFRunLoopTimerRef _wakeUpTimer;
+  /**
+   *  The time that the run loop is currently allowed to sleep before the wake up timer fires.
+   */
+  CFTimeInterval _currentSleepInterval;
 }
 
 - (instancetype)init {
@@ -53,15 +73,22 @@ static void (^noopTimerHandler)(CFRunLoopTimerRef timer) = ^(CFRunLoopTimerRef t
   BOOL stopConditionMet = [self grey_checkConditionInActiveMode:stopConditionBlock];
   CFTimeInterval remainingTime = [self grey_secondsUntilTime:timeoutTime];
 
-  while (!stopConditionMet && remainingTime > 0) {
-    @autoreleasepool {
-      stopConditionMet = [self grey_drainRunLoopInActiveModeAndCheckCondition:stopConditionBlock
-                                                                      forTime:remainingTime];
-      remainingTime = [self grey_secondsUntilTime:timeoutTime];
+  _stopConditionBlock = stopConditionBlock;
+  _currentSleepInterval = _initialSleepInterval > 0 ? MIN(_initialSleepInterval, _maxSleepInterval)
+                                                    : _maxSleepInterval;
+  @try {
+    while (!stopConditionMet && remainingTime > 0) {
+      @autoreleasepool {
+        stopConditionMet =
+            [self grey_drainRunLoopInActiveModeAndCheckConditionForTime:remainingTime];
+        remainingTime = [self grey_secondsUntilTime:timeoutTime];
+      }
     }
+  } @finally {
+    [self grey_teardownConditionChecking];
+    _stopConditionBlock = nil;
+    _spinning = NO;
   }
-
-  _spinning = NO;
   return stopConditionMet;
 }
 
@@ -116,29 +143,52 @@ static void (^noopTimerHandler)(CFRunLoopTimerRef timer) = ^(CFRunLoopTimerRef t
  *  out, the run loop finishes, or the run loop is stopped by someone else. Checks the stop
  *  condition at least once per run loop drain.
  *
- *  @param stopConditionBlock The condition block that should be checked to determine if we should
- *                            stop initiating drains in the active mode.
- *  @param time               The timeout time after which we should stop initiating drains.
+ *  The observer checking the stop condition and the wake up timer are only set up again if the
+ *  active mode has changed since the last call.
+ *
+ *  @param time The timeout time after which we should stop initiating drains.
  *
  *  @return @c YES if the condition block was evaluated to YES while draining or after the active
  *          run loop finished; @c NO otherwise.
  */
-- (BOOL)grey_drainRunLoopInActiveModeAndCheckCondition:(BOOL (^)(void))stopConditionBlock
-                                               forTime:(CFTimeInterval)time {
+- (BOOL)grey_drainRunLoopInActiveModeAndCheckConditionForTime:(CFTimeInterval)time {
   NSString *activeMode = [self grey_activeRunLoopMode];
-  CFRunLoopTimerRef wakeUpTimer = [self grey_setupWakeUpTimerInMode:activeMode];
-  __block BOOL conditionMet = NO;
+  if (![activeMode isEqualToString:_observedMode]) {
+    [self grey_teardownConditionChecking];
+    [self grey_setupConditionCheckingInMode:activeMode];
+  }
+  _conditionMet = NO;
+
+  CFRunLoopRunResult result = CFRunLoopRunInMode((CFStringRef)activeMode, time, false);
+
+  // Running a run loop mode will finish if that mode has no sources or timers. In that case,
+  // the observer callbacks will not get called, so we need to check the condition here.
+  if (result == kCFRunLoopRunFinished) {
+    GREYFatalAssertWithMessage(!_conditionMet,
+                               @"If the running the active mode returned finished, the condition "
+                               @"should not have been met.");
+    _conditionMet = [self grey_checkConditionInActiveMode:_stopConditionBlock];
+  }
+  return _conditionMet;
+}
+
+/**
+ *  Adds the observer checking the stop condition and the wake up timer to @c mode.
+ *
+ *  @param mode The mode that the observer and the timer should be added to.
+ */
+- (void)grey_setupConditionCheckingInMode:(NSString *)mode {
   __weak __typeof__(self) weakSelf = self;
 
   void (^beforeSourcesConditionCheckBlock)(void) = ^{
     __typeof__(self) strongSelf = weakSelf;
     GREYFatalAssertWithMessage(strongSelf, @"The spinner should not have been deallocated.");
 
-    if (stopConditionBlock()) {
+    if (strongSelf->_stopConditionBlock()) {
       if ([strongSelf conditionMetHandler]) {
         [strongSelf conditionMetHandler]();
       }
-      conditionMet = YES;
+      strongSelf->_conditionMet = YES;
       CFRunLoopStop(CFRunLoopGetCurrent());
     }
   };
@@ -147,46 +197,49 @@ static void (^noopTimerHandler)(CFRunLoopTimerRef timer) = ^(CFRunLoopTimerRef t
     __typeof__(self) strongSelf = weakSelf;
     GREYFatalAssertWithMessage(strongSelf, @"The spinner should not have been deallocated.");
 
-    if (strongSelf.maxSleepInterval == 0) {
-      CFRunLoopWakeUp(CFRunLoopGetCurrent());
-    }
-
     // This observer callback is not guaranteed to be called, but we must also check if we should
     // stop the run loop here because we do not want the run loop to go to sleep if we should stop
     // the run loop. A source handled in the last drain may have satisfied the stop condition.
     //
-    // Do not check _stopConditionBlock if _stopConditionMet is already true. This will occur if we
+    // Do not check _stopConditionBlock if _conditionMet is already true. This will occur if we
     // stopped the run loop in the BeforeSources handler. In this case, we do not want to check the
     // stop condition again.
-    if (!conditionMet && stopConditionBlock()) {
+    if (!strongSelf->_conditionMet && strongSelf->_stopConditionBlock()) {
       if ([strongSelf conditionMetHandler]) {
         [strongSelf conditionMetHandler]();
       }
-      conditionMet = YES;
+      strongSelf->_conditionMet = YES;
       CFRunLoopStop(CFRunLoopGetCurrent());
+    } else if (!strongSelf->_conditionMet) {
+      // Keep the run loop from sleeping unless sleeping is allowed. Waking it up after the stop
+      // condition is checked lets the sleep condition rely on the stop condition not being met.
+      BOOL (^sleepConditionBlock)(void) = strongSelf.sleepConditionBlock;
+      if (strongSelf.maxSleepInterval == 0 || (sleepConditionBlock && !sleepConditionBlock())) {
+        CFRunLoopWakeUp(CFRunLoopGetCurrent());
+      }
     }
   };
 
-  CFRunLoopObserverRef conditionCheckingObserver =
-      [self grey_setupObserverInMode:activeMode
+  _conditionCheckingObserver =
+      [self grey_setupObserverInMode:mode
               withBeforeSourcesBlock:beforeSourcesConditionCheckBlock
                   beforeWaitingBlock:beforeWaitingConditionCheckBlock];
+  _wakeUpTimer = [self grey_setupWakeUpTimerInMode:mode];
+  _observedMode = mode;
+}
 
-  CFRunLoopRunResult result = CFRunLoopRunInMode((CFStringRef)activeMode, time, false);
-
-  // Running a run loop mode will finish if that mode has no sources or timers. In that case,
-  // the observer callbacks will not get called, so we need to check the condition here.
-  if (result == kCFRunLoopRunFinished) {
-    GREYFatalAssertWithMessage(!conditionMet,
-                               @"If the running the active mode returned finished, the condition "
-                               @"should not have been met.");
-    conditionMet = [self grey_checkConditionInActiveMode:stopConditionBlock];
+/**
+ *  Removes the observer checking the stop condition and the wake up timer from the mode they were
+ *  added to, if any.
+ */
+- (void)grey_teardownConditionChecking {
+  if (_observedMode) {
+    [self grey_teardownObserver:_conditionCheckingObserver inMode:_observedMode];
+    [self grey_teardownTimer:_wakeUpTimer inMode:_observedMode];
+    _conditionCheckingObserver = NULL;
+    _wakeUpTimer = NULL;
+    _observedMode = nil;
   }
-
-  [self grey_teardownObserver:conditionCheckingObserver inMode:activeMode];
-  [self grey_teardownTimer:wakeUpTimer inMode:activeMode];
-
-  return conditionMet;
 }
 
 /**
@@ -288,8 +341,9 @@ static void (^noopTimerHandler)(CFRunLoopTimerRef timer) = ^(CFRunLoopTimerRef t
 
 /**
  *  Create and return a wake up timer in @c mode. Will not add a timer if @c maxSleepInterval
- *  is 0. The wake up timer will fire every @c maxSleepInterval to keep the run loop from sleeping
- *  more than @c maxSleepInterval while running in @c mode.
+ *  is 0. The wake up timer will fire every @c _currentSleepInterval to keep the run loop from
+ *  sleeping longer than that while running in @c mode, doubling the interval every time it fires
+ *  until it reaches @c maxSleepInterval.
  *
  *  @param mode The mode that the timer should be added to.
  *
@@ -297,13 +351,18 @@ static void (^noopTimerHandler)(CFRunLoopTimerRef timer) = ^(CFRunLoopTimerRef t
  */
 - (CFRunLoopTimerRef)grey_setupWakeUpTimerInMode:(NSString *)mode {
   if (_maxSleepInterval > 0) {
+    __weak __typeof__(self) weakSelf = self;
+    void (^wakeUpTimerHandler)(CFRunLoopTimerRef timer) = ^(CFRunLoopTimerRef timer) {
+      __typeof__(self) strongSelf = weakSelf;
+      [strongSelf grey_backOffWakeUpTimer:timer];
+    };
     CFRunLoopTimerRef timer =
         CFRunLoopTimerCreateWithHandler(kCFAllocatorDefault,
-                                        CFAbsoluteTimeGetCurrent() + _maxSleepInterval,
+                                        CFAbsoluteTimeGetCurrent() + _currentSleepInterval,
                                         _maxSleepInterval,
                                         0,
                                         0,
-                                        noopTimerHandler);
+                                        wakeUpTimerHandler);
     CFRunLoopAddTimer(CFRunLoopGetCurrent(), timer, (CFStringRef)mode);
     return timer;
   } else {
@@ -311,6 +370,18 @@ static void (^noopTimerHandler)(CFRunLoopTimerRef timer) = ^(CFRunLoopTimerRef t
   }
 }
 
+/**
+ *  Doubles the interval after which @c timer fires next, up to @c maxSleepInterval.
+ *
+ *  @param timer The wake up timer that just fired.
+ */
+- (void)grey_backOffWakeUpTimer:(CFRunLoopTimerRef)timer {
+  if (_currentSleepInterval < _maxSleepInterval) {
+    _currentSleepInterval = MIN(_currentSleepInterval * 2, _maxSleepInterval);
+    CFRunLoopTimerSetNextFireDate(timer, CFAbsoluteTimeGetCurrent() + _currentSleepInterval);
+  }
+}
+
 /**
  *  Remove @c observer from @c mode and then release it.
  *
@@ -370,6 +441,12 @@ static void (^noopTimerHandler)(CFRunLoopTimerRef timer) = ^(CFRunLoopTimerRef t
   _maxSleepInterval = maxSleepInterval;
 }
 
+- (void)setInitialSleepInterval:(CFTimeInterval)initialSleepInterval {
+  GREYFatalAssertWithMessage(initialSleepInterval >= 0,
+                             @"Initial sleep interval must be non-negative.");
+  _initialSleepInterval = initialSleepInterval;
+}
+
 - (void)setTimeout:(CFTimeInterval)timeout {
   GREYFatalAssertWithMessage(timeout >= 0, @"Timeout must be non-negative.");
   _timeout = timeout;
@@ -0,0 +1,86 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#import <Foundation/Foundation.h>
+
+@protocol GREYIdlingResource;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  The name of the file the synchronization profile of a test is written to.
+ */
+extern NSString *const kGREYSyncProfileFileName;
+
+/**
+ *  Records how long GREYUIThreadExecutor waits on idling resources while synchronizing, so that
+ *  slow tests can be traced back to the resources holding them.
+ *
+ *  Every time the executor checks whether the app is idle, the time elapsed since the previous
+ *  check is charged to the resource that was found busy by that check. As the executor stops at the
+ *  first busy resource, that is the resource currently holding the synchronization. Time spent
+ *  waiting on GREYAppStateTracker is charged to each of the app states that are set.
+ *
+ *  The time each synchronization waited on each resource is aggregated into histograms, which are
+ *  written as JSON to @c kGREYSyncProfileFileName in the test outputs directory when a test
+ *  finishes.
+ *
+ *  @remark All methods must be called on the main thread.
+ */
+@interface GREYSyncProfiler : NSObject
+
+/**
+ *  @return The unique shared instance of the GREYSyncProfiler.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ *  @remark init is not an available initializer. Use the other initializers.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ *  Starts profiling a synchronization. Synchronizations can be nested, in which case the inner one
+ *  is profiled separately and its wait isn't charged to the outer one.
+ */
+- (void)beginSynchronization;
+
+/**
+ *  Records the result of checking whether the app is idle for the current synchronization.
+ *
+ *  @param resource The first resource found busy, or @c nil if all resources are idle.
+ */
+- (void)recordBusyResource:(id<GREYIdlingResource> _Nullable)resource;
+
+/**
+ *  Finishes profiling the current synchronization and adds its wait times to the histograms.
+ */
+- (void)endSynchronization;
+
+/**
+ *  @return A JSON object with the histograms of the wait times recorded since the last reset.
+ */
+- (NSDictionary<NSString *, id> *)report;
+
+/**
+ *  Discards all wait times recorded so far.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
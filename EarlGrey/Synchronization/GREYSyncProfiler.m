@@ -0,0 +1,315 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#import "Synchronization/GREYSyncProfiler.h"
+
+#import <QuartzCore/QuartzCore.h>
+
+#import "Additions/XCTestCase+GREYAdditions.h"
+#import "AppSupport/GREYIdlingResource.h"
+#import "Common/GREYFatalAsserts.h"
+#import "Synchronization/GREYAppStateTracker.h"
+
+// Extern.
+NSString *const kGREYSyncProfileFileName = @"sync_profile.json";
+
+/**
+ *  The number of buckets in the wait time histograms.
+ */
+#define GREY_SYNC_PROFILER_BUCKET_COUNT 16
+
+/**
+ *  The lower bounds, in seconds, of the buckets in the wait time histograms. Each bucket counts
+ *  the waits that are at least as long as its lower bound and shorter than the next one's.
+ */
+static const CFTimeInterval kBucketLowerBounds[GREY_SYNC_PROFILER_BUCKET_COUNT] = {
+  0, 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1, 2, 5, 10, 20, 50,
+};
+
+#pragma mark - GREYSyncWaitStatistics
+
+/**
+ *  Aggregates the wait times of a single resource, or of the synchronizations themselves.
+ */
+@interface GREYSyncWaitStatistics : NSObject
+
+/**
+ *  Adds @c seconds to the statistics.
+ *
+ *  @param seconds The time waited by a single synchronization.
+ */
+- (void)addWait:(CFTimeInterval)seconds;
+
+/**
+ *  @return A JSON object with the number of waits, their total and maximum duration and their
+ *          histogram.
+ */
+- (NSDictionary<NSString *, id> *)report;
+
+@end
+
+@implementation GREYSyncWaitStatistics {
+  NSUInteger _count;
+  CFTimeInterval _totalSeconds;
+  CFTimeInterval _maxSeconds;
+  NSUInteger _bucketCounts[GREY_SYNC_PROFILER_BUCKET_COUNT];
+}
+
+- (void)addWait:(CFTimeInterval)seconds {
+  NSUInteger bucket = GREY_SYNC_PROFILER_BUCKET_COUNT - 1;
+  while (bucket > 0 && seconds < kBucketLowerBounds[bucket]) {
+    bucket--;
+  }
+  _bucketCounts[bucket]++;
+  _count++;
+  _totalSeconds += seconds;
+  _maxSeconds = MAX(_maxSeconds, seconds);
+}
+
+- (NSDictionary<NSString *, id> *)report {
+  NSMutableArray *histogram = [[NSMutableArray alloc] init];
+  for (NSUInteger i = 0; i < GREY_SYNC_PROFILER_BUCKET_COUNT; i++) {
+    [histogram addObject:@{ @"minSeconds" : @(kBucketLowerBounds[i]),
+                            @"count" : @(_bucketCounts[i]) }];
+  }
+  return @{ @"count" : @(_count),
+            @"totalSeconds" : @(_totalSeconds),
+            @"maxSeconds" : @(_maxSeconds),
+            @"histogram" : histogram };
+}
+
+@end
+
+#pragma mark - GREYSyncProfilerFrame
+
+/**
+ *  The state of a synchronization that is being profiled.
+ */
+@interface GREYSyncProfilerFrame : NSObject
+
+/**
+ *  The time at which the synchronization started.
+ */
+@property(nonatomic, assign) CFTimeInterval startTime;
+
+/**
+ *  The time at which the app was last checked for idleness.
+ */
+@property(nonatomic, assign) CFTimeInterval lastCheckTime;
+
+/**
+ *  The time at which the app was first found idle, or 0 if it hasn't been yet.
+ */
+@property(nonatomic, assign) CFTimeInterval idleTime;
+
+/**
+ *  The labels to which the time since the last check is charged.
+ */
+@property(nonatomic, copy) NSArray<NSString *> *busyLabels;
+
+/**
+ *  The time waited on each label so far.
+ */
+@property(nonatomic, readonly) NSMutableDictionary<NSString *, NSNumber *> *waits;
+
+@end
+
+@implementation GREYSyncProfilerFrame
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _waits = [[NSMutableDictionary alloc] init];
+  }
+  return self;
+}
+
+@end
+
+#pragma mark - GREYSyncProfiler
+
+@implementation GREYSyncProfiler {
+  /**
+   *  The synchronizations being profiled, the innermost one being last.
+   */
+  NSMutableArray<GREYSyncProfilerFrame *> *_frames;
+  /**
+   *  The statistics of the time waited by whole synchronizations.
+   */
+  GREYSyncWaitStatistics *_synchronizationStatistics;
+  /**
+   *  The statistics of the time waited on each resource, keyed by label.
+   */
+  NSMutableDictionary<NSString *, GREYSyncWaitStatistics *> *_resourceStatistics;
+}
+
++ (instancetype)sharedInstance {
+  static GREYSyncProfiler *instance = nil;
+  static dispatch_once_t token = 0;
+  dispatch_once(&token, ^{
+    instance = [[GREYSyncProfiler alloc] initOnce];
+  });
+  return instance;
+}
+
+/**
+ *  Initializes the profiler. Not thread-safe. Must be invoked under a race-free synchronized
+ *  environment by the caller.
+ *
+ *  @return The initialized instance.
+ */
+- (instancetype)initOnce {
+  self = [super init];
+  if (self) {
+    _frames = [[NSMutableArray alloc] init];
+    [self reset];
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(grey_testCaseDidFinish:)
+                                                 name:kGREYXCTestCaseInstanceDidFinish
+                                               object:nil];
+  }
+  return self;
+}
+
+- (void)beginSynchronization {
+  GREYFatalAssertMainThread();
+  GREYSyncProfilerFrame *frame = [[GREYSyncProfilerFrame alloc] init];
+  frame.startTime = CACurrentMediaTime();
+  frame.lastCheckTime = frame.startTime;
+  [_frames addObject:frame];
+}
+
+- (void)recordBusyResource:(id<GREYIdlingResource>)resource {
+  GREYFatalAssertMainThread();
+  GREYSyncProfilerFrame *frame = [_frames lastObject];
+  GREYFatalAssertWithMessage(frame, @"No synchronization is being profiled.");
+
+  CFTimeInterval now = CACurrentMediaTime();
+  [self grey_chargeTimeUntil:now toFrame:frame];
+  if (resource) {
+    frame.busyLabels = [self grey_labelsForResource:resource];
+  } else {
+    frame.busyLabels = nil;
+    if (frame.idleTime == 0) {
+      frame.idleTime = now;
+    }
+  }
+}
+
+- (void)endSynchronization {
+  GREYFatalAssertMainThread();
+  GREYSyncProfilerFrame *frame = [_frames lastObject];
+  GREYFatalAssertWithMessage(frame, @"No synchronization is being profiled.");
+
+  CFTimeInterval now = CACurrentMediaTime();
+  [self grey_chargeTimeUntil:now toFrame:frame];
+  [_frames removeLastObject];
+  // The time spent in a nested synchronization has been charged to it, not to the outer one.
+  GREYSyncProfilerFrame *outerFrame = [_frames lastObject];
+  outerFrame.lastCheckTime += now - frame.startTime;
+
+  CFTimeInterval endTime = frame.idleTime > 0 ? frame.idleTime : now;
+  [_synchronizationStatistics addWait:endTime - frame.startTime];
+  [frame.waits enumerateKeysAndObjectsUsingBlock:^(NSString *label,
+                                                   NSNumber *seconds,
+                                                   BOOL *stop) {
+    GREYSyncWaitStatistics *statistics = _resourceStatistics[label];
+    if (!statistics) {
+      statistics = [[GREYSyncWaitStatistics alloc] init];
+      _resourceStatistics[label] = statistics;
+    }
+    [statistics addWait:[seconds doubleValue]];
+  }];
+}
+
+- (NSDictionary<NSString *, id> *)report {
+  NSMutableDictionary *resources = [[NSMutableDictionary alloc] init];
+  [_resourceStatistics enumerateKeysAndObjectsUsingBlock:^(NSString *label,
+                                                           GREYSyncWaitStatistics *statistics,
+                                                           BOOL *stop) {
+    resources[label] = [statistics report];
+  }];
+  return @{ @"synchronizations" : [_synchronizationStatistics report],
+            @"resources" : resources };
+}
+
+- (void)reset {
+  _synchronizationStatistics = [[GREYSyncWaitStatistics alloc] init];
+  _resourceStatistics = [[NSMutableDictionary alloc] init];
+}
+
+#pragma mark - Private
+
+/**
+ *  Charges the time from the last check of @c frame until @c time to the labels that were busy,
+ *  and makes @c time the last check time of @c frame.
+ *
+ *  @param time  The current time.
+ *  @param frame The synchronization whose wait is being recorded.
+ */
+- (void)grey_chargeTimeUntil:(CFTimeInterval)time toFrame:(GREYSyncProfilerFrame *)frame {
+  CFTimeInterval elapsed = time - frame.lastCheckTime;
+  if (elapsed > 0) {
+    for (NSString *label in frame.busyLabels) {
+      frame.waits[label] = @([frame.waits[label] doubleValue] + elapsed);
+    }
+  }
+  frame.lastCheckTime = time;
+}
+
+/**
+ *  @return The labels that time spent waiting on @c resource is charged to.
+ */
+- (NSArray<NSString *> *)grey_labelsForResource:(id<GREYIdlingResource>)resource {
+  NSString *name = [resource idlingResourceName];
+  if (![resource isKindOfClass:[GREYAppStateTracker class]]) {
+    return @[ name ];
+  }
+  GREYAppState state = [(GREYAppStateTracker *)resource currentState];
+  if (state == kGREYIdle) {
+    return @[ name ];
+  }
+  NSMutableArray *labels = [[NSMutableArray alloc] init];
+  while (state) {
+    GREYAppState bit = state & ~(state - 1);
+    state &= state - 1;
+    NSString *stateName = [(GREYAppStateTracker *)resource grey_nameOfState:bit];
+    [labels addObject:[NSString stringWithFormat:@"%@ (%@)", name, stateName]];
+  }
+  return labels;
+}
+
+/**
+ *  Writes the profile of the test that finished to its outputs directory and starts profiling the
+ *  next test from scratch.
+ *
+ *  @param notification The notification posted when the test finished.
+ */
+- (void)grey_testCaseDidFinish:(NSNotification *)notification {
+  XCTestCase *testCase = notification.userInfo[kGREYXCTestCaseNotificationKey];
+  NSDictionary *report = [self report];
+  BOOL hasSynchronizations = [report[@"synchronizations"][@"count"] unsignedIntegerValue] > 0;
+  [self reset];
+  if (!hasSynchronizations || !testCase) {
+    return;
+  }
+  [testCase grey_writeJSONObject:report
+          toTestOutputsFileNamed:kGREYSyncProfileFileName
+                         options:NSJSONWritingPrettyPrinted];
+}
+
+@end
@@ -134,6 +134,16 @@ typedef void(^GREYExecBlock)(void);
                          block:(_Nullable GREYExecBlock)execBlock
                          error:(__strong NSError *_Nullable *_Nullable)errorOrNil;
 
+/**
+ *  Signals that an idling resource has gone from busy to idle, waking up the main thread if it is
+ *  sleeping while waiting for the app to idle. Must be called by idling resources that return
+ *  @c YES from GREYIdlingResource::signalsIdleTransitions.
+ *
+ *  @remark It is safe to call this from any thread. It does not block and is cheap to call when
+ *          the main thread isn't waiting for the app to idle.
+ */
+- (void)signalIdleTransition;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -16,10 +16,13 @@
 
 #import "Synchronization/GREYUIThreadExecutor.h"
 
+#include <stdatomic.h>
+
 #import "Additions/NSError+GREYAdditions.h"
 #import "Additions/UIApplication+GREYAdditions.h"
 #import "Additions/XCTestCase+GREYAdditions.h"
 #import "AppSupport/GREYIdlingResource.h"
+#import "Common/GREYConfiguration+Internal.h"
 #import "Common/GREYConfiguration.h"
 #import "Common/GREYConstants.h"
 #import "Common/GREYDefines.h"
@@ -28,10 +31,12 @@
 #import "Common/GREYLogger.h"
 #import "Common/GREYStopwatch.h"
 #import "Common/GREYThrowDefines.h"
+#import "Common/GREYTracer.h"
 #import "Synchronization/GREYAppStateTracker.h"
 #import "Synchronization/GREYDispatchQueueIdlingResource.h"
 #import "Synchronization/GREYOperationQueueIdlingResource.h"
 #import "Synchronization/GREYRunLoopSpinner.h"
+#import "Synchronization/GREYSyncProfiler.h"
 
 // Extern.
 NSString *const kGREYUIThreadExecutorErrorDomain =
@@ -85,6 +90,12 @@ typedef NS_ENUM(NSInteger, GREYExecutionState) {
    *  Idling resources that are monitored by default and cannot be deregistered.
    */
   NSOrderedSet *_defaultIdlingResources;
+
+  /**
+   *  The number of synchronizations in progress that let the main thread sleep until an idling
+   *  resource signals its transition to idle.
+   */
+  atomic_int _idleTransitionWaiters;
 }
 
 + (instancetype)sharedInstance {
@@ -204,12 +215,15 @@ typedef NS_ENUM(NSInteger, GREYExecutionState) {
   GREYFatalAssertMainThread();
   GREYThrowOnFailedCondition(seconds >= 0);
 
-  BOOL isSynchronizationEnabled = GREY_CONFIG_BOOL(kGREYConfigKeySynchronizationEnabled);
+  BOOL isSynchronizationEnabled = GREY_CONFIG_SNAPSHOT(synchronizationEnabled);
   GREYRunLoopSpinner *runLoopSpinner = [[GREYRunLoopSpinner alloc] init];
+  // The wait ends when the condition is met, which is before @c execBlock is executed.
+  __block GREYTraceSpan syncWaitSpan = GREYTraceBegin(kGREYTraceSpanSyncWait);
   // It is important that we execute @c execBlock in the active run loop mode, which is guaranteed
   // by the run loop spinner's condition met handler. We want actions and other events to execute
   // in the mode that they would without EarlGrey's run loop control.
   runLoopSpinner.conditionMetHandler = ^{
+    GREYTraceEnd(&syncWaitSpan);
     @autoreleasepool {
       if (execBlock) {
         execBlock();
@@ -219,14 +233,53 @@ typedef NS_ENUM(NSInteger, GREYExecutionState) {
 
   if (isSynchronizationEnabled) {
     runLoopSpinner.timeout = seconds;
+    BOOL sleepsUntilIdleTransition = NO;
     if (self.forceBusyPolling) {
       runLoopSpinner.maxSleepInterval = kMaximumSynchronizationSleepInterval;
+    } else if (GREY_CONFIG_BOOL(kGREYConfigKeyIdleTransitionSignalingEnabled)) {
+      // Busy resources that signal their transitions to idle wake the main thread up. The sleep
+      // interval only bounds how long a transition that wasn't signaled can go unnoticed.
+      sleepsUntilIdleTransition = YES;
+      runLoopSpinner.maxSleepInterval = kMaximumSynchronizationSleepInterval;
+      runLoopSpinner.sleepConditionBlock = ^BOOL {
+        return [self grey_canSleepUntilIdleTransition];
+      };
+      atomic_fetch_add(&_idleTransitionWaiters, 1);
+    } else if (GREY_CONFIG_DOUBLE(kGREYConfigKeySynchronizationBackoffInitialInterval) > 0) {
+      // Poll tightly right after the synchronization starts, when the app usually idles, and back
+      // off to longer sleeps while it stays busy.
+      runLoopSpinner.initialSleepInterval =
+          GREY_CONFIG_DOUBLE(kGREYConfigKeySynchronizationBackoffInitialInterval);
+      runLoopSpinner.maxSleepInterval =
+          GREY_CONFIG_DOUBLE(kGREYConfigKeySynchronizationBackoffMaxInterval);
     }
 
-    // Spin the run loop until the all of the resources are idle or until @c seconds.
-    BOOL isAppIdle = [runLoopSpinner spinWithStopConditionBlock:^BOOL {
+    BOOL (^stopConditionBlock)(void) = ^BOOL {
       return [self grey_areAllResourcesIdle];
-    }];
+    };
+    GREYSyncProfiler *profiler = nil;
+    if (GREY_CONFIG_BOOL(kGREYConfigKeySyncProfilingEnabled)) {
+      profiler = [GREYSyncProfiler sharedInstance];
+      stopConditionBlock = ^BOOL {
+        NSOrderedSet *busyResources = [self grey_busyResourcesReturnEarly:YES];
+        id<GREYIdlingResource> busyResource = [busyResources firstObject];
+        [profiler recordBusyResource:busyResource];
+        return busyResource == nil;
+      };
+      [profiler beginSynchronization];
+    }
+
+    // Spin the run loop until the all of the resources are idle or until @c seconds.
+    BOOL isAppIdle;
+    @try {
+      isAppIdle = [runLoopSpinner spinWithStopConditionBlock:stopConditionBlock];
+    } @finally {
+      if (sleepsUntilIdleTransition) {
+        atomic_fetch_sub(&_idleTransitionWaiters, 1);
+      }
+      [profiler endSynchronization];
+      GREYTraceEnd(&syncWaitSpan);
+    }
 
     if (!isAppIdle) {
       NSOrderedSet *busyResources = [self grey_busyResources];
@@ -256,6 +309,15 @@ typedef NS_ENUM(NSInteger, GREYExecutionState) {
   }
 }
 
+- (void)signalIdleTransition {
+  // The waiter count is incremented before the main thread checks whether resources are busy, so
+  // a resource that goes idle after being found busy sees it. Should the wake up still be missed,
+  // the main thread sleeps no longer than kMaximumSynchronizationSleepInterval.
+  if (atomic_load(&_idleTransitionWaiters) > 0) {
+    CFRunLoopWakeUp(CFRunLoopGetMain());
+  }
+}
+
 #pragma mark - Package Internal
 
 - (void)registerIdlingResource:(id<GREYIdlingResource>)resource {
@@ -350,6 +412,29 @@ typedef NS_ENUM(NSInteger, GREYExecutionState) {
   }
 }
 
+/**
+ *  @return @c YES if at least one of the registered and default idling resources is busy and all of
+ *          the busy ones signal their transitions to idle, @c NO otherwise.
+ */
+- (BOOL)grey_canSleepUntilIdleTransition {
+  @synchronized(_registeredIdlingResources) {
+    BOOL isAnyResourceBusy = NO;
+    NSArray *allResources = @[ [_registeredIdlingResources copy], _defaultIdlingResources ];
+    for (NSOrderedSet *resources in allResources) {
+      for (id<GREYIdlingResource> resource in resources) {
+        if (![resource isIdleNow]) {
+          if (![resource respondsToSelector:@selector(signalsIdleTransitions)] ||
+              ![resource signalsIdleTransitions]) {
+            return NO;
+          }
+          isAnyResourceBusy = YES;
+        }
+      }
+    }
+    return isAnyResourceBusy;
+  }
+}
+
 /**
  *  @return An error description string for all of the resources in @c busyResources.
  */
@@ -63,6 +63,17 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSArray *)exploreImmediateChildren:(id)element;
 
+/**
+ *  Explores the immediate children of the @c element that is passed in and adds them to
+ *  @c immediateChildren, in the same order as GREYTraversal::exploreImmediateChildren: returns
+ *  them. This allows traversals to reuse a single set for every element in the hierarchy.
+ *
+ *  @param element           The UI element whose children are to be explored.
+ *  @param immediateChildren An empty ordered set to which the children of @c element are added.
+ */
+- (void)exploreImmediateChildren:(id)element
+                  intoOrderedSet:(NSMutableOrderedSet *)immediateChildren;
+
 @end
 
 NS_ASSUME_NONNULL_END
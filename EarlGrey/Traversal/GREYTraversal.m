@@ -29,9 +29,15 @@
 @implementation GREYTraversal
 
 - (NSArray *)exploreImmediateChildren:(id)element {
-  GREYThrowOnNilParameter(element);
-
   NSMutableOrderedSet *immediateChildren = [[NSMutableOrderedSet alloc] init];
+  [self exploreImmediateChildren:element intoOrderedSet:immediateChildren];
+  return [immediateChildren array];
+}
+
+- (void)exploreImmediateChildren:(id)element
+                  intoOrderedSet:(NSMutableOrderedSet *)immediateChildren {
+  GREYThrowOnNilParameter(element);
+  GREYThrowOnNilParameter(immediateChildren);
 
   if ([element isKindOfClass:[UIView class]]) {
     // Grab all subviews so that we continue traversing the entire hierarchy.
@@ -81,8 +87,6 @@
       }
     }
   }
-
-  return [immediateChildren array];
 }
 
 @end
@@ -18,7 +18,12 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@interface GREYTraversalBFS : GREYTraversal
+/**
+ *  Traverses a UI hierarchy in a Breadth First Search fashion. Besides
+ *  GREYTraversalBFS::nextObject, the traversal supports fast enumeration, which hands out the
+ *  elements in batches. Like an NSEnumerator, it can be enumerated only once.
+ */
+@interface GREYTraversalBFS : GREYTraversal<NSFastEnumeration>
 
 /**
  *  Instance method that returns the next object from the hierarchy in a Breadth First Search
@@ -38,6 +43,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (instancetype)hierarchyForElementWithBFSTraversal:(id)element;
 
+/**
+ *  Class method to initialize the object. The hierarchy is unrolled in a BFS fashion, except for
+ *  the descendants of the elements that pass @c predicate, which are not explored.
+ *
+ *  @param element   Single UI element whose UI hierarchy is to be parsed.
+ *  @param predicate A block invoked on every element that is handed out by the traversal. If it
+ *                   returns @c YES, the descendants of the element are skipped.
+ *
+ *  @return An instance of GREYTraversalBFS.
+ */
++ (instancetype)hierarchyForElementWithBFSTraversal:(id)element
+                      skippingDescendantsPassingTest:(BOOL (^_Nullable)(id element))predicate;
+
 /**
  *  Enumerates through the entire hierarchy and calls the @c block on each element in the hierarchy.
  *  This method enumerates through the hierarchy only once.
@@ -16,76 +16,207 @@
 
 #import "Traversal/GREYTraversalBFS.h"
 
+#import "Common/GREYFatalAsserts.h"
 #import "Common/GREYThrowDefines.h"
 
+/**
+ *  The initial capacity of the queue of elements to be explored. Must be a power of two.
+ */
+static const NSUInteger kGREYInitialQueueCapacity = 64;
+
 @implementation GREYTraversalBFS {
   /**
-   *  An array that contains the unrolled hierarchy.
+   *  A ring buffer of the elements that are yet to be explored. Its capacity is always a power of
+   *  two so that indices wrap around with a mask.
    */
-  NSMutableArray *_parsedHierarchy;
+  __strong id *_queue;
 
   /**
-   *  NSUInteger to keep track of the index that is being accessed in the @c _parsedHierarchy array.
+   *  The level of each element in @c _queue, stored at the same index as the element.
    */
-  NSUInteger _parsedHierarchyIndex;
+  NSUInteger *_levels;
+
+  /**
+   *  The capacity of @c _queue and @c _levels.
+   */
+  NSUInteger _capacity;
+
+  /**
+   *  The index of the next element to be explored in @c _queue.
+   */
+  NSUInteger _head;
+
+  /**
+   *  The number of elements in @c _queue.
+   */
+  NSUInteger _count;
+
+  /**
+   *  An ordered set that is reused for holding the immediate children of every explored element.
+   */
+  NSMutableOrderedSet *_children;
+
+  /**
+   *  The objects handed out by the last call to countByEnumeratingWithState:objects:count:. Fast
+   *  enumeration doesn't retain the objects it is given, so they are kept alive here until the
+   *  next batch is requested.
+   */
+  NSMutableArray *_enumeratedObjects;
+
+  /**
+   *  If set, the descendants of the elements for which this block returns @c YES are not explored.
+   */
+  BOOL (^_skipDescendantsPredicate)(id element);
 }
 
-- (instancetype)init:(id)element {
+- (instancetype)init:(id)element skippingDescendantsPassingTest:(BOOL (^)(id element))predicate {
   self = [super init];
   if (self) {
-    _parsedHierarchy = [[NSMutableArray alloc] init];
-    _parsedHierarchyIndex = 0;
-
-    GREYTraversalObject *object = [[GREYTraversalObject alloc] init];
-    [object setLevel:0];
-    [object setElement:element];
-    [_parsedHierarchy addObject:object];
+    _skipDescendantsPredicate = [predicate copy];
+    _capacity = kGREYInitialQueueCapacity;
+    _queue = (__strong id *)calloc(_capacity, sizeof(id));
+    _levels = (NSUInteger *)malloc(_capacity * sizeof(NSUInteger));
+    GREYFatalAssertWithMessage(_queue && _levels, @"Failed to allocate the traversal queue.");
+    _children = [[NSMutableOrderedSet alloc] init];
+    _enumeratedObjects = [[NSMutableArray alloc] init];
+    [self grey_enqueueElement:element level:0];
   }
   return self;
 }
 
+- (void)dealloc {
+  // Release the elements that were never explored before freeing the buffer.
+  for (NSUInteger i = 0; i < _count; i++) {
+    _queue[(_head + i) & (_capacity - 1)] = nil;
+  }
+  free(_queue);
+  free(_levels);
+}
+
 + (instancetype)hierarchyForElementWithBFSTraversal:(id)element {
+  return [self hierarchyForElementWithBFSTraversal:element skippingDescendantsPassingTest:nil];
+}
+
++ (instancetype)hierarchyForElementWithBFSTraversal:(id)element
+                      skippingDescendantsPassingTest:(BOOL (^)(id element))predicate {
   GREYThrowOnNilParameter(element);
   // Create an instance of GREYTraversalBFS object.
-  return [[GREYTraversalBFS alloc] init:element];
+  return [[GREYTraversalBFS alloc] init:element skippingDescendantsPassingTest:predicate];
 }
 
 - (id)nextObject {
-  GREYTraversalObject *nextObject = [self grey_nextObjectBFS];
-  return nextObject.element;
+  return [self grey_nextElementBFSWithLevel:NULL];
 }
 
 - (void)enumerateUsingBlock:(void (^)(id _Nonnull view, NSUInteger level))block {
-  GREYTraversalObject *object;
-  while ((object = [self grey_nextObjectBFS])) {
-    block(object.element, object.level);
+  id element;
+  NSUInteger level;
+  while ((element = [self grey_nextElementBFSWithLevel:&level])) {
+    block(element, level);
   }
 }
 
+#pragma mark - NSFastEnumeration
+
+- (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
+                                  objects:(id __unsafe_unretained _Nullable [_Nonnull])buffer
+                                    count:(NSUInteger)len {
+  if (state->state == 0) {
+    state->state = 1;
+    // The traversal has no notion of mutation, so point to a value that never changes.
+    state->mutationsPtr = &state->extra[0];
+  }
+  // The caller is done with the previous batch.
+  [_enumeratedObjects removeAllObjects];
+
+  NSUInteger count = 0;
+  id element;
+  while (count < len && (element = [self grey_nextElementBFSWithLevel:NULL])) {
+    [_enumeratedObjects addObject:element];
+    buffer[count++] = element;
+  }
+  state->itemsPtr = buffer;
+  return count;
+}
+
+#pragma mark - Private
+
 /**
- *  The method retrieves the next object in the hierarchy.
+ *  The method retrieves the next element in the hierarchy and queues its immediate children.
+ *
+ *  @param[out] outLevelOrNULL If not @c NULL, receives the level of the returned element.
  *
- *  @return Returns an instance of GREYTraversalObject.
+ *  @return The next element in the hierarchy or @c nil if all elements have been explored.
  */
-- (GREYTraversalObject *)grey_nextObjectBFS {
+- (id)grey_nextElementBFSWithLevel:(NSUInteger *)outLevelOrNULL {
   // If we have explored all elements, then we return nil.
-  if (_parsedHierarchyIndex >= [_parsedHierarchy count]) {
+  if (_count == 0) {
     return nil;
   }
 
-  GREYTraversalObject *nextObject = [_parsedHierarchy objectAtIndex:_parsedHierarchyIndex];
-  ++_parsedHierarchyIndex;
+  id nextElement = _queue[_head];
+  NSUInteger level = _levels[_head];
+  _queue[_head] = nil;
+  _head = (_head + 1) & (_capacity - 1);
+  --_count;
 
-  // Ask GREYTraversal i.e. parent class for the immediate children of @c nextObject.
-  NSArray *children = [self exploreImmediateChildren:nextObject.element];
-  for (id child in children) {
-    GREYTraversalObject *object = [[GREYTraversalObject alloc] init];
-    [object setLevel:nextObject.level + 1];
-    [object setElement:child];
-    [_parsedHierarchy addObject:object];
+  // Ask GREYTraversal i.e. parent class for the immediate children of @c nextElement. The pool
+  // releases the temporary objects created while exploring rather than leaving them to the
+  // caller's pool.
+  @autoreleasepool {
+    if (!_skipDescendantsPredicate || !_skipDescendantsPredicate(nextElement)) {
+      [_children removeAllObjects];
+      [self exploreImmediateChildren:nextElement intoOrderedSet:_children];
+      for (id child in _children) {
+        [self grey_enqueueElement:child level:level + 1];
+      }
+      [_children removeAllObjects];
+    }
   }
-  return nextObject;
+
+  if (outLevelOrNULL) {
+    *outLevelOrNULL = level;
+  }
+  return nextElement;
 }
 
-@end
+/**
+ *  Adds @c element at the back of the queue of elements to be explored, growing it if needed.
+ *
+ *  @param element The element to be added.
+ *  @param level   The level of @c element in the hierarchy.
+ */
+- (void)grey_enqueueElement:(id)element level:(NSUInteger)level {
+  if (_count == _capacity) {
+    [self grey_growQueue];
+  }
+  NSUInteger tail = (_head + _count) & (_capacity - 1);
+  _queue[tail] = element;
+  _levels[tail] = level;
+  ++_count;
+}
+
+/**
+ *  Doubles the capacity of the queue, moving the queued elements to the front of the new buffer.
+ */
+- (void)grey_growQueue {
+  NSUInteger newCapacity = _capacity * 2;
+  __strong id *newQueue = (__strong id *)calloc(newCapacity, sizeof(id));
+  NSUInteger *newLevels = (NSUInteger *)malloc(newCapacity * sizeof(NSUInteger));
+  GREYFatalAssertWithMessage(newQueue && newLevels, @"Failed to grow the traversal queue.");
+
+  for (NSUInteger i = 0; i < _count; i++) {
+    NSUInteger index = (_head + i) & (_capacity - 1);
+    newQueue[i] = _queue[index];
+    _queue[index] = nil;
+    newLevels[i] = _levels[index];
+  }
+  free(_queue);
+  free(_levels);
+  _queue = newQueue;
+  _levels = newLevels;
+  _capacity = newCapacity;
+  _head = 0;
+}
 
+@end
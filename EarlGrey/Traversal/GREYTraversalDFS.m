@@ -20,22 +20,30 @@
 
 @implementation GREYTraversalDFS {
   /**
-   *  An array that contains the unrolled hierarchy.
+   *  A stack of the objects that are yet to be explored. The top of the stack is the last object
+   *  in the array, so that pushing and popping are constant time operations.
    */
-  NSMutableArray *_parsedHierarchy;
+  NSMutableArray<GREYTraversalObject *> *_stack;
 
   /**
-   *  NSUInteger to keep track of the index that is being accessed in the @c _parsedHierarchy array.
+   *  Objects that are no longer in use and can be reused when pushing new elements on @c _stack,
+   *  so that the traversal doesn't allocate a new wrapper for every element in the hierarchy.
    */
-  NSUInteger _parsedHierarchyIndex;
+  NSMutableArray<GREYTraversalObject *> *_objectPool;
+
+  /**
+   *  The object that was last returned by grey_nextObjectDFS. It is returned to @c _objectPool on
+   *  the next call, once the caller is done with it.
+   */
+  GREYTraversalObject *_lastObject;
 }
 
 - (instancetype)init:(id)element {
   self = [super init];
   if (self) {
-    _parsedHierarchy = [[NSMutableArray alloc] init];
-    _parsedHierarchyIndex = 0;
-    [_parsedHierarchy addObject:element];
+    _stack = [[NSMutableArray alloc] init];
+    _objectPool = [[NSMutableArray alloc] init];
+    [_stack addObject:element];
   }
   return self;
 }
@@ -71,37 +79,44 @@
 #pragma mark - Private
 
 /**
- *  The method retrieves the next object in the hierarchy.
+ *  The method retrieves the next object in the hierarchy. The returned object is only valid until
+ *  the next call to this method, after which it is reused for another element.
  *
  *  @return Returns an instance of GREYTraversalDFSObject.
  */
 - (GREYTraversalObject *)grey_nextObjectDFS {
+  // The caller is done with the previously returned object, so it can be reused.
+  if (_lastObject) {
+    _lastObject.element = nil;
+    [_objectPool addObject:_lastObject];
+    _lastObject = nil;
+  }
+
   // If we have explored all elements.
-  if (_parsedHierarchyIndex >= [_parsedHierarchy count]) {
+  GREYTraversalObject *nextObject = [_stack lastObject];
+  if (!nextObject) {
     return nil;
   }
+  [_stack removeLastObject];
 
-  GREYTraversalObject *nextObject = [_parsedHierarchy objectAtIndex:_parsedHierarchyIndex];
-
-  // For the DFS algorithm, we will add to the @c _parsedHierarchy array in a specified order,
-  // and we also need to wrap the UI elements into GREYHierarchyObject instance.
-  NSArray *children =
-      [self exploreImmediateChildren:nextObject.element];
-
-  // Insert the GREYHierarchyObject instance into the front of the array. Here the array is used
-  // as a stack, hence front insertions. We could have inserted into the back, however the logic
-  // associated with @c _parsedHierarchyIndex facilitated front insertions.
+  // For the DFS algorithm, the children are pushed in reverse order so that the first child is on
+  // top of the stack and is explored next.
+  NSArray *children = [self exploreImmediateChildren:nextObject.element];
+  NSUInteger childLevel = nextObject.level + 1;
   for (id child in [children reverseObjectEnumerator]) {
-    GREYTraversalObject *object = [[GREYTraversalObject alloc] init];
-    [object setLevel:nextObject.level + 1];
+    GREYTraversalObject *object = [_objectPool lastObject];
+    if (object) {
+      [_objectPool removeLastObject];
+    } else {
+      object = [[GREYTraversalObject alloc] init];
+    }
+    [object setLevel:childLevel];
     [object setElement:child];
-    [_parsedHierarchy insertObject:object atIndex:0];
+    [_stack addObject:object];
   }
 
-  // Retain the @c nextObject since we are removing it from the array.
-  GREYTraversalObject *element = nextObject;
-  [_parsedHierarchy removeObject:nextObject];
-  return element;
+  _lastObject = nextObject;
+  return nextObject;
 }
 
 @end
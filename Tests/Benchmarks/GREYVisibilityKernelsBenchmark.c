@@ -0,0 +1,177 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/**
+ *  @file GREYVisibilityKernelsBenchmark.c
+ *  @brief Standalone benchmark for the visibility checker's pixel kernels. It checks that the
+ *  vectorized kernels produce the same results as their scalar counterparts over synthetic XRGB
+ *  buffers and reports the speedup. Build and run it from the repository root with:
+ *
+ *  @code
+ *  cc -O2 -IEarlGrey Tests/Benchmarks/GREYVisibilityKernelsBenchmark.c \
+ *      EarlGrey/Common/GREYVisibilityKernels.c -o /tmp/GREYVisibilityKernelsBenchmark
+ *  /tmp/GREYVisibilityKernelsBenchmark
+ *  @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Common/GREYVisibilityKernels.h"
+
+/**
+ *  Width and height of a full-width cell at 3x on a 414 point wide screen.
+ */
+static const size_t kWidth = 1242;
+static const size_t kHeight = 600;
+static const int kIterations = 50;
+
+/**
+ *  @return A monotonic timestamp in seconds.
+ */
+static double grey_now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+/**
+ *  Fills @c pixels with pseudo-random bytes, deterministically seeded by @c seed.
+ */
+static void grey_fillRandom(uint8_t *pixels, size_t length, uint32_t seed) {
+  for (size_t i = 0; i < length; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    pixels[i] = (uint8_t)(seed >> 24);
+  }
+}
+
+/**
+ *  Creates an after image from @c before where a random subset of pixels have their channels
+ *  perturbed by amounts on both sides of the diff tolerance.
+ */
+static void grey_perturb(const uint8_t *before, uint8_t *after, size_t pixelCount, uint32_t seed) {
+  memcpy(after, before, pixelCount * 4);
+  for (size_t i = 0; i < pixelCount; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    if ((seed >> 28) < 6) {
+      size_t channel = (seed >> 8) % 4;
+      int delta = (int)((seed >> 16) % 7) - 3;
+      after[i * 4 + channel] = (uint8_t)(after[i * 4 + channel] + delta);
+    }
+  }
+}
+
+int main(void) {
+  const size_t pixelCount = kWidth * kHeight;
+  uint8_t *before = malloc(pixelCount * 4);
+  uint8_t *after = malloc(pixelCount * 4);
+  uint8_t *shiftedScalar = malloc(pixelCount * 4);
+  uint8_t *shiftedVector = malloc(pixelCount * 4);
+  uint8_t *diffScalar = malloc(pixelCount);
+  uint8_t *diffVector = malloc(pixelCount);
+  uint32_t *histogramScalar = calloc(kWidth, sizeof(uint32_t));
+  uint32_t *histogramVector = calloc(kWidth, sizeof(uint32_t));
+  grey_fillRandom(before, pixelCount * 4, 42);
+  grey_perturb(before, after, pixelCount, 7);
+  int failures = 0;
+
+  // Parity, including odd lengths that exercise the scalar tails.
+  for (size_t length = pixelCount - 17; length <= pixelCount; length += 17) {
+    memcpy(shiftedScalar, before, length * 4);
+    memcpy(shiftedVector, before, length * 4);
+    GREYShiftPixelIntensitiesScalar(shiftedScalar, length);
+    GREYShiftPixelIntensities(shiftedVector, length);
+    if (memcmp(shiftedScalar, shiftedVector, length * 4) != 0) {
+      fprintf(stderr, "Shift mismatch for %zu pixels\n", length);
+      failures++;
+    }
+    size_t countScalar = GREYDiffPixelsScalar(before, after, length, diffScalar);
+    size_t countVector = GREYDiffPixels(before, after, length, diffVector);
+    if (countScalar != countVector || memcmp(diffScalar, diffVector, length) != 0) {
+      fprintf(stderr, "Diff mismatch for %zu pixels\n", length);
+      failures++;
+    }
+  }
+  for (size_t y = 0; y < kHeight; y++) {
+    const uint8_t *diffRow = &diffScalar[y * kWidth];
+    GREYUpdateHistogramRowScalar(histogramScalar, y ? histogramScalar : NULL, diffRow, kWidth);
+    GREYUpdateHistogramRow(histogramVector, y ? histogramVector : NULL, diffRow, kWidth);
+    if (memcmp(histogramScalar, histogramVector, kWidth * sizeof(uint32_t)) != 0) {
+      fprintf(stderr, "Histogram mismatch in row %zu\n", y);
+      failures++;
+      break;
+    }
+  }
+
+  // Timing.
+  double start = grey_now();
+  for (int i = 0; i < kIterations; i++) {
+    GREYShiftPixelIntensitiesScalar(shiftedScalar, pixelCount);
+  }
+  double shiftScalarTime = grey_now() - start;
+  start = grey_now();
+  for (int i = 0; i < kIterations; i++) {
+    GREYShiftPixelIntensities(shiftedVector, pixelCount);
+  }
+  double shiftVectorTime = grey_now() - start;
+
+  size_t checksum = 0;
+  start = grey_now();
+  for (int i = 0; i < kIterations; i++) {
+    checksum += GREYDiffPixelsScalar(before, after, pixelCount, diffScalar);
+    for (size_t y = 0; y < kHeight; y++) {
+      GREYUpdateHistogramRowScalar(histogramScalar,
+                                   y ? histogramScalar : NULL,
+                                   &diffScalar[y * kWidth],
+                                   kWidth);
+    }
+  }
+  double diffScalarTime = grey_now() - start;
+  start = grey_now();
+  for (int i = 0; i < kIterations; i++) {
+    checksum -= GREYDiffPixels(before, after, pixelCount, diffVector);
+    for (size_t y = 0; y < kHeight; y++) {
+      GREYUpdateHistogramRow(histogramVector,
+                             y ? histogramVector : NULL,
+                             &diffVector[y * kWidth],
+                             kWidth);
+    }
+  }
+  double diffVectorTime = grey_now() - start;
+  if (checksum != 0) {
+    fprintf(stderr, "Visible pixel counts differ\n");
+    failures++;
+  }
+
+  printf("%zux%zu pixels, %d iterations\n", kWidth, kHeight, kIterations);
+  printf("shift:            scalar %8.2f ms  vector %8.2f ms  speedup %.1fx\n",
+         shiftScalarTime * 1e3, shiftVectorTime * 1e3, shiftScalarTime / shiftVectorTime);
+  printf("diff + histogram: scalar %8.2f ms  vector %8.2f ms  speedup %.1fx\n",
+         diffScalarTime * 1e3, diffVectorTime * 1e3, diffScalarTime / diffVectorTime);
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+
+  free(before);
+  free(after);
+  free(shiftedScalar);
+  free(shiftedVector);
+  free(diffScalar);
+  free(diffVector);
+  free(histogramScalar);
+  free(histogramVector);
+  return failures ? 1 : 0;
+}
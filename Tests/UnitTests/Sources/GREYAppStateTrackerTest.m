@@ -101,6 +101,87 @@
                  @"State should be kGREYIdle");
 }
 
+- (void)testCurrentStateIsKeptWhileAnyObjectIsInTheState {
+  NSObject *obj1 = [[NSObject alloc] init];
+  NSObject *obj2 = [[NSObject alloc] init];
+  GREYAppStateTracker *tracker = [GREYAppStateTracker sharedInstance];
+
+  GREYAppStateTrackerObject *elementID1 =
+      TRACK_STATE_FOR_OBJECT(kGREYPendingCAAnimation | kGREYPendingUIAnimation, obj1);
+  GREYAppStateTrackerObject *elementID2 = TRACK_STATE_FOR_OBJECT(kGREYPendingCAAnimation, obj2);
+  XCTAssertEqual([tracker currentState], kGREYPendingCAAnimation | kGREYPendingUIAnimation);
+
+  UNTRACK_STATE_FOR_OBJECT(kGREYPendingCAAnimation | kGREYPendingUIAnimation, elementID1);
+  XCTAssertEqual([tracker currentState], kGREYPendingCAAnimation);
+  XCTAssertFalse([tracker isIdleNow]);
+
+  UNTRACK_STATE_FOR_OBJECT(kGREYPendingCAAnimation, elementID2);
+  XCTAssertEqual([tracker currentState], kGREYIdle);
+  XCTAssertTrue([tracker isIdleNow]);
+}
+
+- (void)testTrackingAStateTwiceRequiresASingleUntrack {
+  NSObject *obj = [[NSObject alloc] init];
+  GREYAppStateTracker *tracker = [GREYAppStateTracker sharedInstance];
+
+  GREYAppStateTrackerObject *elementID1 = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, obj);
+  GREYAppStateTrackerObject *elementID2 = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, obj);
+  XCTAssertEqual(elementID1, elementID2);
+  XCTAssertEqual([tracker currentState], kGREYPendingDrawLayoutPass);
+
+  UNTRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, elementID1);
+  XCTAssertEqual([tracker currentState], kGREYIdle);
+  XCTAssertEqual([tracker grey_lastKnownStateForObject:obj], kGREYIdle);
+}
+
+- (void)testRepeatedTrackingPerformance {
+  NSObject *obj = [[NSObject alloc] init];
+  [self measureBlock:^{
+    GREYAppStateTrackerObject *elementID;
+    for (int i = 0; i < 100000; i++) {
+      elementID = TRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, obj);
+      [[GREYAppStateTracker sharedInstance] isIdleNow];
+    }
+    UNTRACK_STATE_FOR_OBJECT(kGREYPendingDrawLayoutPass, elementID);
+  }];
+}
+
+- (void)testPendingDrawLayoutPassIsUntrackedBeforeRunLoopSleeps {
+  GREYAppStateTracker *tracker = [GREYAppStateTracker sharedInstance];
+  [tracker trackPendingDrawLayoutPass];
+  [tracker trackPendingDrawLayoutPass];
+  XCTAssertEqual([tracker currentState], kGREYPendingDrawLayoutPass);
+
+  CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0, false);
+  XCTAssertEqual([tracker currentState], kGREYIdle);
+
+  [tracker trackPendingDrawLayoutPass];
+  XCTAssertEqual([tracker currentState], kGREYPendingDrawLayoutPass);
+  CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0, false);
+  XCTAssertEqual([tracker currentState], kGREYIdle);
+}
+
+- (void)testPendingDrawLayoutPassIsUntrackedInNonCommonMode {
+  GREYAppStateTracker *tracker = [GREYAppStateTracker sharedInstance];
+  CFStringRef mode = CFSTR("GREYAppStateTrackerTestMode");
+  CFRunLoopPerformBlock(CFRunLoopGetMain(), mode, ^{
+    [tracker trackPendingDrawLayoutPass];
+  });
+  CFRunLoopRunInMode(mode, 0, true);
+  XCTAssertEqual([tracker currentState], kGREYIdle);
+}
+
+- (void)testRepeatedDrawLayoutPassTrackingPerformance {
+  GREYAppStateTracker *tracker = [GREYAppStateTracker sharedInstance];
+  [self measureBlock:^{
+    for (int i = 0; i < 100000; i++) {
+      [tracker trackPendingDrawLayoutPass];
+    }
+    CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0, false);
+  }];
+  XCTAssertEqual([tracker currentState], kGREYIdle);
+}
+
 - (void)testDescriptionInVerboseMode {
   NSObject *obj1 = [[NSObject alloc] init];
 
@@ -291,6 +372,16 @@
   }
 }
 
+- (void)testNamesOfStatesAreTheNamesOfTheirFlags {
+  GREYAppStateTracker *tracker = [GREYAppStateTracker sharedInstance];
+  XCTAssertEqualObjects([tracker grey_nameOfState:kGREYIdle], @"kGREYIdle");
+  XCTAssertEqualObjects([tracker grey_nameOfState:kGREYPendingCAAnimation],
+                        @"kGREYPendingCAAnimation");
+  XCTAssertEqualObjects([tracker grey_nameOfState:(kGREYPendingCAAnimation |
+                                                   kGREYPendingNetworkRequest)],
+                        @"kGREYPendingCAAnimation | kGREYPendingNetworkRequest");
+}
+
 #pragma mark - Private
 
 - (GREYAppStateTrackerObject *)grey_ignoreAndTrackStateForTesting:(GREYAppState)state
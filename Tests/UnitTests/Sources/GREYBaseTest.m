@@ -69,6 +69,12 @@ const CGRect kTestRect = { { 0.0f, 0.0f }, { 10.0f, 10.0f } };
                                withMethod:fakeSelector];
     NSAssert(success, @"Couldn't swizzle GREYScreenshotUtil takeScreenshot");
 
+    fakeSelector = @selector(greyswizzled_fakeTakeScreenshotOfRect:afterScreenUpdates:);
+    success = [swizzler swizzleClass:screenshotUtilClass
+                  replaceClassMethod:@selector(grey_takeScreenshotOfRect:afterScreenUpdates:)
+                          withMethod:fakeSelector];
+    NSAssert(success, @"Couldn't swizzle GREYScreenshotUtil takeScreenshotOfRect");
+
     success =
         [swizzler swizzleClass:screenshotUtilClass
             replaceClassMethod:@selector(saveImageAsPNG:toFile:inDirectory:)
@@ -91,6 +97,21 @@ const CGRect kTestRect = { { 0.0f, 0.0f }, { 10.0f, 10.0f } };
   return image;
 }
 
++ (UIImage *)greyswizzled_fakeTakeScreenshotOfRect:(CGRect)rectInPixels
+                                 afterScreenUpdates:(BOOL)afterScreenUpdates {
+  // Crop the next full screenshot so tests can keep providing screen sized images.
+  UIImage *screenshot = [self grey_takeScreenshotAfterScreenUpdates:afterScreenUpdates];
+  CGImageRef croppedImageRef = CGImageCreateWithImageInRect(screenshot.CGImage, rectInPixels);
+  if (!croppedImageRef) {
+    return nil;
+  }
+  UIImage *image = [UIImage imageWithCGImage:croppedImageRef
+                                       scale:screenshot.scale
+                                 orientation:screenshot.imageOrientation];
+  CGImageRelease(croppedImageRef);
+  return image;
+}
+
 + (NSString *)greyswizzled_fakeSaveImageAsPNG:(UIImage *)image
                                      toFile:(NSString *)filename
                                 inDirectory:(NSString *)directoryPath {
@@ -15,6 +15,7 @@
 //
 
 #import <EarlGrey/GREYConfiguration.h>
+#import "Common/GREYConfiguration+Internal.h"
 #import "GREYBaseTest.h"
 
 @interface GREYConfigurationTest : GREYBaseTest {
@@ -135,6 +136,48 @@
   XCTAssertEqual(actualValue, 10.0);
 }
 
+- (void)testChangeCountChangesWhenConfigurationChanges {
+  NSUInteger changeCount = [_configuration changeCount];
+  XCTAssertEqual([_configuration changeCount], changeCount);
+
+  [_configuration setValue:@"foo" forConfigKey:@"bar"];
+  XCTAssertNotEqual([_configuration changeCount], changeCount);
+
+  changeCount = [_configuration changeCount];
+  [_configuration setDefaultValue:@"foo" forConfigKey:@"baz"];
+  XCTAssertNotEqual([_configuration changeCount], changeCount);
+
+  changeCount = [_configuration changeCount];
+  [_configuration reset];
+  XCTAssertNotEqual([_configuration changeCount], changeCount);
+}
+
+- (void)testSnapshotReflectsConfigurationChanges {
+  [_configuration setValue:@(1.0) forConfigKey:kGREYConfigKeyCALayerMaxAnimationDuration];
+  [_configuration setValue:@NO forConfigKey:kGREYConfigKeyCALayerModifyAnimations];
+  XCTAssertEqual(GREY_CONFIG_SNAPSHOT(caLayerMaxAnimationDuration), 1.0);
+  XCTAssertFalse(GREY_CONFIG_SNAPSHOT(caLayerModifyAnimations));
+
+  [_configuration setValue:@(1.3) forConfigKey:kGREYConfigKeyCALayerMaxAnimationDuration];
+  XCTAssertEqual(GREY_CONFIG_SNAPSHOT(caLayerMaxAnimationDuration), 1.3);
+
+  [_configuration reset];
+  XCTAssertEqual(GREY_CONFIG_SNAPSHOT(caLayerMaxAnimationDuration),
+                 GREY_CONFIG_DOUBLE(kGREYConfigKeyCALayerMaxAnimationDuration));
+  XCTAssertEqual(GREY_CONFIG_SNAPSHOT(caLayerModifyAnimations),
+                 GREY_CONFIG_BOOL(kGREYConfigKeyCALayerModifyAnimations));
+}
+
+- (void)testSnapshotFallsBackToDefaultsForValuesOfWrongType {
+  [_configuration setValue:@"1.0" forConfigKey:kGREYConfigKeyCALayerMaxAnimationDuration];
+  [_configuration setValue:@NO forConfigKey:kGREYConfigKeyCALayerModifyAnimations];
+
+  // Other keys are still refreshed, and the misconfigured one gets its default value.
+  XCTAssertFalse(GREY_CONFIG_SNAPSHOT(caLayerModifyAnimations));
+  XCTAssertEqual(GREY_CONFIG_SNAPSHOT(caLayerMaxAnimationDuration), 10);
+  XCTAssertThrows(GREY_CONFIG_DOUBLE(kGREYConfigKeyCALayerMaxAnimationDuration));
+}
+
 - (void)testQueryBoolReturnsConvertedValue {
   [_configuration setValue:@NO forConfigKey:kGREYConfigKeyActionConstraintsEnabled];
   XCTAssertFalse([_configuration boolValueForConfigKey:kGREYConfigKeyActionConstraintsEnabled]);
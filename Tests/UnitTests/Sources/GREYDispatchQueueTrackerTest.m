@@ -15,7 +15,7 @@
 //
 
 #import <EarlGrey/GREYConfiguration.h>
-#import "Synchronization/GREYDispatchQueueTracker.h"
+#import "Synchronization/GREYDispatchQueueTracker+Internal.h"
 #import "GREYBaseTest.h"
 
 /**
@@ -50,8 +50,13 @@ static void testFunction(void *context) {
   }
 }
 
+/** No-op worker function for dispatch_*_f calls. */
+static void noopFunction(void *context) {}
+
 static const NSTimeInterval kSecondsWaitInTestBlocks = 0.1;
 static const int kMaxAggresiveCalls = 100;
+static const NSUInteger kNumBenchmarkThreads = 8;
+static const NSUInteger kBenchmarkCallsPerThread = 10000;
 
 @interface GREYDispatchQueueTrackerTest : GREYBaseTest
 @end
@@ -167,6 +172,43 @@ static const int kMaxAggresiveCalls = 100;
   XCTAssertTrue([tracker isIdleNow], @"Idling resource should be idle after finishing execution");
 }
 
+- (void)testTrackerHonorsMaxTrackableDelayChanges {
+  GREYDispatchQueueTracker *tracker =
+      [GREYDispatchQueueTracker trackerForDispatchQueue:_serialQueue];
+  [[GREYConfiguration sharedInstance] setValue:@(1.0)
+                                  forConfigKey:kGREYConfigKeyDispatchAfterMaxTrackableDelay];
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)),
+                 _serialQueue, ^{});
+  XCTAssertFalse([tracker isIdleNow], @"Idling resource should track block with small delay");
+  [NSThread sleepForTimeInterval:0.2];
+  dispatch_sync(_serialQueue, ^{});
+  XCTAssertTrue([tracker isIdleNow], @"Idling resource should be idle after finishing execution");
+
+  [[GREYConfiguration sharedInstance] setValue:@(0.05)
+                                  forConfigKey:kGREYConfigKeyDispatchAfterMaxTrackableDelay];
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)),
+                 _serialQueue, ^{});
+  XCTAssertTrue([tracker isIdleNow], @"Idling resource should not track block with large delay");
+}
+
+- (void)testTrackerTracksMoreAsyncFunctionsThanArePooled {
+  GREYDispatchQueueTracker *tracker =
+      [GREYDispatchQueueTracker trackerForDispatchQueue:_serialQueue];
+  dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+  dispatch_async(_serialQueue, ^{
+    dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW,
+                                                     (int64_t)(5.0 * NSEC_PER_SEC)));
+  });
+  for (int i = 0; i < kMaxAggresiveCalls * 2; i++) {
+    dispatch_async_f(_serialQueue, NULL, noopFunction);
+  }
+  XCTAssertFalse([tracker isIdleNow]);
+
+  dispatch_semaphore_signal(semaphore);
+  dispatch_sync(_serialQueue, ^{});
+  XCTAssertTrue([tracker isIdleNow]);
+}
+
 - (void)testTrackerTracksDispatchAfterBlock {
   [[GREYConfiguration sharedInstance] setValue:@(0.1)
                                   forConfigKey:kGREYConfigKeyDispatchAfterMaxTrackableDelay];
@@ -327,6 +369,76 @@ static const int kMaxAggresiveCalls = 100;
   XCTAssertTrue([tracker isIdleNow]);
 }
 
+- (void)testTrackerTracksGlobalQueue {
+  dispatch_queue_t globalQueue = dispatch_get_global_queue(QOS_CLASS_UTILITY, 0);
+  GREYDispatchQueueTracker *tracker =
+      [GREYDispatchQueueTracker trackerForDispatchQueue:globalQueue];
+  XCTAssertEqual(tracker, [GREYDispatchQueueTracker trackerForDispatchQueue:globalQueue]);
+
+  dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Async block fired"];
+  dispatch_async(globalQueue, ^{
+    dispatch_time_t timeout = dispatch_time(DISPATCH_TIME_NOW,
+                                            (int64_t)(5.0 * NSEC_PER_SEC));
+    dispatch_semaphore_wait(semaphore, timeout);
+    [expectation fulfill];
+  });
+  XCTAssertFalse([tracker isIdleNow]);
+
+  dispatch_semaphore_signal(semaphore);
+  [self waitForExpectationsWithTimeout:5.0 handler:nil];
+  GREYCondition *idleCondition = [GREYCondition conditionWithName:@"Global queue is idle"
+                                                            block:^BOOL {
+    return [tracker isIdleNow];
+  }];
+  XCTAssertTrue([idleCondition waitWithTimeout:1.0]);
+}
+
+- (void)testTrackerTracksMaintenanceAndOvercommittingGlobalQueues {
+  NSArray *rootQueues = @[
+    dispatch_get_global_queue(kGREYQOSClassMaintenance, 0),
+    dispatch_get_global_queue(QOS_CLASS_DEFAULT, kGREYDispatchQueueOvercommit),
+    dispatch_get_global_queue(kGREYQOSClassMaintenance, kGREYDispatchQueueOvercommit),
+  ];
+  for (dispatch_queue_t rootQueue in rootQueues) {
+    GREYDispatchQueueTracker *tracker =
+        [GREYDispatchQueueTracker trackerForDispatchQueue:rootQueue];
+    XCTAssertNotNil(tracker);
+    XCTAssertEqual(tracker, [GREYDispatchQueueTracker trackerForDispatchQueue:rootQueue]);
+  }
+}
+
+// Benchmark of many threads calling dispatch_async concurrently, each on its own queue. Every
+// other queue is tracked, so both the tracked and the untracked lookups contend with each other.
+- (void)testConcurrentDispatchAsyncPerformance {
+  NSMutableArray *queues = [[NSMutableArray alloc] init];
+  NSMutableArray *trackers = [[NSMutableArray alloc] init];
+  for (NSUInteger i = 0; i < kNumBenchmarkThreads; i++) {
+    dispatch_queue_t queue =
+        dispatch_queue_create("GREYDispatchQueueTrackerBenchmark", DISPATCH_QUEUE_SERIAL);
+    [queues addObject:queue];
+    if (i % 2 == 0) {
+      [trackers addObject:[GREYDispatchQueueTracker trackerForDispatchQueue:queue]];
+    }
+  }
+
+  [self measureBlock:^{
+    dispatch_group_t group = dispatch_group_create();
+    for (dispatch_queue_t queue in queues) {
+      dispatch_group_enter(group);
+      NSThread *thread = [[NSThread alloc] initWithTarget:self
+                                                 selector:@selector(hammerQueueWithGroup:)
+                                                   object:@[ queue, group ]];
+      [thread start];
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+  }];
+
+  for (GREYDispatchQueueTracker *tracker in trackers) {
+    XCTAssertTrue([tracker isIdleNow]);
+  }
+}
+
 - (void)testIsTrackingALiveQueueWithALivingQueue {
   NS_VALID_UNTIL_END_OF_SCOPE dispatch_queue_t queue =
       dispatch_queue_create("GREYDispatchQueueIdlingResourceTestDealloc", DISPATCH_QUEUE_SERIAL);;
@@ -335,4 +447,22 @@ static const int kMaxAggresiveCalls = 100;
   XCTAssertTrue([tracker isTrackingALiveQueue]);
 }
 
+#pragma mark - Private
+
+// Dispatches many no-op blocks and functions asynchronously to the queue in @c queueAndGroup,
+// waits for them to complete and then leaves the group in @c queueAndGroup.
+- (void)hammerQueueWithGroup:(NSArray *)queueAndGroup {
+  dispatch_queue_t queue = queueAndGroup[0];
+  dispatch_group_t group = queueAndGroup[1];
+  for (NSUInteger i = 0; i < kBenchmarkCallsPerThread; i++) {
+    if (i % 2 == 0) {
+      dispatch_async(queue, ^{});
+    } else {
+      dispatch_async_f(queue, NULL, noopFunction);
+    }
+  }
+  dispatch_sync(queue, ^{});
+  dispatch_group_leave(group);
+}
+
 @end
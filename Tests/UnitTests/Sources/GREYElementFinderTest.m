@@ -18,6 +18,8 @@
 
 #import <EarlGrey/GREYElementFinder.h>
 #import <EarlGrey/GREYElementMatcherBlock.h>
+#import "Common/GREYConfiguration.h"
+#import "Core/GREYElementIndex.h"
 #import "Provider/GREYElementProvider.h"
 #import "Provider/GREYUIWindowProvider.h"
 #import "GREYBaseTest.h"
@@ -59,6 +61,11 @@ static NSMutableArray *gAppWindows;
   [[[self.mockSharedApplication stub] andReturn:gAppWindows] windows];
 }
 
+- (void)tearDown {
+  [[GREYElementIndex sharedInstance] deactivate];
+  [super tearDown];
+}
+
 - (void)testEmptyMatcherReturnsAllViews {
   [gAppWindows addObject:rootWindow];
   elementFinder = [[GREYElementFinder alloc] initWithMatcher:niceMatcher];
@@ -155,4 +162,313 @@ static NSMutableArray *gAppWindows;
   XCTAssertEqual([finder elementsMatchedInProvider:provider].count, 1u);
 }
 
+- (void)testAccessibilityIDMatchersRequireAccessibilityID {
+  id<GREYMatcher> matcher = grey_accessibilityID(@"A");
+  XCTAssertEqualObjects([GREYElementIndex accessibilityIDRequiredByMatcher:matcher], @"A");
+  matcher = grey_allOf(grey_notNil(), grey_accessibilityID(@"A"), nil);
+  XCTAssertEqualObjects([GREYElementIndex accessibilityIDRequiredByMatcher:matcher], @"A");
+  matcher = grey_anyOf(grey_notNil(), grey_accessibilityID(@"A"), nil);
+  XCTAssertNil([GREYElementIndex accessibilityIDRequiredByMatcher:matcher]);
+  XCTAssertNil([GREYElementIndex accessibilityIDRequiredByMatcher:niceMatcher]);
+}
+
+- (void)testIndexedLookupFindsViewsByAccessibilityID {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyElementIndexEnabled];
+  [gAppWindows addObject:rootWindow];
+  leafA1.accessibilityIdentifier = @"leafA1";
+
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:grey_accessibilityID(@"leafA1")];
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ leafA1 ]);
+  XCTAssertTrue([[GREYElementIndex sharedInstance] isActive]);
+
+  // Views added and identifiers set after the index was built are found through the index.
+  UIView *newView = [[UIView alloc] init];
+  newView.accessibilityIdentifier = @"newView";
+  [leafA addSubview:newView];
+  leafB.accessibilityIdentifier = @"leafB";
+  GREYElementIndex *index = [GREYElementIndex sharedInstance];
+  XCTAssertEqualObjects([index viewsWithAccessibilityID:@"newView"
+                            inHierarchiesOfRootElements:@[ rootWindow ]], @[ newView ]);
+  XCTAssertEqualObjects([index viewsWithAccessibilityID:@"leafB"
+                            inHierarchiesOfRootElements:@[ rootWindow ]], @[ leafB ]);
+
+  // Views whose identifier changed are no longer found under the old one.
+  leafA1.accessibilityIdentifier = @"renamed";
+  XCTAssertEqual([index viewsWithAccessibilityID:@"leafA1"
+                     inHierarchiesOfRootElements:@[ rootWindow ]].count, 0u);
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ ]);
+}
+
+- (void)testIndexedLookupOnlyReturnsViewsInSearchedHierarchy {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyElementIndexEnabled];
+  [gAppWindows addObject:rootWindow];
+  UIWindow *otherWindow = [[UIWindow alloc] init];
+  UIView *otherView = [[UIView alloc] init];
+  otherView.accessibilityIdentifier = @"leaf";
+  [otherWindow addSubview:otherView];
+  leafA1.accessibilityIdentifier = @"leaf";
+
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:grey_accessibilityID(@"leaf")];
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ leafA1 ]);
+
+  [leafA1 removeFromSuperview];
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ ]);
+}
+
+- (void)testIndexedLookupFallsBackToFullSearch {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyElementIndexEnabled];
+  [gAppWindows addObject:rootWindow];
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:grey_accessibilityID(@"stub")];
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ ]);
+
+  // The identifier doesn't go through the setter, so the index can't know about it.
+  id partialMockLeafB = OCMPartialMock(leafB);
+  OCMStub([partialMockLeafB accessibilityIdentifier]).andReturn(@"stub");
+  XCTAssertEqual([[GREYElementIndex sharedInstance] viewsWithAccessibilityID:@"stub"
+                                                inHierarchiesOfRootElements:@[ rootWindow ]].count,
+                 0u);
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ leafB ]);
+  [partialMockLeafB stopMocking];
+}
+
+- (void)testIndexedLookupReturnsSeveralMatchesInTraversalOrder {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyElementIndexEnabled];
+  [gAppWindows addObject:rootWindow];
+  leafA.accessibilityIdentifier = @"leaf";
+  leafA1.accessibilityIdentifier = @"leaf";
+  leafB.accessibilityIdentifier = @"leaf";
+
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:grey_accessibilityID(@"leaf")];
+  GREYElementFinder *fullSearchFinder =
+      [[GREYElementFinder alloc] initWithMatcher:[self grey_matcherForAccessibilityID:@"leaf"]];
+  NSArray *expectedElements = [fullSearchFinder elementsMatchedInProvider:viewProvider];
+  XCTAssertEqual(expectedElements.count, 3u);
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], expectedElements);
+}
+
+- (void)testIndexedLookupFindsAccessibilityElementsWithAccessibilityID {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyElementIndexEnabled];
+  [gAppWindows addObject:rootWindow];
+  leafA1.accessibilityIdentifier = @"leaf";
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:grey_accessibilityID(@"leaf")];
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ leafA1 ]);
+
+  // Accessibility elements aren't indexed, but they must still be found along with the view.
+  UIAccessibilityElement *element =
+      [[UIAccessibilityElement alloc] initWithAccessibilityContainer:leafA];
+  element.accessibilityIdentifier = @"leaf";
+  leafA.accessibilityElements = @[ element ];
+  NSArray *matchedElements = [elementFinder elementsMatchedInProvider:viewProvider];
+  XCTAssertEqual(matchedElements.count, 2u);
+  XCTAssertTrue([matchedElements containsObject:element]);
+  XCTAssertTrue([matchedElements containsObject:leafA1]);
+}
+
+- (void)testIndexedLookupFindsElementsOfLatePopulatedAccessibilityContainers {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyElementIndexEnabled];
+  [gAppWindows addObject:rootWindow];
+  leafA1.accessibilityIdentifier = @"leaf";
+  GREYUTAccessibilityViewContainerView *container =
+      [[GREYUTAccessibilityViewContainerView alloc] initWithElements:@[]];
+  [rootWindow addSubview:container];
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:grey_accessibilityID(@"leaf")];
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ leafA1 ]);
+
+  // The view is only reachable through the container, so the index doesn't know about it.
+  UIView *lateView = [[UIView alloc] init];
+  lateView.accessibilityIdentifier = @"leaf";
+  [container.accessibleElements addObject:lateView];
+  NSArray *matchedElements = [elementFinder elementsMatchedInProvider:viewProvider];
+  XCTAssertEqual(matchedElements.count, 2u);
+  XCTAssertTrue([matchedElements containsObject:leafA1]);
+  XCTAssertTrue([matchedElements containsObject:lateView]);
+}
+
+- (void)testPruningSkipsDescendantsOfInvisibleViews {
+  [[GREYConfiguration sharedInstance] setValue:@YES
+                                  forConfigKey:kGREYConfigKeyInvisibleSubtreePruningEnabled];
+  [gAppWindows addObject:rootWindow];
+  leafA.hidden = YES;
+  NSMutableArray *evaluatedElements = [[NSMutableArray alloc] init];
+  elementFinder = [[GREYElementFinder alloc]
+      initWithMatcher:[self grey_visibilityMatcherRecordingElementsInArray:evaluatedElements]];
+
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ ]);
+  XCTAssertEqualObjects(evaluatedElements, (@[ rootWindow, leafA, leafB ]));
+  XCTAssertEqual(elementFinder.prunedSubtreeCount, 1u);
+
+  [evaluatedElements removeAllObjects];
+  leafA.hidden = NO;
+  leafA.alpha = 0;
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], @[ ]);
+  XCTAssertEqualObjects(evaluatedElements, (@[ rootWindow, leafA, leafB ]));
+  XCTAssertEqual(elementFinder.prunedSubtreeCount, 1u);
+}
+
+- (void)testPruningSkipsDescendantsOfOffScreenClippingViews {
+  [[GREYConfiguration sharedInstance] setValue:@YES
+                                  forConfigKey:kGREYConfigKeyInvisibleSubtreePruningEnabled];
+  [gAppWindows addObject:rootWindow];
+  rootWindow.frame = [[UIScreen mainScreen] bounds];
+  leafA.frame = CGRectOffset(rootWindow.bounds, 0, CGRectGetHeight(rootWindow.bounds));
+  NSMutableArray *evaluatedElements = [[NSMutableArray alloc] init];
+  elementFinder = [[GREYElementFinder alloc]
+      initWithMatcher:[self grey_visibilityMatcherRecordingElementsInArray:evaluatedElements]];
+
+  // Subviews can be drawn outside of their superview unless it clips them.
+  [elementFinder elementsMatchedInProvider:viewProvider];
+  XCTAssertEqualObjects(evaluatedElements, (@[ rootWindow, leafA, leafB, leafA1 ]));
+  XCTAssertEqual(elementFinder.prunedSubtreeCount, 0u);
+
+  [evaluatedElements removeAllObjects];
+  leafA.clipsToBounds = YES;
+  [elementFinder elementsMatchedInProvider:viewProvider];
+  XCTAssertEqualObjects(evaluatedElements, (@[ rootWindow, leafA, leafB ]));
+  XCTAssertEqual(elementFinder.prunedSubtreeCount, 1u);
+}
+
+- (void)testPruningIsOnlyUsedWithMatchersThatRequireVisibility {
+  [[GREYConfiguration sharedInstance] setValue:@YES
+                                  forConfigKey:kGREYConfigKeyInvisibleSubtreePruningEnabled];
+  [gAppWindows addObject:rootWindow];
+  leafA.hidden = YES;
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:niceMatcher];
+  NSArray *expected = @[ rootWindow, leafA, leafB, leafA1 ];
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:viewProvider], expected);
+  XCTAssertEqual(elementFinder.prunedSubtreeCount, 0u);
+}
+
+- (void)testPruningIsDisabledByDefault {
+  [gAppWindows addObject:rootWindow];
+  leafA.hidden = YES;
+  NSMutableArray *evaluatedElements = [[NSMutableArray alloc] init];
+  elementFinder = [[GREYElementFinder alloc]
+      initWithMatcher:[self grey_visibilityMatcherRecordingElementsInArray:evaluatedElements]];
+  [elementFinder elementsMatchedInProvider:viewProvider];
+  XCTAssertEqualObjects(evaluatedElements, (@[ rootWindow, leafA, leafB, leafA1 ]));
+  XCTAssertEqual(elementFinder.prunedSubtreeCount, 0u);
+}
+
+- (void)testAncestorMatcherResultsAreSharedAcrossElementsOfASearch {
+  NSArray *views = [self grey_chainOfViewsWithCount:10];
+  NSUInteger evaluationCount = 0;
+  id<GREYMatcher> ancestorMatcher = [self grey_matcherCountingEvaluationsIn:&evaluationCount
+                                                           matchingElement:views[0]];
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:grey_ancestor(ancestorMatcher)];
+  GREYElementProvider *provider = [GREYElementProvider providerWithRootElements:@[ views[0] ]];
+
+  NSArray *expected = [views subarrayWithRange:NSMakeRange(1, views.count - 1)];
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:provider], expected);
+  // Every element only evaluates its own parent, the rest of the walk is memoized.
+  XCTAssertEqual(evaluationCount, views.count - 1);
+
+  // Results aren't kept across searches.
+  evaluationCount = 0;
+  [elementFinder elementsMatchedInProvider:provider];
+  XCTAssertEqual(evaluationCount, views.count - 1);
+}
+
+- (void)testDescendantMatcherResultsAreSharedAcrossElementsOfASearch {
+  NSArray *views = [self grey_chainOfViewsWithCount:10];
+  NSUInteger evaluationCount = 0;
+  id<GREYMatcher> descendantMatcher = [self grey_matcherCountingEvaluationsIn:&evaluationCount
+                                                             matchingElement:[views lastObject]];
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:grey_descendant(descendantMatcher)];
+  GREYElementProvider *provider = [GREYElementProvider providerWithRootElements:@[ views[0] ]];
+
+  NSArray *expected = [views subarrayWithRange:NSMakeRange(0, views.count - 1)];
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:provider], expected);
+  // Every element is only evaluated as the child of its parent.
+  XCTAssertEqual(evaluationCount, views.count - 1);
+}
+
+- (void)testDescendantMatcherResultsInAccessibilityCycleAreNotMemoizedTooEarly {
+  // A contains B and C, and B contains A again. B's descendants are checked while A's still are,
+  // so B only gets its result once A is known to contain C.
+  UIView *matchingView = [[UIView alloc] init];
+  GREYUTAccessibilityViewContainerView *containerA =
+      [[GREYUTAccessibilityViewContainerView alloc] initWithElements:@[]];
+  GREYUTAccessibilityViewContainerView *containerB =
+      [[GREYUTAccessibilityViewContainerView alloc] initWithElements:@[ containerA ]];
+  // Accessibility elements are explored from the last one, so B is explored before C.
+  [containerA.accessibleElements addObjectsFromArray:@[ matchingView, containerB ]];
+  NSUInteger evaluationCount = 0;
+  id<GREYMatcher> descendantMatcher = [self grey_matcherCountingEvaluationsIn:&evaluationCount
+                                                             matchingElement:matchingView];
+  elementFinder = [[GREYElementFinder alloc] initWithMatcher:grey_descendant(descendantMatcher)];
+  GREYElementProvider *provider =
+      [GREYElementProvider providerWithElements:@[ containerA, containerB ]];
+
+  XCTAssertEqualObjects([elementFinder elementsMatchedInProvider:provider],
+                        (@[ containerA, containerB ]));
+  [containerA.accessibleElements removeAllObjects];
+}
+
+- (void)testHierarchyMatchersAreNotMemoizedOutsideOfASearch {
+  NSArray *views = [self grey_chainOfViewsWithCount:3];
+  NSUInteger evaluationCount = 0;
+  id<GREYMatcher> ancestorMatcher = [self grey_matcherCountingEvaluationsIn:&evaluationCount
+                                                           matchingElement:views[0]];
+  id<GREYMatcher> matcher = grey_ancestor(ancestorMatcher);
+  XCTAssertTrue([matcher matches:views[2]]);
+  XCTAssertTrue([matcher matches:views[2]]);
+  XCTAssertEqual(evaluationCount, 4u);
+}
+
+#pragma mark - Private
+
+/**
+ *  @return A matcher for elements with @c accessibilityID that the element index can't be used for.
+ */
+- (id<GREYMatcher>)grey_matcherForAccessibilityID:(NSString *)accessibilityID {
+  return [GREYElementMatcherBlock matcherWithMatchesBlock:^BOOL(id element) {
+    return [[element accessibilityIdentifier] isEqualToString:accessibilityID];
+  } descriptionBlock:^(id<GREYDescription> description) {
+    [description appendText:accessibilityID];
+  }];
+}
+
+/**
+ *  @return A matcher that requires visibility, which adds every element it is evaluated against to
+ *          @c evaluatedElements and rejects it before its visibility is checked.
+ */
+- (id<GREYMatcher>)grey_visibilityMatcherRecordingElementsInArray:
+    (NSMutableArray *)evaluatedElements {
+  MatchesBlock matches = ^BOOL(id item) {
+    [evaluatedElements addObject:item];
+    return NO;
+  };
+  id<GREYMatcher> recordingMatcher =
+      [GREYElementMatcherBlock matcherWithMatchesBlock:matches
+                                      descriptionBlock:^(id<GREYDescription> desc) { }];
+  return grey_allOf(grey_sufficientlyVisible(), recordingMatcher, nil);
+}
+
+/**
+ *  @return An array of @c count views, each of which is the only subview of the previous one.
+ */
+- (NSArray *)grey_chainOfViewsWithCount:(NSUInteger)count {
+  NSMutableArray *views = [[NSMutableArray alloc] init];
+  for (NSUInteger i = 0; i < count; i++) {
+    UIView *view = [[UIView alloc] init];
+    [[views lastObject] addSubview:view];
+    [views addObject:view];
+  }
+  return views;
+}
+
+/**
+ *  @return A matcher that only matches @c matchingElement and increments @c evaluationCount every
+ *          time it is evaluated.
+ */
+- (id<GREYMatcher>)grey_matcherCountingEvaluationsIn:(NSUInteger *)evaluationCount
+                                     matchingElement:(id)matchingElement {
+  MatchesBlock matches = ^BOOL(id item) {
+    (*evaluationCount)++;
+    return item == matchingElement;
+  };
+  return [GREYElementMatcherBlock matcherWithMatchesBlock:matches
+                                         descriptionBlock:^(id<GREYDescription> desc) { }];
+}
+
 @end
@@ -26,6 +26,7 @@
 #import <EarlGrey/GREYFrameworkException.h>
 #import <EarlGrey/GREYMatchers.h>
 #import <EarlGrey/GREYNot.h>
+#import "Common/GREYTracer.h"
 #import "GREYBaseTest.h"
 #import "GREYExposedForTesting.h"
 
@@ -86,6 +87,76 @@ NSMutableArray *appWindows;
   XCTAssertNoThrow([_elementInteraction performAction:action]);
 }
 
+- (void)testPerformActionRecordsTraceSpans {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyTracingEnabled];
+  UIWindow *window = [[UIWindow alloc] init];
+  UIView *view = [[UIView alloc] init];
+  view.accessibilityIdentifier = @"view";
+  [window addSubview:view];
+  [appWindows addObject:window];
+  [[GREYTracer sharedInstance] reset];
+
+  _elementInteraction =
+      [[GREYElementInteraction alloc] initWithElementMatcher:grey_accessibilityID(@"view")];
+  id<GREYAction> action = [GREYActionBlock actionWithName:@"test"
+                                             performBlock:^(id element,
+                                                            __strong NSError **errorOrNil) {
+    return YES;
+  }];
+  [_elementInteraction performAction:action];
+
+  NSArray *spanNames = [[[GREYTracer sharedInstance] traceEvents] valueForKey:@"name"];
+  XCTAssertEqualObjects(spanNames.lastObject, kGREYTraceSpanPerformAction);
+  XCTAssertTrue([spanNames containsObject:kGREYTraceSpanSyncWait]);
+  XCTAssertTrue([spanNames containsObject:kGREYTraceSpanElementSearch]);
+  XCTAssertTrue([spanNames containsObject:kGREYTraceSpanMatcherEvaluation]);
+  XCTAssertTrue([spanNames containsObject:kGREYTraceSpanActionExecution]);
+  XCTAssertTrue([spanNames containsObject:kGREYTraceSpanPostActionDrain]);
+  [[GREYTracer sharedInstance] reset];
+}
+
+- (void)testPerformInRootDoesNotMatchTheRootItself {
+  UIWindow *window = [[UIWindow alloc] init];
+  window.accessibilityIdentifier = @"window";
+  [appWindows addObject:window];
+
+  _elementInteraction =
+      [[GREYElementInteraction alloc] initWithElementMatcher:grey_accessibilityID(@"window")];
+  [_elementInteraction inRoot:grey_accessibilityID(@"window")];
+  id<GREYAction> action = [GREYActionBlock actionWithName:@"test"
+                                             performBlock:^(id element,
+                                                            __strong NSError **errorOrNil) {
+    return YES;
+  }];
+  XCTAssertThrows([_elementInteraction performAction:action]);
+}
+
+- (void)testPerformInMultipleRoots {
+  UIView *view1 = [[UIView alloc] init];
+  UIView *view2 = [[UIView alloc] init];
+  view1.accessibilityIdentifier = @"view";
+  view2.accessibilityIdentifier = @"view";
+
+  UIWindow *window1 = [[UIWindow alloc] init];
+  UIWindow *window2 = [[UIWindow alloc] init];
+  [window1 addSubview:view1];
+  [window2 addSubview:view2];
+  [appWindows addObjectsFromArray:@[ window1, window2 ]];
+
+  __block id performedOnElement;
+  id<GREYAction> action = [GREYActionBlock actionWithName:@"test"
+                                             performBlock:^(id element,
+                                                            __strong NSError **errorOrNil) {
+    performedOnElement = element;
+    return YES;
+  }];
+  _elementInteraction =
+      [[GREYElementInteraction alloc] initWithElementMatcher:grey_accessibilityID(@"view")];
+  [[_elementInteraction inRoot:grey_kindOfClass([UIWindow class])] atIndex:1];
+  XCTAssertNoThrow([_elementInteraction performAction:action]);
+  XCTAssertEqual(performedOnElement, view2);
+}
+
 - (void)testPerformWithNoRootSpecified {
   UIView *view1 = [[UIView alloc] init];
   UIView *view2 = [[UIView alloc] init];
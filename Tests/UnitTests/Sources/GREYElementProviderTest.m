@@ -145,6 +145,29 @@
                         @"Should contain all views the provider was initialized with");
 }
 
+- (void)testFastEnumerationMatchesNextObject {
+  NSMutableArray *windows = [[NSMutableArray alloc] init];
+  for (NSUInteger i = 0; i < 3; i++) {
+    UIWindow *window = [[UIWindow alloc] init];
+    for (NSUInteger j = 0; j < 40; j++) {
+      UIView *view = [[UIView alloc] init];
+      [view addSubview:[[UIView alloc] init]];
+      [window addSubview:view];
+    }
+    [windows addObject:window];
+  }
+  GREYUIWindowProvider *windowProvider = [GREYUIWindowProvider providerWithWindows:windows];
+  GREYElementProvider *provider = [GREYElementProvider providerWithRootProvider:windowProvider];
+
+  NSArray *expected = [[provider dataEnumerator] allObjects];
+  XCTAssertEqual(expected.count, 3u * 81u);
+  NSMutableArray *enumerated = [[NSMutableArray alloc] init];
+  for (id element in [provider dataEnumerator]) {
+    [enumerated addObject:element];
+  }
+  XCTAssertEqualObjects(expected, enumerated);
+}
+
 - (void)testMockViewIsReplacedByActualView {
   NSInteger testInteger = 0;
   id view = [OCMockObject mockForClass:[UIView class]];
@@ -20,6 +20,8 @@
 #import <EarlGrey/GREYElementInteraction.h>
 #import <EarlGrey/GREYMatcher.h>
 #import <EarlGrey/GREYMatchers.h>
+#import "Matcher/GREYElementMatcherBlock.h"
+#import "Matcher/GREYMatcherCost.h"
 #import "Matcher/GREYStringDescription.h"
 #import "GREYBaseTest.h"
 
@@ -679,4 +681,119 @@
   XCTAssertFalse([matcher matches:view], @"UIView does not have title");
 }
 
+- (void)testMatchersAreAssignedCostClasses {
+  XCTAssertEqual(GREYMatcherCostOf(grey_accessibilityID(@"foo")), kGREYMatcherCostProperty);
+  XCTAssertEqual(GREYMatcherCostOf(grey_kindOfClass([UIView class])), kGREYMatcherCostProperty);
+  XCTAssertEqual(GREYMatcherCostOf(grey_ancestor(grey_kindOfClass([UIWindow class]))),
+                 kGREYMatcherCostHierarchyWalk);
+  XCTAssertEqual(GREYMatcherCostOf(grey_descendant(grey_kindOfClass([UIView class]))),
+                 kGREYMatcherCostHierarchyWalk);
+  XCTAssertEqual(GREYMatcherCostOf(grey_descendant(grey_sufficientlyVisible())),
+                 kGREYMatcherCostPixelRender);
+  XCTAssertEqual(GREYMatcherCostOf(grey_sufficientlyVisible()), kGREYMatcherCostPixelRender);
+  XCTAssertEqual(GREYMatcherCostOf(grey_interactable()), kGREYMatcherCostPixelRender);
+  XCTAssertEqual(GREYMatcherCostOf(grey_not(grey_notVisible())), kGREYMatcherCostPixelRender);
+  XCTAssertEqual(GREYMatcherCostOf(grey_allOf(grey_sufficientlyVisible(),
+                                              grey_accessibilityID(@"foo"),
+                                              nil)),
+                 kGREYMatcherCostPixelRender);
+}
+
+- (void)testAllOfEvaluatesCheapestMatchersFirst {
+  NSMutableArray *evaluated = [[NSMutableArray alloc] init];
+  id<GREYMatcher> render = [self grey_matcherNamed:@"render"
+                                           matches:YES
+                                              cost:kGREYMatcherCostPixelRender
+                                  recordingInArray:evaluated];
+  id<GREYMatcher> walk = [self grey_matcherNamed:@"walk"
+                                         matches:YES
+                                            cost:kGREYMatcherCostHierarchyWalk
+                                recordingInArray:evaluated];
+  id<GREYMatcher> property = [self grey_matcherNamed:@"property"
+                                             matches:YES
+                                                cost:kGREYMatcherCostProperty
+                                    recordingInArray:evaluated];
+  id<GREYMatcher> matcher = grey_allOf(render, walk, property, nil);
+
+  XCTAssertTrue([matcher matches:[[UIView alloc] init]]);
+  XCTAssertEqualObjects(evaluated, (@[ @"property", @"walk", @"render" ]));
+  XCTAssertEqualObjects([matcher description], @"(render && walk && property)");
+}
+
+- (void)testAllOfShortCircuitsBeforeExpensiveMatchers {
+  NSMutableArray *evaluated = [[NSMutableArray alloc] init];
+  id<GREYMatcher> render = [self grey_matcherNamed:@"render"
+                                           matches:YES
+                                              cost:kGREYMatcherCostPixelRender
+                                  recordingInArray:evaluated];
+  id<GREYMatcher> property = [self grey_matcherNamed:@"property"
+                                             matches:NO
+                                                cost:kGREYMatcherCostProperty
+                                    recordingInArray:evaluated];
+  id<GREYMatcher> matcher = grey_allOf(render, property, nil);
+
+  XCTAssertFalse([matcher matches:[[UIView alloc] init]]);
+  XCTAssertEqualObjects(evaluated, @[ @"property" ]);
+}
+
+- (void)testAllOfDescribesMismatchInDeclaredOrder {
+  NSMutableArray *evaluated = [[NSMutableArray alloc] init];
+  id<GREYMatcher> render = [self grey_matcherNamed:@"render"
+                                           matches:NO
+                                              cost:kGREYMatcherCostPixelRender
+                                  recordingInArray:evaluated];
+  id<GREYMatcher> property = [self grey_matcherNamed:@"property"
+                                             matches:NO
+                                                cost:kGREYMatcherCostProperty
+                                    recordingInArray:evaluated];
+  id<GREYMatcher> matcher = grey_allOf(render, property, nil);
+  GREYStringDescription *mismatch = [[GREYStringDescription alloc] init];
+
+  XCTAssertFalse([matcher matches:[[UIView alloc] init] describingMismatchTo:mismatch]);
+  XCTAssertEqualObjects([mismatch description], @"render");
+}
+
+- (void)testAnyOfEvaluatesCheapestMatchersFirst {
+  NSMutableArray *evaluated = [[NSMutableArray alloc] init];
+  id<GREYMatcher> render = [self grey_matcherNamed:@"render"
+                                           matches:YES
+                                              cost:kGREYMatcherCostPixelRender
+                                  recordingInArray:evaluated];
+  id<GREYMatcher> firstProperty = [self grey_matcherNamed:@"firstProperty"
+                                                  matches:NO
+                                                     cost:kGREYMatcherCostProperty
+                                         recordingInArray:evaluated];
+  id<GREYMatcher> secondProperty = [self grey_matcherNamed:@"secondProperty"
+                                                   matches:YES
+                                                      cost:kGREYMatcherCostProperty
+                                          recordingInArray:evaluated];
+  id<GREYMatcher> matcher = grey_anyOf(render, firstProperty, secondProperty, nil);
+
+  XCTAssertTrue([matcher matches:[[UIView alloc] init]]);
+  XCTAssertEqualObjects(evaluated, (@[ @"firstProperty", @"secondProperty" ]));
+  XCTAssertEqualObjects([matcher description], @"(render || firstProperty || secondProperty)");
+}
+
+#pragma mark - Private
+
+/**
+ *  @return A matcher with the given @c name as its description, which returns @c matches and adds
+ *          its name to @c evaluated whenever it is evaluated.
+ */
+- (id<GREYMatcher>)grey_matcherNamed:(NSString *)name
+                             matches:(BOOL)matches
+                                cost:(GREYMatcherCost)cost
+                    recordingInArray:(NSMutableArray *)evaluated {
+  MatchesBlock matchesBlock = ^BOOL(id element) {
+    [evaluated addObject:name];
+    return matches;
+  };
+  DescribeToBlock describeBlock = ^void(id<GREYDescription> description) {
+    [description appendText:name];
+  };
+  id<GREYMatcher> matcher = [[GREYElementMatcherBlock alloc] initWithMatchesBlock:matchesBlock
+                                                                 descriptionBlock:describeBlock];
+  return GREYMatcherSetCost(matcher, cost);
+}
+
 @end
@@ -19,6 +19,7 @@
 #import "Action/GREYPathGestureUtils.h"
 #import "Additions/CGGeometry+GREYAdditions.h"
 #import "Common/GREYVisibilityChecker.h"
+#import "Event/GREYTouchPath.h"
 #import "GREYBaseTest.h"
 #import "GREYExposedForTesting.h"
 
@@ -63,11 +64,11 @@
   [self forEachDirectionPerformBlock:^(GREYDirection direction) {
     CGPoint startPoint = CGPointMake(100, 200);
     UIWindow *window = [[UIWindow alloc] initWithFrame:[UIScreen mainScreen].bounds];
-    NSArray *path = [GREYPathGestureUtils touchPathForGestureWithStartPoint:startPoint
-                                                               andDirection:direction
-                                                                andDuration:1.0
-                                                                   inWindow:window];
-    CGPoint pathStartPoint = [path[0] CGPointValue];
+    GREYTouchPath *path = [GREYPathGestureUtils touchPathForGestureWithStartPoint:startPoint
+                                                                     andDirection:direction
+                                                                      andDuration:1.0
+                                                                         inWindow:window];
+    CGPoint pathStartPoint = [path pointAtIndex:0];
     XCTAssertEqual(pathStartPoint.x, startPoint.x);
     XCTAssertEqual(pathStartPoint.y, startPoint.y);
   }];
@@ -76,23 +77,24 @@
 - (void)testDragTouchPath_noCancelInertia {
   CGPoint startPoint = CGPointMake(100, 200);
   CGPoint endPoint = CGPointMake(200, 300);
-  NSArray *path = [GREYPathGestureUtils touchPathForDragGestureWithStartPoint:startPoint
-                                                                     endPoint:endPoint
-                                                                cancelInertia:NO];
-  CGPoint pathStartPoint = [[path firstObject] CGPointValue];
+  GREYTouchPath *path =
+      [GREYPathGestureUtils touchPathForDragGestureWithStartPoint:startPoint
+                                                         endPoint:endPoint
+                                                    cancelInertia:NO];
+  CGPoint pathStartPoint = path.firstPoint;
   XCTAssertEqual(pathStartPoint.x, startPoint.x);
   XCTAssertEqual(pathStartPoint.y, startPoint.y);
 
-  CGPoint pathEndPoint = [[path lastObject] CGPointValue];
+  CGPoint pathEndPoint = path.lastPoint;
   XCTAssertEqual(pathEndPoint.x, endPoint.x);
   XCTAssertEqual(pathEndPoint.y, endPoint.y);
 
-  NSUInteger pathLength = [path count];
-  CGPoint path2ndLastPoint = [[path objectAtIndex:(pathLength - 2)] CGPointValue];
+  NSUInteger pathLength = path.count;
+  CGPoint path2ndLastPoint = [path pointAtIndex:(pathLength - 2)];
   XCTAssertLessThan(path2ndLastPoint.x, endPoint.x);
   XCTAssertLessThan(path2ndLastPoint.y, endPoint.y);
 
-  CGPoint path3rdLastPoint = [[path objectAtIndex:(pathLength - 3)] CGPointValue];
+  CGPoint path3rdLastPoint = [path pointAtIndex:(pathLength - 3)];
   XCTAssertLessThan(path3rdLastPoint.x, path2ndLastPoint.x);
   XCTAssertLessThan(path3rdLastPoint.y, path2ndLastPoint.y);
 }
@@ -100,25 +102,26 @@
 - (void)testDragTouchPath_cancelInertia {
   CGPoint startPoint = CGPointMake(100, 200);
   CGPoint endPoint = CGPointMake(0, 0);
-  NSArray *path = [GREYPathGestureUtils touchPathForDragGestureWithStartPoint:startPoint
-                                                                     endPoint:endPoint
-                                                                cancelInertia:YES];
-  CGPoint pathStartPoint = [[path firstObject] CGPointValue];
+  GREYTouchPath *path =
+      [GREYPathGestureUtils touchPathForDragGestureWithStartPoint:startPoint
+                                                         endPoint:endPoint
+                                                    cancelInertia:YES];
+  CGPoint pathStartPoint = path.firstPoint;
   XCTAssertEqual(pathStartPoint.x, startPoint.x);
   XCTAssertEqual(pathStartPoint.y, startPoint.y);
 
-  CGPoint pathEndPoint = [[path lastObject] CGPointValue];
+  CGPoint pathEndPoint = path.lastPoint;
   XCTAssertEqual(pathEndPoint.x, endPoint.x);
   XCTAssertEqual(pathEndPoint.y, endPoint.y);
 
-  NSUInteger pathLength = [path count];
-  CGPoint path2ndPoint = [[path objectAtIndex:1] CGPointValue];
+  NSUInteger pathLength = path.count;
+  CGPoint path2ndPoint = [path pointAtIndex:1];
   CGPoint diffStartAndNextPoint =
       CGPointMake(path2ndPoint.x - startPoint.x, path2ndPoint.y - startPoint.y);
   XCTAssertLessThan(diffStartAndNextPoint.x, 0);
   XCTAssertLessThan(diffStartAndNextPoint.y, 0);
 
-  CGPoint path2ndLastPoint = [[path objectAtIndex:(pathLength - 2)] CGPointValue];
+  CGPoint path2ndLastPoint = [path pointAtIndex:(pathLength - 2)];
   CGPoint diff2ndLastAndLastPoint =
       CGPointMake(path2ndLastPoint.x - endPoint.x, path2ndLastPoint.y - endPoint.y);
   XCTAssertLessThan(fabsf((float)diff2ndLastAndLastPoint.x),
@@ -126,7 +129,7 @@
   XCTAssertLessThan(fabsf((float)diff2ndLastAndLastPoint.y),
                     fabsf((float)diffStartAndNextPoint.y));
 
-  CGPoint path3rdLastPoint = [[path objectAtIndex:(pathLength - 3)] CGPointValue];
+  CGPoint path3rdLastPoint = [path pointAtIndex:(pathLength - 3)];
   CGPoint diff3rdLastAnd2ndLastPoint = CGPointMake(path3rdLastPoint.x - path2ndLastPoint.x,
                                                    path3rdLastPoint.y - path2ndLastPoint.y);
   XCTAssertEqualWithAccuracy(diff3rdLastAnd2ndLastPoint.x, diff2ndLastAndLastPoint.x, 0.001);
@@ -135,31 +138,32 @@
 
 - (void)testTouchPathWithLengthAndLeftDirection_cancelInertia {
   id mockUIView = [self mockFullScreenUIView];
-  NSArray *path = [GREYPathGestureUtils touchPathForGestureInView:mockUIView
-                                                    withDirection:kGREYDirectionLeft
-                                                           length:100
-                                               startPointPercents:CGPointMake(0.1f, 0.1f)
-                                               outRemainingAmount:NULL];
+  GREYTouchPath *path =
+      [GREYPathGestureUtils touchPathForGestureInView:mockUIView
+                                        withDirection:kGREYDirectionLeft
+                                               length:100
+                                   startPointPercents:CGPointMake(0.1f, 0.1f)
+                                   outRemainingAmount:NULL];
 
-  CGPoint pathStartPoint = [[path firstObject] CGPointValue];
-  CGPoint pathEndPoint = [[path lastObject] CGPointValue];
+  CGPoint pathStartPoint = path.firstPoint;
+  CGPoint pathEndPoint = path.lastPoint;
   XCTAssertGreaterThan(pathStartPoint.x, pathEndPoint.x);
   XCTAssertEqual(pathStartPoint.y, pathEndPoint.y);
 
-  NSUInteger pathLength = [path count];
-  CGPoint path2ndPoint = [[path objectAtIndex:1] CGPointValue];
+  NSUInteger pathLength = path.count;
+  CGPoint path2ndPoint = [path pointAtIndex:1];
   CGPoint diffStartAndNextPoint =
       CGPointMake(path2ndPoint.x - pathStartPoint.x, path2ndPoint.y - pathStartPoint.y);
   XCTAssertLessThan(diffStartAndNextPoint.x, 0);
   XCTAssertEqual(diffStartAndNextPoint.y, 0);
 
-  CGPoint path2ndLastPoint = [[path objectAtIndex:(pathLength - 2)] CGPointValue];
+  CGPoint path2ndLastPoint = [path pointAtIndex:(pathLength - 2)];
   CGPoint diff2ndLastAndLastPoint =
       CGPointMake(path2ndLastPoint.x - pathEndPoint.x, path2ndLastPoint.y - pathEndPoint.y);
   XCTAssertLessThan(fabsf((float)diff2ndLastAndLastPoint.x), fabsf((float)diffStartAndNextPoint.x));
   XCTAssertEqual(diff2ndLastAndLastPoint.y, diffStartAndNextPoint.y);
 
-  CGPoint path3rdLastPoint = [[path objectAtIndex:(pathLength - 3)] CGPointValue];
+  CGPoint path3rdLastPoint = [path pointAtIndex:(pathLength - 3)];
   CGPoint diff3rdLastAnd2ndLastPoint = CGPointMake(path3rdLastPoint.x - path2ndLastPoint.x,
                                                    path3rdLastPoint.y - path2ndLastPoint.y);
   XCTAssertEqualWithAccuracy(diff3rdLastAnd2ndLastPoint.x, diff2ndLastAndLastPoint.x, 0.001);
@@ -242,14 +246,14 @@
     CGFloat remainingAmount = totalExpectedPathAmount;
     NSUInteger pathSegmentsCount = 0;
     while (remainingAmount > 0) {
-      NSArray *path = [GREYPathGestureUtils touchPathForGestureInView:mockUIView
-                                                        withDirection:kGREYDirectionDown
-                                                               length:remainingAmount
-                                                   startPointPercents:GREYCGPointNull
-                                                   outRemainingAmount:&remainingAmount];
-      CGFloat pathLength = CGVectorLength(CGVectorFromEndPoints([[path firstObject] CGPointValue],
-                                                                [[path lastObject] CGPointValue],
-                                                                NO));
+      GREYTouchPath *path =
+          [GREYPathGestureUtils touchPathForGestureInView:mockUIView
+                                            withDirection:kGREYDirectionDown
+                                                   length:remainingAmount
+                                       startPointPercents:GREYCGPointNull
+                                       outRemainingAmount:&remainingAmount];
+      CGFloat pathLength =
+          CGVectorLength(CGVectorFromEndPoints(path.firstPoint, path.lastPoint, NO));
       pathSegmentsCount += 1;
       XCTAssertGreaterThan(pathLength, kGREYScrollDetectionLength,
                            @"Touch path length must be greater than the scroll detection length.");
@@ -263,4 +267,17 @@
   }];
 }
 
+- (void)testTouchPathFromPointValuesKeepsPointsInOrder {
+  NSArray<NSValue *> *pointValues = @[
+    [NSValue valueWithCGPoint:CGPointMake(1, 2)],
+    [NSValue valueWithCGPoint:CGPointMake(3, 4)],
+    [NSValue valueWithCGPoint:CGPointMake(5, 6)],
+  ];
+  GREYTouchPath *touchPath = [GREYTouchPath touchPathWithPointValues:pointValues];
+  XCTAssertEqual(touchPath.count, 3u);
+  for (NSUInteger i = 0; i < pointValues.count; i++) {
+    XCTAssertTrue(CGPointEqualToPoint([touchPath pointAtIndex:i], [pointValues[i] CGPointValue]));
+  }
+}
+
 @end
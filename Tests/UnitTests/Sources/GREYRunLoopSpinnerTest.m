@@ -267,6 +267,73 @@ static NSUInteger gDrainCountForSpinnerTest;
                  @"Spin result should be NO. The condition was never met.");
 }
 
+- (void)testSleepConditionBlockReturningNoKeepsRunLoopAwake {
+  GREYRunLoopSpinner *spinner = [[GREYRunLoopSpinner alloc] init];
+
+  spinner.maxSleepInterval = 10;
+  spinner.minRunLoopDrains = 0;
+  spinner.timeout = 0.1;
+  __block NSUInteger sleepConditionChecks = 0;
+  spinner.sleepConditionBlock = ^BOOL {
+    sleepConditionChecks++;
+    return NO;
+  };
+
+  [self changeActiveModeToSpinnerTestMode];
+
+  BOOL result = [spinner spinWithStopConditionBlock:^BOOL {
+    return NO;
+  }];
+
+  XCTAssertFalse(result, @"Spin result should be NO. The condition was never met.");
+  XCTAssertGreaterThan(sleepConditionChecks, 1u,
+                       @"The run loop should have been woken up every time it was about to sleep.");
+}
+
+- (void)testInitialSleepIntervalBacksOffToMaxSleepInterval {
+  GREYRunLoopSpinner *spinner = [[GREYRunLoopSpinner alloc] init];
+
+  spinner.initialSleepInterval = 0.01;
+  spinner.maxSleepInterval = 0.08;
+  spinner.minRunLoopDrains = 0;
+  spinner.timeout = 0.5;
+
+  [self changeActiveModeToSpinnerTestMode];
+
+  NSMutableArray<NSNumber *> *conditionCheckTimes = [[NSMutableArray alloc] init];
+  BOOL result = [spinner spinWithStopConditionBlock:^BOOL {
+    [conditionCheckTimes addObject:@(CACurrentMediaTime())];
+    return NO;
+  }];
+
+  XCTAssertFalse(result, @"Spin result should be NO. The condition was never met.");
+  // Sleeps of 0.01, 0.02, 0.04 and then 0.08 seconds fit about 8 wake ups into the timeout. Each
+  // wake up checks the condition before and after sources, so allow for twice that, and leave
+  // plenty of room for slow or loaded machines.
+  XCTAssertGreaterThan([conditionCheckTimes count], 2u, @"Should check early on.");
+  XCTAssertLessThan([conditionCheckTimes count], 100u, @"Should have backed off.");
+  CFTimeInterval lastGap = [[conditionCheckTimes lastObject] doubleValue] -
+      [conditionCheckTimes[[conditionCheckTimes count] - 2] doubleValue];
+  XCTAssertLessThan(lastGap, 0.08 + 0.5, @"Sleeps should be capped at the max sleep interval.");
+}
+
+// Benchmark of waiting with back off on a resource that becomes idle after 0.1 seconds. The time
+// beyond that is the latency added by sleeping instead of keeping the run loop awake.
+- (void)testBackoffSpinningPerformance {
+  [self changeActiveModeToSpinnerTestMode];
+  GREYRunLoopSpinner *spinner = [[GREYRunLoopSpinner alloc] init];
+  spinner.initialSleepInterval = 0.001;
+  spinner.maxSleepInterval = 0.1;
+  spinner.timeout = 1.0;
+
+  [self measureBlock:^{
+    CFTimeInterval idleTime = CACurrentMediaTime() + 0.1;
+    [spinner spinWithStopConditionBlock:^BOOL {
+      return CACurrentMediaTime() >= idleTime;
+    }];
+  }];
+}
+
 #pragma mark - Helpers
 
 - (void)changeActiveModeToSpinnerTestMode {
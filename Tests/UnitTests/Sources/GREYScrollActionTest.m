@@ -16,9 +16,17 @@
 
 #import <OCMock/OCMock.h>
 
+#import "Action/GREYScrollAction+Internal.h"
 #import "Action/GREYScrollAction.h"
+#import "Action/GREYScrollActionError.h"
 #import "GREYBaseTest.h"
 
+#pragma mark - Methods Only For Testing
+
+@interface GREYScrollAction (GREYExposedForTesting)
+- (CGFloat)grey_nextPlannedAmountForScrollView:(UIScrollView *)scrollView;
+@end
+
 @interface GREYScrollActionTest : GREYBaseTest
 @end
 
@@ -50,6 +58,92 @@
   [self verifyScrollActionInitWithStartPoint:CGPointMake(1, NAN) fails:YES];
 }
 
+- (void)testPlannedSearchAmountsDoubleUpToThreeQuartersOfVisibleLength {
+  UIScrollView *scrollView = [[UIScrollView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+  scrollView.contentSize = CGSizeMake(320, 10000);
+  GREYScrollAction *scrollAction =
+      [[[GREYScrollAction alloc] initWithDirection:kGREYDirectionDown amount:50]
+          searchActionPlanningAmounts:YES settingContentOffset:NO];
+
+  XCTAssertEqual([scrollAction grey_nextPlannedAmountForScrollView:scrollView], 50);
+  XCTAssertEqual([scrollAction grey_nextPlannedAmountForScrollView:scrollView], 100);
+  XCTAssertEqual([scrollAction grey_nextPlannedAmountForScrollView:scrollView], 200);
+  XCTAssertEqual([scrollAction grey_nextPlannedAmountForScrollView:scrollView], 360);
+  XCTAssertEqual([scrollAction grey_nextPlannedAmountForScrollView:scrollView], 360);
+}
+
+- (void)testPlannedSearchAmountsDoNotScrollPastRemainingContent {
+  UIScrollView *scrollView = [[UIScrollView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+  scrollView.contentSize = CGSizeMake(320, 10000);
+  scrollView.contentOffset = CGPointMake(0, 9400);
+  GREYScrollAction *scrollAction =
+      [[[GREYScrollAction alloc] initWithDirection:kGREYDirectionDown amount:200]
+          searchActionPlanningAmounts:YES settingContentOffset:NO];
+
+  XCTAssertEqual([scrollAction grey_nextPlannedAmountForScrollView:scrollView], 120);
+  scrollView.contentOffset = CGPointMake(0, 9520);
+  // Nothing remains, so the full amount is scrolled to report the content edge.
+  XCTAssertEqual([scrollAction grey_nextPlannedAmountForScrollView:scrollView], 360);
+}
+
+- (void)testPlannedSearchAmountsAreNeverLessThanTheGivenAmount {
+  UIScrollView *scrollView = [[UIScrollView alloc] initWithFrame:CGRectMake(0, 0, 100, 100)];
+  scrollView.contentSize = CGSizeMake(10000, 100);
+  scrollView.contentOffset = CGPointMake(5000, 0);
+  GREYScrollAction *scrollAction =
+      [[[GREYScrollAction alloc] initWithDirection:kGREYDirectionLeft amount:90]
+          searchActionPlanningAmounts:YES settingContentOffset:NO];
+
+  XCTAssertEqual([scrollAction grey_nextPlannedAmountForScrollView:scrollView], 90);
+  XCTAssertEqual([scrollAction grey_nextPlannedAmountForScrollView:scrollView], 90);
+}
+
+- (void)testSearchActionSettingContentOffsetScrollsByPagesUntilContentEdge {
+  UIScrollView *scrollView = [[UIScrollView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+  scrollView.contentSize = CGSizeMake(320, 2000);
+  id delegate = OCMProtocolMock(@protocol(UIScrollViewDelegate));
+  scrollView.delegate = delegate;
+  GREYScrollAction *scrollAction =
+      [[[GREYScrollAction alloc] initWithDirection:kGREYDirectionDown amount:1000]
+          searchActionPlanningAmounts:NO settingContentOffset:YES];
+
+  NSError *error;
+  XCTAssertTrue([scrollAction perform:scrollView error:&error]);
+  XCTAssertNil(error);
+  XCTAssertEqual(scrollView.contentOffset.y, 1000);
+  OCMVerify([delegate scrollViewDidScroll:scrollView]);
+
+  XCTAssertFalse([scrollAction perform:scrollView error:&error]);
+  XCTAssertEqualObjects(error.domain, kGREYScrollErrorDomain);
+  XCTAssertEqual(error.code, kGREYScrollReachedContentEdge);
+  XCTAssertEqual(scrollView.contentOffset.y, 1520);
+  scrollView.delegate = nil;
+}
+
+- (void)testSearchActionSettingContentOffsetInjectsTouchesIntoPagingOrDisabledScrollViews {
+  [[[self.mockSharedApplication stub]
+      andReturnValue:@(UIDeviceOrientationPortrait)] statusBarOrientation];
+  CGRect frame = CGRectMake(0, 0, 320, 480);
+  UIScrollView *pagingScrollView = [[UIScrollView alloc] initWithFrame:frame];
+  pagingScrollView.pagingEnabled = YES;
+  UIScrollView *disabledScrollView = [[UIScrollView alloc] initWithFrame:frame];
+  disabledScrollView.scrollEnabled = NO;
+
+  for (UIScrollView *scrollView in @[ pagingScrollView, disabledScrollView ]) {
+    scrollView.contentSize = CGSizeMake(320, 2000);
+    GREYScrollAction *scrollAction =
+        [[[GREYScrollAction alloc] initWithDirection:kGREYDirectionDown amount:100]
+            searchActionPlanningAmounts:NO settingContentOffset:YES];
+
+    // The scroll view isn't in a window, so the touches to scroll it can't be injected.
+    NSError *error;
+    XCTAssertFalse([scrollAction perform:scrollView error:&error]);
+    XCTAssertEqualObjects(error.domain, kGREYScrollErrorDomain);
+    XCTAssertEqual(error.code, kGREYScrollImpossible);
+    XCTAssertEqual(scrollView.contentOffset.y, 0);
+  }
+}
+
 #pragma mark - Private Methods
 
 - (void)verifyGREYScrollActionInitFailsWithAmount:(CGFloat)amount {
@@ -0,0 +1,158 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#import "Synchronization/GREYAppStateTracker.h"
+#import "Synchronization/GREYSyncProfiler.h"
+#import "GREYBaseTest.h"
+
+#pragma mark - Test Helpers
+
+@interface GREYSyncProfilerTestResource : NSObject<GREYIdlingResource>
+@property(nonatomic, copy) NSString *name;
+@end
+
+@implementation GREYSyncProfilerTestResource
+
+- (BOOL)isIdleNow {
+  return NO;
+}
+
+- (NSString *)idlingResourceName {
+  return self.name;
+}
+
+- (NSString *)idlingResourceDescription {
+  return self.name;
+}
+
+@end
+
+#pragma mark -
+
+@interface GREYSyncProfilerTest : GREYBaseTest
+@end
+
+@implementation GREYSyncProfilerTest {
+  GREYSyncProfiler *_profiler;
+}
+
+- (void)setUp {
+  [super setUp];
+  _profiler = [GREYSyncProfiler sharedInstance];
+  [_profiler reset];
+}
+
+- (void)tearDown {
+  [_profiler reset];
+  [super tearDown];
+}
+
+- (void)testWaitIsChargedToTheBusyResource {
+  GREYSyncProfilerTestResource *resource = [self grey_resourceNamed:@"Test Resource"];
+
+  [_profiler beginSynchronization];
+  [_profiler recordBusyResource:resource];
+  [NSThread sleepForTimeInterval:0.02];
+  [_profiler recordBusyResource:nil];
+  [_profiler endSynchronization];
+
+  NSDictionary *report = [_profiler report];
+  NSDictionary *resourceReport = report[@"resources"][@"Test Resource"];
+  XCTAssertEqualObjects(resourceReport[@"count"], @1);
+  XCTAssertGreaterThanOrEqual([resourceReport[@"totalSeconds"] doubleValue], 0.02);
+  XCTAssertEqualObjects(resourceReport[@"totalSeconds"], resourceReport[@"maxSeconds"]);
+  XCTAssertEqualObjects(report[@"synchronizations"][@"count"], @1);
+  XCTAssertEqual([self grey_countInHistogram:resourceReport[@"histogram"]], 1u);
+}
+
+- (void)testTimeAfterTheAppIsIdleIsNotCharged {
+  GREYSyncProfilerTestResource *resource = [self grey_resourceNamed:@"Test Resource"];
+
+  [_profiler beginSynchronization];
+  [_profiler recordBusyResource:resource];
+  [_profiler recordBusyResource:nil];
+  [NSThread sleepForTimeInterval:0.05];
+  [_profiler endSynchronization];
+
+  NSDictionary *report = [_profiler report];
+  XCTAssertLessThan([report[@"resources"][@"Test Resource"][@"totalSeconds"] doubleValue], 0.05);
+  XCTAssertLessThan([report[@"synchronizations"][@"totalSeconds"] doubleValue], 0.05);
+}
+
+- (void)testAppStateTrackerWaitIsChargedToEachState {
+  NS_VALID_UNTIL_END_OF_SCOPE NSObject *object = [[NSObject alloc] init];
+  GREYAppState state = kGREYPendingCAAnimation | kGREYPendingNetworkRequest;
+  GREYAppStateTrackerObject *trackerObject = TRACK_STATE_FOR_OBJECT(state, object);
+
+  [_profiler beginSynchronization];
+  [_profiler recordBusyResource:[GREYAppStateTracker sharedInstance]];
+  [_profiler recordBusyResource:nil];
+  [_profiler endSynchronization];
+  UNTRACK_STATE_FOR_OBJECT(state, trackerObject);
+
+  NSDictionary *resources = [_profiler report][@"resources"];
+  XCTAssertNotNil(resources[@"GREYAppStateTracker (kGREYPendingCAAnimation)"]);
+  XCTAssertNotNil(resources[@"GREYAppStateTracker (kGREYPendingNetworkRequest)"]);
+  XCTAssertEqual(resources.count, 2u);
+}
+
+- (void)testNestedSynchronizationIsNotChargedToTheOuterOne {
+  GREYSyncProfilerTestResource *outerResource = [self grey_resourceNamed:@"Outer Resource"];
+  GREYSyncProfilerTestResource *innerResource = [self grey_resourceNamed:@"Inner Resource"];
+
+  [_profiler beginSynchronization];
+  [_profiler recordBusyResource:outerResource];
+  [_profiler beginSynchronization];
+  [_profiler recordBusyResource:innerResource];
+  [NSThread sleepForTimeInterval:0.05];
+  [_profiler recordBusyResource:nil];
+  [_profiler endSynchronization];
+  [_profiler recordBusyResource:nil];
+  [_profiler endSynchronization];
+
+  NSDictionary *report = [_profiler report];
+  NSDictionary *resources = report[@"resources"];
+  XCTAssertGreaterThanOrEqual([resources[@"Inner Resource"][@"totalSeconds"] doubleValue], 0.05);
+  XCTAssertLessThan([resources[@"Outer Resource"][@"totalSeconds"] doubleValue], 0.05);
+  XCTAssertEqualObjects(report[@"synchronizations"][@"count"], @2);
+}
+
+- (void)testReportIsValidJSON {
+  [_profiler beginSynchronization];
+  [_profiler recordBusyResource:[self grey_resourceNamed:@"Test Resource"]];
+  [_profiler endSynchronization];
+
+  XCTAssertTrue([NSJSONSerialization isValidJSONObject:[_profiler report]]);
+}
+
+#pragma mark - Private
+
+- (GREYSyncProfilerTestResource *)grey_resourceNamed:(NSString *)name {
+  GREYSyncProfilerTestResource *resource = [[GREYSyncProfilerTestResource alloc] init];
+  resource.name = name;
+  return resource;
+}
+
+- (NSUInteger)grey_countInHistogram:(NSArray<NSDictionary *> *)histogram {
+  NSUInteger count = 0;
+  for (NSDictionary *bucket in histogram) {
+    count += [bucket[@"count"] unsignedIntegerValue];
+  }
+  return count;
+}
+
+@end
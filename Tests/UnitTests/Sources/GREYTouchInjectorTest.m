@@ -15,12 +15,20 @@
 //
 
 #import "Event/GREYTouchInjector.h"
+#import "Event/GREYTouchPath.h"
 #import "GREYBaseTest.h"
 
 #pragma mark - Methods Only For Testing
 
 @interface GREYTouchInjector (GREYExposedForTesting)
-- (GREYTouchInfo *)grey_dequeueTouchInfoForDeliveryWithCurrentTime:(CFTimeInterval)currentTime;
+- (GREYTouchInfo *)grey_dequeueTouchInfoForDeliveryWithCurrentTime:(CFTimeInterval)currentTime
+                                                     outPointIndex:(NSUInteger *)pointIndexOrNull;
+- (BOOL)grey_canFastForwardTouchInfo:(GREYTouchInfo *)touchInfo;
+- (NSTimeInterval)grey_timestampForInjectedTouches;
+- (void)grey_deliverTouchInfo:(GREYTouchInfo *)touchInfo atPointIndex:(NSUInteger)pointIndex;
+- (void)grey_stopTouchInjection;
+- (void)grey_fastForwardTouches;
+- (NSUInteger)grey_retainedHIDEventCount;
 @end
 
 @interface GREYTouchInjectorTest : GREYBaseTest
@@ -38,16 +46,62 @@
 
 - (GREYTouchInfo *)touchInfoWithTimeDelta:(CFTimeInterval)delta
                              expendable:(BOOL)expendable {
-  return [[GREYTouchInfo alloc] initWithPoints:@[[NSValue valueWithCGPoint:CGPointZero]]
-                                         phase:GREYTouchInfoPhaseTouchBegan
-               deliveryTimeDeltaSinceLastTouch:delta
-                                    expendable:expendable];
+  return [[GREYTouchInfo alloc] initWithTouchPaths:@[[GREYTouchPath touchPathWithPoint:CGPointZero]]
+                                        pointRange:NSMakeRange(0, 1)
+                                             phase:GREYTouchInfoPhaseTouchBegan
+                   deliveryTimeDeltaSinceLastTouch:delta
+                                        expendable:expendable];
+}
+
+// Returns a touch info for every point but the first of a touch path of |length| points.
+- (GREYTouchInfo *)touchInfoAlongPathOfLength:(NSUInteger)length
+                                    timeDelta:(CFTimeInterval)delta
+                                   expendable:(BOOL)expendable {
+  GREYTouchPath *touchPath = [[GREYTouchPath alloc] initWithCapacity:length];
+  for (NSUInteger i = 0; i < length; i++) {
+    [touchPath appendPoint:CGPointMake((CGFloat)i, (CGFloat)i)];
+  }
+  return [[GREYTouchInfo alloc] initWithTouchPaths:@[touchPath]
+                                        pointRange:NSMakeRange(1, length - 1)
+                                             phase:GREYTouchInfoPhaseTouchMoved
+                   deliveryTimeDeltaSinceLastTouch:delta
+                                        expendable:expendable];
+}
+
+// Returns the began, moved and ended touch infos of |fingerCount| fingers swiping down in parallel
+// along touch paths of 10 points, all of them to be delivered right away.
+- (NSArray<GREYTouchInfo *> *)touchInfosOfSwipeWithFingerCount:(NSUInteger)fingerCount {
+  NSMutableArray<GREYTouchPath *> *touchPaths = [[NSMutableArray alloc] init];
+  for (NSUInteger finger = 0; finger < fingerCount; finger++) {
+    GREYTouchPath *touchPath = [[GREYTouchPath alloc] initWithCapacity:10];
+    for (NSUInteger i = 0; i < 10; i++) {
+      [touchPath appendPoint:CGPointMake((CGFloat)(10 + finger * 40), (CGFloat)(10 + i))];
+    }
+    [touchPaths addObject:touchPath];
+  }
+  GREYTouchInfo *began = [[GREYTouchInfo alloc] initWithTouchPaths:touchPaths
+                                                        pointRange:NSMakeRange(0, 1)
+                                                             phase:GREYTouchInfoPhaseTouchBegan
+                                   deliveryTimeDeltaSinceLastTouch:0
+                                                        expendable:NO];
+  GREYTouchInfo *moved = [[GREYTouchInfo alloc] initWithTouchPaths:touchPaths
+                                                        pointRange:NSMakeRange(1, 9)
+                                                             phase:GREYTouchInfoPhaseTouchMoved
+                                   deliveryTimeDeltaSinceLastTouch:0
+                                                        expendable:NO];
+  GREYTouchInfo *ended = [[GREYTouchInfo alloc] initWithTouchPaths:touchPaths
+                                                        pointRange:NSMakeRange(9, 1)
+                                                             phase:GREYTouchInfoPhaseTouchEnded
+                                   deliveryTimeDeltaSinceLastTouch:0
+                                                        expendable:NO];
+  return @[ began, moved, ended ];
 }
 
 - (void)testTouchInjectoreCanDequeueSingleNonExpendableTouchInQueue {
   GREYTouchInfo *touch = [self touchInfoWithTimeDelta:0 expendable:NO];
   [_injector enqueueTouchInfoForDelivery:touch];
-  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:0],
+  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:0
+                                                              outPointIndex:NULL],
                  touch);
 }
 
@@ -56,16 +110,19 @@
   GREYTouchInfo *touch2 = [self touchInfoWithTimeDelta:1 expendable:NO];
   [_injector enqueueTouchInfoForDelivery:touch1];
   [_injector enqueueTouchInfoForDelivery:touch2];
-  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:0],
+  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:0
+                                                              outPointIndex:NULL],
                  touch1);
-  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:1],
+  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:1
+                                                              outPointIndex:NULL],
                  touch2);
 }
 
 - (void)testTouchInjectoreCanDequeueSingleExpendableTouchInQueue {
   GREYTouchInfo *touch = [self touchInfoWithTimeDelta:0 expendable:YES];
   [_injector enqueueTouchInfoForDelivery:touch];
-  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:1],
+  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:1
+                                                              outPointIndex:NULL],
                  touch);
 }
 
@@ -77,11 +134,129 @@
 
   // At time=2 both touch1 and touch2 are stale therefore _injector must drop touch1 and dequeue
   // the least stale touch - touch2.
-  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:2],
+  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:2
+                                                              outPointIndex:NULL],
                  touch2);
   // Queue must be empty now.
-  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:2],
+  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:2
+                                                              outPointIndex:NULL],
                  nil);
 }
 
+- (void)testTouchInjectorDequeuesEveryPointOfNonExpendableTouchPath {
+  GREYTouchInfo *touch = [self touchInfoAlongPathOfLength:5 timeDelta:1 expendable:NO];
+  [_injector enqueueTouchInfoForDelivery:touch];
+
+  // Points are dequeued one at a time at their delivery time, even if they are late.
+  NSUInteger pointIndex;
+  for (NSUInteger i = 1; i < 5; i++) {
+    XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:10
+                                                                outPointIndex:&pointIndex],
+                   touch);
+    XCTAssertEqual(pointIndex, i);
+  }
+  XCTAssertNil([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:10
+                                                            outPointIndex:&pointIndex]);
+}
+
+- (void)testTouchInjectorDropsStalePointsOfExpendableTouchPath {
+  GREYTouchInfo *touch = [self touchInfoAlongPathOfLength:10 timeDelta:1 expendable:YES];
+  GREYTouchInfo *lastTouch = [self touchInfoWithTimeDelta:1 expendable:YES];
+  [_injector enqueueTouchInfoForDelivery:touch];
+  [_injector enqueueTouchInfoForDelivery:lastTouch];
+
+  // At time=3.5 the points at index 1, 2 and 3 of the path are stale, so _injector must drop the
+  // first two of them and dequeue the least stale one.
+  NSUInteger pointIndex;
+  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:3.5
+                                                              outPointIndex:&pointIndex],
+                 touch);
+  XCTAssertEqual(pointIndex, 3u);
+
+  // At time=100 every remaining point is stale, so only the last touch must be dequeued.
+  XCTAssertEqual([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:100
+                                                              outPointIndex:&pointIndex],
+                 lastTouch);
+  XCTAssertNil([_injector grey_dequeueTouchInfoForDeliveryWithCurrentTime:100
+                                                            outPointIndex:&pointIndex]);
+}
+
+- (void)testTouchInjectorDoesNotFastForwardTouchesByDefault {
+  GREYTouchInfo *touch = [self touchInfoWithTimeDelta:0 expendable:NO];
+  XCTAssertFalse([_injector grey_canFastForwardTouchInfo:touch]);
+}
+
+- (void)testTouchInjectorFastForwardsOnlyTouchesThatAreNotTimingSensitive {
+  [[GREYConfiguration sharedInstance] setValue:@YES
+                                  forConfigKey:kGREYConfigKeyTouchInjectionFastForwardEnabled];
+  GREYTouchInjector *injector = [[GREYTouchInjector alloc] initWithWindow:[[UIWindow alloc] init]];
+
+  XCTAssertTrue([injector grey_canFastForwardTouchInfo:[self touchInfoWithTimeDelta:0
+                                                                          expendable:NO]]);
+  // Touches of expendable gestures and touches delayed on purpose must be delivered in real time.
+  XCTAssertFalse([injector grey_canFastForwardTouchInfo:[self touchInfoWithTimeDelta:0
+                                                                           expendable:YES]]);
+  XCTAssertFalse([injector grey_canFastForwardTouchInfo:[self touchInfoWithTimeDelta:1
+                                                                           expendable:NO]]);
+}
+
+- (void)testFastForwardedTouchTimestampsIncreaseByInjectionInterval {
+  [[GREYConfiguration sharedInstance] setValue:@YES
+                                  forConfigKey:kGREYConfigKeyTouchInjectionFastForwardEnabled];
+  GREYTouchInjector *injector = [[GREYTouchInjector alloc] initWithWindow:[[UIWindow alloc] init]];
+
+  NSTimeInterval previousTimestamp = [injector grey_timestampForInjectedTouches];
+  XCTAssertGreaterThanOrEqual(previousTimestamp, [[NSProcessInfo processInfo] systemUptime] - 1);
+  for (NSUInteger i = 0; i < 100; i++) {
+    NSTimeInterval timestamp = [injector grey_timestampForInjectedTouches];
+    XCTAssertGreaterThanOrEqual(timestamp, previousTimestamp + 1.0 / kGREYTouchInjectionFrequency);
+    previousTimestamp = timestamp;
+  }
+  // Time that really passes between touches is kept, even though the timestamps run ahead.
+  [NSThread sleepForTimeInterval:0.1];
+  XCTAssertGreaterThanOrEqual([injector grey_timestampForInjectedTouches], previousTimestamp + 0.1);
+
+  // Every injector starts from the system uptime.
+  injector = [[GREYTouchInjector alloc] initWithWindow:[[UIWindow alloc] init]];
+  XCTAssertLessThan([injector grey_timestampForInjectedTouches], previousTimestamp);
+}
+
+- (void)testFastForwardingDrainsQueueWithoutTimerTicks {
+  [[GREYConfiguration sharedInstance] setValue:@YES
+                                  forConfigKey:kGREYConfigKeyTouchInjectionFastForwardEnabled];
+  UIWindow *window = [[UIWindow alloc] initWithFrame:CGRectMake(0, 0, 100, 100)];
+  GREYTouchInjector *injector = [[GREYTouchInjector alloc] initWithWindow:window];
+  for (GREYTouchInfo *touchInfo in [self touchInfosOfSwipeWithFingerCount:1]) {
+    [injector enqueueTouchInfoForDelivery:touchInfo];
+  }
+
+  // The run loop doesn't spin in between, so the timer never fires.
+  [injector startInjecting];
+  [injector grey_fastForwardTouches];
+  XCTAssertEqual([injector state], kGREYTouchInjectorStopped);
+  XCTAssertEqual([injector grey_retainedHIDEventCount], 0u);
+}
+
+- (void)testTouchInjectorRetainsOneHIDEventPerFingerUntilInjectionStops {
+  UIWindow *window = [[UIWindow alloc] initWithFrame:CGRectMake(0, 0, 100, 100)];
+  GREYTouchInjector *injector = [[GREYTouchInjector alloc] initWithWindow:window];
+  NSArray<GREYTouchInfo *> *touchInfos = [self touchInfosOfSwipeWithFingerCount:2];
+  GREYTouchInfo *began = touchInfos[0];
+  GREYTouchInfo *moved = touchInfos[1];
+  GREYTouchInfo *ended = touchInfos[2];
+
+  // The HID events of every finger are replaced, not accumulated, as the touches progress.
+  [injector grey_deliverTouchInfo:began atPointIndex:0];
+  XCTAssertEqual([injector grey_retainedHIDEventCount], 2u);
+  for (NSUInteger i = 1; i < 10; i++) {
+    [injector grey_deliverTouchInfo:moved atPointIndex:i];
+    XCTAssertEqual([injector grey_retainedHIDEventCount], 2u);
+  }
+  [injector grey_deliverTouchInfo:ended atPointIndex:9];
+  XCTAssertEqual([injector grey_retainedHIDEventCount], 2u);
+
+  [injector grey_stopTouchInjection];
+  XCTAssertEqual([injector grey_retainedHIDEventCount], 0u);
+}
+
 @end
@@ -0,0 +1,122 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#import <EarlGrey/GREYElementMatcherBlock.h>
+
+#import "Common/GREYConfiguration.h"
+#import "Common/GREYTracer.h"
+#import "Core/GREYElementFinder.h"
+#import "Provider/GREYElementProvider.h"
+#import "GREYBaseTest.h"
+
+static NSString *const kOuterSpan = @"Outer";
+static NSString *const kInnerSpan = @"Inner";
+
+@interface GREYTracerTest : GREYBaseTest
+@end
+
+@implementation GREYTracerTest
+
+- (void)setUp {
+  [super setUp];
+  [[GREYTracer sharedInstance] reset];
+}
+
+- (void)tearDown {
+  // Tracing is only turned off when the next interaction begins, so begin one to keep the spans
+  // of other tests from being recorded.
+  [[GREYConfiguration sharedInstance] setValue:@NO forConfigKey:kGREYConfigKeyTracingEnabled];
+  GREYTraceSpan span = GREYTraceBeginInteraction(kOuterSpan);
+  GREYTraceEnd(&span);
+  [[GREYTracer sharedInstance] reset];
+  [super tearDown];
+}
+
+- (void)testSpansAreNotRecordedWhenTracingIsDisabled {
+  [[GREYConfiguration sharedInstance] setValue:@NO forConfigKey:kGREYConfigKeyTracingEnabled];
+  GREYTraceSpan outerSpan = GREYTraceBeginInteraction(kOuterSpan);
+  GREYTraceSpan innerSpan = GREYTraceBegin(kInnerSpan);
+  GREYTraceEnd(&innerSpan);
+  GREYTraceEnd(&outerSpan);
+
+  XCTAssertEqual([[GREYTracer sharedInstance] traceEvents].count, 0u);
+}
+
+- (void)testNestedSpansAreRecordedAsCompleteEvents {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyTracingEnabled];
+  GREYTraceSpan outerSpan = GREYTraceBeginInteraction(kOuterSpan);
+  GREYTraceSpan innerSpan = GREYTraceBegin(kInnerSpan);
+  [NSThread sleepForTimeInterval:0.01];
+  GREYTraceEnd(&innerSpan);
+  GREYTraceEnd(&outerSpan);
+
+  NSArray<NSDictionary *> *events = [[GREYTracer sharedInstance] traceEvents];
+  XCTAssertEqual(events.count, 2u);
+  NSDictionary *innerEvent = events[0];
+  NSDictionary *outerEvent = events[1];
+  XCTAssertEqualObjects(innerEvent[@"name"], kInnerSpan);
+  XCTAssertEqualObjects(outerEvent[@"name"], kOuterSpan);
+  XCTAssertEqualObjects(innerEvent[@"ph"], @"X");
+  XCTAssertEqualObjects(innerEvent[@"tid"], outerEvent[@"tid"]);
+  XCTAssertGreaterThanOrEqual([innerEvent[@"dur"] doubleValue], 10000);
+  XCTAssertGreaterThanOrEqual([innerEvent[@"ts"] doubleValue], [outerEvent[@"ts"] doubleValue]);
+  XCTAssertLessThanOrEqual([innerEvent[@"ts"] doubleValue] + [innerEvent[@"dur"] doubleValue],
+                           [outerEvent[@"ts"] doubleValue] + [outerEvent[@"dur"] doubleValue]);
+}
+
+- (void)testEndingSpanTwiceRecordsItOnce {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyTracingEnabled];
+  GREYTraceSpan span = GREYTraceBeginInteraction(kOuterSpan);
+  GREYTraceEnd(&span);
+  GREYTraceEnd(&span);
+
+  XCTAssertEqual([[GREYTracer sharedInstance] traceEvents].count, 1u);
+}
+
+- (void)testArgumentsAreAttachedToSpan {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyTracingEnabled];
+  GREYTraceSpan span = GREYTraceBeginInteraction(kOuterSpan);
+  GREYTraceEndWithArguments(&span, @{ @"action" : @"Tap" });
+
+  NSArray<NSDictionary *> *events = [[GREYTracer sharedInstance] traceEvents];
+  XCTAssertEqualObjects(events.firstObject[@"args"], @{ @"action" : @"Tap" });
+  XCTAssertTrue([NSJSONSerialization isValidJSONObject:events]);
+}
+
+- (void)testMatcherSpanIsRecordedWhenMatcherThrows {
+  [[GREYConfiguration sharedInstance] setValue:@YES forConfigKey:kGREYConfigKeyTracingEnabled];
+  id<GREYMatcher> throwingMatcher =
+      [GREYElementMatcherBlock matcherWithMatchesBlock:^BOOL(id item) {
+        [NSException raise:@"GREYTracerTestException" format:@"Matcher failed."];
+        return NO;
+      } descriptionBlock:^(id<GREYDescription> description) {}];
+  GREYElementFinder *elementFinder = [[GREYElementFinder alloc] initWithMatcher:throwingMatcher];
+  GREYElementProvider *provider =
+      [GREYElementProvider providerWithElements:@[ [[UIView alloc] init] ]];
+
+  GREYTraceSpan span = GREYTraceBeginInteraction(kOuterSpan);
+  XCTAssertThrows([elementFinder elementsMatchedInProvider:provider]);
+  GREYTraceEnd(&span);
+
+  NSArray<NSDictionary *> *events = [[GREYTracer sharedInstance] traceEvents];
+  XCTAssertEqual(events.count, 2u);
+  XCTAssertEqualObjects(events[0][@"name"], kGREYTraceSpanMatcherEvaluation);
+  XCTAssertEqualObjects(events[0][@"args"], @{ @"evaluatedElements" : @1 });
+  XCTAssertEqualObjects(events[1][@"name"], kOuterSpan);
+}
+
+@end
@@ -81,4 +81,52 @@
   }
 }
 
+- (void)testQueueGrowsForLargeHierarchyBFS {
+  // Enough views to grow the queue several times, with the queue wrapping around in between.
+  UIView *root = [[UIView alloc] init];
+  NSMutableArray *views = [[NSMutableArray alloc] initWithObjects:root, nil];
+  for (NSUInteger i = 0; i < 300; i++) {
+    UIView *child = [[UIView alloc] init];
+    [views[i / 3] addSubview:child];
+    [views addObject:child];
+  }
+
+  // Children are explored topmost subview first.
+  NSMutableArray *expectedOrder = [[NSMutableArray alloc] initWithObjects:root, nil];
+  NSMutableArray *expectedLevels = [[NSMutableArray alloc] initWithObjects:@0, nil];
+  for (NSUInteger i = 0; i < expectedOrder.count; i++) {
+    for (UIView *subview in [[expectedOrder[i] subviews] reverseObjectEnumerator]) {
+      [expectedOrder addObject:subview];
+      [expectedLevels addObject:@([expectedLevels[i] unsignedIntegerValue] + 1)];
+    }
+  }
+
+  GREYTraversalBFS *traversal = [GREYTraversalBFS hierarchyForElementWithBFSTraversal:root];
+  __block NSUInteger index = 0;
+  [traversal enumerateUsingBlock:^(id view, NSUInteger level) {
+    XCTAssertEqual(view, expectedOrder[index]);
+    XCTAssertEqual(level, [expectedLevels[index] unsignedIntegerValue]);
+    index++;
+  }];
+  XCTAssertEqual(index, 301u);
+}
+
+- (void)testFastEnumerationBFS {
+  UIView *root = [[UIView alloc] init];
+  NSMutableArray *expectedOrder = [[NSMutableArray alloc] initWithObjects:root, nil];
+  for (NSUInteger i = 0; i < 100; i++) {
+    UIView *child = [[UIView alloc] init];
+    [root addSubview:child];
+    [expectedOrder insertObject:child atIndex:1];
+  }
+
+  GREYTraversalBFS *traversal = [GREYTraversalBFS hierarchyForElementWithBFSTraversal:root];
+  NSMutableArray *enumerated = [[NSMutableArray alloc] init];
+  for (id view in traversal) {
+    [enumerated addObject:view];
+  }
+  XCTAssertEqualObjects(enumerated, expectedOrder);
+  XCTAssertNil([traversal nextObject], @"Traversal should be exhausted after being enumerated.");
+}
+
 @end
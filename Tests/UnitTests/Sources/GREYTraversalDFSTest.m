@@ -82,4 +82,115 @@
   }
 }
 
+- (void)testWideHierarchyDFS {
+  UIView *root = [[UIView alloc] init];
+  [self grey_addViewsToView:root count:1000 maxChildrenPerView:1000];
+
+  GREYTraversalDFS *traversal = [GREYTraversalDFS hierarchyForElementWithDFSTraversal:root];
+  NSArray *expectedViews = [self grey_viewsInPreOrder:root];
+  __block NSUInteger index = 0;
+  [traversal enumerateUsingBlock:^(id view, NSUInteger level) {
+    XCTAssertEqual(view, expectedViews[index]);
+    XCTAssertEqual(level, index == 0 ? 0u : 1u);
+    index++;
+  }];
+  XCTAssertEqual(index, 1001u);
+}
+
+- (void)testLevelsInDeepHierarchyDFS {
+  UIView *root = [[UIView alloc] init];
+  UIView *parent = root;
+  for (NSUInteger i = 0; i < 1000; i++) {
+    UIView *child = [[UIView alloc] init];
+    [parent addSubview:child];
+    parent = child;
+  }
+
+  GREYTraversalDFS *traversal = [GREYTraversalDFS hierarchyForElementWithDFSTraversal:root];
+  __block NSUInteger expectedLevel = 0;
+  [traversal enumerateUsingBlock:^(id view, NSUInteger level) {
+    XCTAssertEqual(level, expectedLevel);
+    expectedLevel++;
+  }];
+  XCTAssertEqual(expectedLevel, 1001u);
+}
+
+- (void)testTraversalOrderMatchesPreOrderDFS {
+  UIView *root = [[UIView alloc] init];
+  [self grey_addViewsToView:root count:2000 maxChildrenPerView:7];
+
+  GREYTraversalDFS *traversal = [GREYTraversalDFS hierarchyForElementWithDFSTraversal:root];
+  for (id view in [self grey_viewsInPreOrder:root]) {
+    XCTAssertEqual(view, [traversal nextObject]);
+  }
+  XCTAssertNil([traversal nextObject]);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testPerformanceOf1KViewHierarchyDFS {
+  [self grey_measureTraversalOfHierarchyWithViewCount:1000];
+}
+
+- (void)testPerformanceOf10KViewHierarchyDFS {
+  [self grey_measureTraversalOfHierarchyWithViewCount:10000];
+}
+
+- (void)testPerformanceOf100KViewHierarchyDFS {
+  [self grey_measureTraversalOfHierarchyWithViewCount:100000];
+}
+
+#pragma mark - Private
+
+/**
+ *  Measures a full traversal of a synthetic hierarchy of @c count views, in which every view has
+ *  up to 10 subviews.
+ *
+ *  @param count The number of views in the hierarchy, not counting the root.
+ */
+- (void)grey_measureTraversalOfHierarchyWithViewCount:(NSUInteger)count {
+  UIView *root = [[UIView alloc] init];
+  [self grey_addViewsToView:root count:count maxChildrenPerView:10];
+
+  [self measureBlock:^{
+    GREYTraversalDFS *traversal = [GREYTraversalDFS hierarchyForElementWithDFSTraversal:root];
+    __block NSUInteger visited = 0;
+    [traversal enumerateUsingBlock:^(id view, NSUInteger level) {
+      visited++;
+    }];
+    XCTAssertEqual(visited, count + 1);
+  }];
+}
+
+/**
+ *  Adds @c count views below @c root, filling the hierarchy breadth first so that no view has more
+ *  than @c maxChildren subviews.
+ */
+- (void)grey_addViewsToView:(UIView *)root
+                      count:(NSUInteger)count
+         maxChildrenPerView:(NSUInteger)maxChildren {
+  NSMutableArray<UIView *> *parents = [[NSMutableArray alloc] initWithObjects:root, nil];
+  NSUInteger parentIndex = 0;
+  for (NSUInteger i = 0; i < count; i++) {
+    if (parents[parentIndex].subviews.count == maxChildren) {
+      parentIndex++;
+    }
+    UIView *view = [[UIView alloc] init];
+    [parents[parentIndex] addSubview:view];
+    [parents addObject:view];
+  }
+}
+
+/**
+ *  @return The views below and including @c view in the order a DFS traversal is expected to
+ *          return them in, that is with the topmost subview explored first.
+ */
+- (NSArray *)grey_viewsInPreOrder:(UIView *)view {
+  NSMutableArray *views = [[NSMutableArray alloc] initWithObjects:view, nil];
+  for (UIView *subview in [view.subviews reverseObjectEnumerator]) {
+    [views addObjectsFromArray:[self grey_viewsInPreOrder:subview]];
+  }
+  return views;
+}
+
 @end
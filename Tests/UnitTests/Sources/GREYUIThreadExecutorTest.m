@@ -15,6 +15,7 @@
 //
 
 #include <objc/runtime.h>
+#include <stdatomic.h>
 
 #import "Additions/UIView+GREYAdditions.h"
 #import <EarlGrey/GREYFrameworkException.h>
@@ -49,6 +50,17 @@ static BOOL gAppStateTrackerIdle;
 
 @end
 
+@interface GREYTestSignalingIdlingResource : GREYTestIdlingResource
+@end
+
+@implementation GREYTestSignalingIdlingResource
+
+- (BOOL)signalsIdleTransitions {
+  return YES;
+}
+
+@end
+
 #pragma mark -
 
 @interface GREYUIThreadExecutorTest : GREYBaseTest
@@ -381,6 +393,48 @@ static BOOL gAppStateTrackerIdle;
   XCTAssertFalse([_threadExecutor grey_areAllResourcesIdle]);
 }
 
+- (void)testSleepsUntilSignalingResourceBecomesIdle {
+  [[GREYConfiguration sharedInstance] setValue:@YES
+                                  forConfigKey:kGREYConfigKeyIdleTransitionSignalingEnabled];
+  GREYTestSignalingIdlingResource *resource = [[GREYTestSignalingIdlingResource alloc] init];
+  __block atomic_bool isIdle = false;
+  __block atomic_int idleChecks = 0;
+  resource.isIdleNowBlock = ^BOOL(void) {
+    atomic_fetch_add(&idleChecks, 1);
+    return atomic_load(&isIdle);
+  };
+  [_threadExecutor registerIdlingResource:resource];
+
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.5 * NSEC_PER_SEC)),
+                 dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    atomic_store(&isIdle, true);
+    [[GREYUIThreadExecutor sharedInstance] signalIdleTransition];
+  });
+
+  NSError *error;
+  BOOL success = [_threadExecutor executeSyncWithTimeout:5 block:^{} error:&error];
+  XCTAssertTrue(success);
+  XCTAssertNil(error);
+  // Polling the resource while it is busy would query it thousands of times.
+  XCTAssertLessThan(atomic_load(&idleChecks), 100);
+}
+
+- (void)testNonSignalingResourceIsPolledWhenSignalingIsEnabled {
+  [[GREYConfiguration sharedInstance] setValue:@YES
+                                  forConfigKey:kGREYConfigKeyIdleTransitionSignalingEnabled];
+  GREYTestIdlingResource *resource = [[GREYTestIdlingResource alloc] init];
+  CFTimeInterval idleTime = CACurrentMediaTime() + 0.3;
+  resource.isIdleNowBlock = ^BOOL(void) {
+    return CACurrentMediaTime() >= idleTime;
+  };
+  [_threadExecutor registerIdlingResource:resource];
+
+  CFTimeInterval startTime = CACurrentMediaTime();
+  BOOL success = [_threadExecutor executeSyncWithTimeout:5 block:^{} error:nil];
+  XCTAssertTrue(success);
+  XCTAssertLessThan(CACurrentMediaTime() - startTime, 1.0);
+}
+
 - (void)testIdlingResourcesAffectingEachOthersStateAreHandledCorrectly {
   GREYTestIdlingResource *resource1 = [[GREYTestIdlingResource alloc] init];
   GREYTestIdlingResource *resource2 = [[GREYTestIdlingResource alloc] init];
@@ -18,7 +18,7 @@
 
 #import "Additions/CGGeometry+GREYAdditions.h"
 #import "Additions/NSObject+GREYAdditions.h"
-#import "Common/GREYVisibilityChecker.h"
+#import "Common/GREYVisibilityChecker+Internal.h"
 #import "GREYBaseTest.h"
 #import "GREYExposedForTesting.h"
 
@@ -1044,6 +1044,111 @@ andOptionalHiddenAreaFromVisibleArea:targetArea];
   XCTAssertFalse(isNotVisible, @"Cached value should have been invalidated after a drain.");
 }
 
+- (void)testCacheSurvivesDrainIfUIIsUnchanged {
+  UIWindow *window = [[UIWindow alloc] initWithFrame:CGRectMake(0, 0, 10, 10)];
+  window.hidden = NO;
+  UIView *view = [self grey_visibleViewForCacheTestInWindow:window];
+  // Let any pending layout happen before the first check.
+  [[GREYUIThreadExecutor sharedInstance] drainOnce];
+
+  XCTAssertFalse([GREYVisibilityChecker isNotVisible:view]);
+
+  // Do a drain without changing the UI.
+  [[GREYUIThreadExecutor sharedInstance] drainOnce];
+
+  // If cache was not used, these screenshots would make the view not visible.
+  CGSize imageSize = CGSizeMake(10, 10);
+  [self addToScreenshotListReturnedByScreenshotUtil:[self grey_imageOfSize:imageSize
+                                                                 withColor:[UIColor whiteColor]]];
+  [self addToScreenshotListReturnedByScreenshotUtil:[self grey_imageOfSize:imageSize
+                                                                 withColor:[UIColor whiteColor]]];
+  XCTAssertFalse([GREYVisibilityChecker isNotVisible:view],
+                 @"Cached value should have survived a drain that didn't change the UI.");
+}
+
+- (void)testUIChangeInvalidatesCacheOnDrain {
+  UIWindow *window = [[UIWindow alloc] initWithFrame:CGRectMake(0, 0, 10, 10)];
+  window.hidden = NO;
+  UIView *view = [self grey_visibleViewForCacheTestInWindow:window];
+  [[GREYUIThreadExecutor sharedInstance] drainOnce];
+
+  XCTAssertFalse([GREYVisibilityChecker isNotVisible:view]);
+
+  CGSize imageSize = CGSizeMake(10, 10);
+  [self addToScreenshotListReturnedByScreenshotUtil:[self grey_imageOfSize:imageSize
+                                                                 withColor:[UIColor whiteColor]]];
+  [self addToScreenshotListReturnedByScreenshotUtil:[self grey_imageOfSize:imageSize
+                                                                 withColor:[UIColor whiteColor]]];
+  [view setNeedsDisplay];
+  // The cache is only invalidated on the next drain.
+  XCTAssertFalse([GREYVisibilityChecker isNotVisible:view]);
+
+  [[GREYUIThreadExecutor sharedInstance] drainOnce];
+  XCTAssertTrue([GREYVisibilityChecker isNotVisible:view],
+                @"Cached value should have been invalidated after the UI changed.");
+}
+
+- (void)testUIChangesBumpGeneration {
+  UIView *view = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 10, 10)];
+  unsigned long generation = GREYVisibilityCheckerGeneration();
+
+  [view setNeedsLayout];
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  view.frame = CGRectMake(0, 0, 20, 20);
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  view.hidden = YES;
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  [view addSubview:[[UIView alloc] init]];
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  view.transform = CGAffineTransformMakeScale(2, 2);
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  [view bringSubviewToFront:view.subviews.firstObject];
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  [view sendSubviewToBack:view.subviews.firstObject];
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+}
+
+- (void)testLayerChangesBumpGeneration {
+  CALayer *layer = [[CALayer alloc] init];
+  unsigned long generation = GREYVisibilityCheckerGeneration();
+
+  layer.position = CGPointMake(10, 10);
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  layer.transform = CATransform3DMakeScale(2, 2, 1);
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  layer.contents = (__bridge id)[self grey_imageOfSize:CGSizeMake(1, 1)
+                                             withColor:[UIColor blackColor]].CGImage;
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  layer.backgroundColor = [UIColor redColor].CGColor;
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  [layer insertSublayer:[[CALayer alloc] init] atIndex:0];
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+
+  generation = GREYVisibilityCheckerGeneration();
+  [layer.sublayers.firstObject removeFromSuperlayer];
+  XCTAssertNotEqual(generation, GREYVisibilityCheckerGeneration());
+}
+
 - (void)testRectEnclosingExistingElementIsNotEmpty {
   CGSize imageSize = CGSizeMake(10, 10);
   // Before screenshot.
@@ -1092,6 +1197,29 @@ andOptionalHiddenAreaFromVisibleArea:targetArea];
 
 #pragma mark - Private
 
+/**
+ *  Adds a view to @c window and queues screenshots that make the view fully visible.
+ *
+ *  @param window The window to add the view to.
+ *
+ *  @return The view that was added to @c window.
+ */
+- (UIView *)grey_visibleViewForCacheTestInWindow:(UIWindow *)window {
+  CGSize imageSize = CGSizeMake(10, 10);
+  // Before screenshot.
+  [self addToScreenshotListReturnedByScreenshotUtil:[self grey_imageOfSize:imageSize
+                                                                 withColor:[UIColor whiteColor]]];
+  // After screenshot.
+  [self addToScreenshotListReturnedByScreenshotUtil:[self grey_imageOfSize:imageSize
+                                                                 withColor:[UIColor blackColor]]];
+
+  UIView *view = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 10, 10)];
+  [window addSubview:view];
+  view.accessibilityFrame = UIAccessibilityConvertFrameToScreenCoordinates(view.bounds, view);
+  view.accessibilityActivationPoint = CGRectCenter(view.accessibilityFrame);
+  return view;
+}
+
 - (UIImage *)grey_imageOfSize:(CGSize)size
                      withBackgroundColor:(UIColor *)backgroundColor
                          withVisibleArea:(CGRect)paintedArea
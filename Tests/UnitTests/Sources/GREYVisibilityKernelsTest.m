@@ -0,0 +1,194 @@
+//
+// Copyright 2016 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#import "Common/GREYVisibilityKernels.h"
+#import "GREYBaseTest.h"
+
+// An odd number of pixels so that the scalar tail of the vectorized kernels is exercised.
+static const size_t kPixelCount = 1031;
+
+/**
+ *  The two pass largest rectangle search previously used by the visibility checker, kept as a
+ *  reference for GREYLargestRectInHistogram.
+ */
+static GREYHistogramRect grey_referenceLargestRectInHistogram(const uint32_t *histogram,
+                                                              size_t length) {
+  size_t *leftNeighbors = malloc(sizeof(size_t) * length);
+  size_t *rightNeighbors = malloc(sizeof(size_t) * length);
+  size_t *leftStack = malloc(sizeof(size_t) * length);
+  size_t *rightStack = malloc(sizeof(size_t) * length);
+  NSInteger leftStackIdx = -1;
+  NSInteger rightStackIdx = -1;
+  GREYHistogramRect largestRect = {0, 0, 0};
+  uint64_t largestArea = 0;
+  for (size_t idx = 0; idx < length; idx++) {
+    size_t tailIdx = (length - 1) - idx;
+    while (leftStackIdx >= 0 && histogram[leftStack[leftStackIdx]] >= histogram[idx]) {
+      leftStackIdx--;
+    }
+    while (rightStackIdx >= 0 && histogram[rightStack[rightStackIdx]] >= histogram[tailIdx]) {
+      rightStackIdx--;
+    }
+    leftNeighbors[idx] = (leftStackIdx < 0) ? idx : idx - leftStack[leftStackIdx] - 1;
+    rightNeighbors[tailIdx] = (rightStackIdx < 0) ? length - tailIdx - 1
+                                                  : rightStack[rightStackIdx] - tailIdx - 1;
+    leftStack[++leftStackIdx] = idx;
+    rightStack[++rightStackIdx] = tailIdx;
+  }
+  for (size_t idx = 0; idx < length; idx++) {
+    uint64_t area = (uint64_t)(leftNeighbors[idx] + rightNeighbors[idx] + 1) * histogram[idx];
+    if (area > largestArea) {
+      largestArea = area;
+      largestRect.x = idx - leftNeighbors[idx];
+      largestRect.width = leftNeighbors[idx] + rightNeighbors[idx] + 1;
+      largestRect.height = histogram[idx];
+    }
+  }
+  free(leftStack);
+  free(rightStack);
+  free(leftNeighbors);
+  free(rightNeighbors);
+  return largestRect;
+}
+
+@interface GREYVisibilityKernelsTest : XCTestCase
+
+@end
+
+@implementation GREYVisibilityKernelsTest {
+  uint8_t *_beforePixels;
+  uint8_t *_afterPixels;
+}
+
+- (void)setUp {
+  [super setUp];
+  _beforePixels = malloc(kPixelCount * 4);
+  _afterPixels = malloc(kPixelCount * 4);
+  uint32_t seed = 42;
+  for (size_t i = 0; i < kPixelCount * 4; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    _beforePixels[i] = (uint8_t)(seed >> 24);
+    // Perturb about half of the channels by an amount on either side of the tolerance.
+    int delta = (seed >> 8) % 2 ? (int)((seed >> 16) % 7) - 3 : 0;
+    _afterPixels[i] = (uint8_t)(_beforePixels[i] + delta);
+  }
+}
+
+- (void)tearDown {
+  free(_beforePixels);
+  free(_afterPixels);
+  [super tearDown];
+}
+
+- (void)testShiftPixelIntensitiesShiftsOnlyRedAndGreen {
+  uint8_t pixels[] = {0, 0, 9, 10, 255, 10, 255, 0};
+  GREYShiftPixelIntensities(pixels, 2);
+  uint8_t expected[] = {0, 10, 19, 10, 255, 0, 245, 0};
+  XCTAssertEqual(memcmp(pixels, expected, sizeof(expected)), 0);
+}
+
+- (void)testShiftPixelIntensitiesMatchesScalarImplementation {
+  uint8_t scalarPixels[kPixelCount * 4];
+  memcpy(scalarPixels, _beforePixels, sizeof(scalarPixels));
+  GREYShiftPixelIntensitiesScalar(scalarPixels, kPixelCount);
+  GREYShiftPixelIntensities(_beforePixels, kPixelCount);
+  XCTAssertEqual(memcmp(scalarPixels, _beforePixels, sizeof(scalarPixels)), 0);
+}
+
+- (void)testDiffPixelsIgnoresXChannelAndTolerance {
+  uint8_t before[] = {0, 100, 100, 100, 0, 100, 100, 100, 0, 100, 100, 100};
+  uint8_t after[] = {255, 100, 100, 100, 0, 102, 98, 102, 0, 100, 100, 103};
+  uint8_t diff[3];
+  XCTAssertEqual(GREYDiffPixels(before, after, 3, diff), 1u);
+  XCTAssertEqual(diff[0], 0);
+  XCTAssertEqual(diff[1], 0);
+  XCTAssertEqual(diff[2], 1);
+}
+
+- (void)testDiffPixelsMatchesScalarImplementation {
+  uint8_t scalarDiff[kPixelCount];
+  uint8_t diff[kPixelCount];
+  size_t scalarCount = GREYDiffPixelsScalar(_beforePixels, _afterPixels, kPixelCount, scalarDiff);
+  size_t count = GREYDiffPixels(_beforePixels, _afterPixels, kPixelCount, diff);
+  XCTAssertGreaterThan(count, 0u);
+  XCTAssertLessThan(count, kPixelCount);
+  XCTAssertEqual(scalarCount, count);
+  XCTAssertEqual(memcmp(scalarDiff, diff, sizeof(diff)), 0);
+}
+
+- (void)testUpdateHistogramRowMatchesScalarImplementation {
+  uint8_t diff[kPixelCount];
+  GREYDiffPixelsScalar(_beforePixels, _afterPixels, kPixelCount, diff);
+  uint32_t scalarHistogram[kPixelCount];
+  uint32_t histogram[kPixelCount];
+  GREYUpdateHistogramRowScalar(scalarHistogram, NULL, diff, kPixelCount);
+  GREYUpdateHistogramRow(histogram, NULL, diff, kPixelCount);
+  XCTAssertEqual(memcmp(scalarHistogram, histogram, sizeof(histogram)), 0);
+  // Update in place using rows of the same diff offset by one pixel.
+  GREYUpdateHistogramRowScalar(scalarHistogram, scalarHistogram, diff + 1, kPixelCount - 1);
+  GREYUpdateHistogramRow(histogram, histogram, diff + 1, kPixelCount - 1);
+  XCTAssertEqual(memcmp(scalarHistogram, histogram, sizeof(histogram)), 0);
+}
+
+- (void)testLargestRectInHistogramMatchesTwoPassImplementation {
+  const size_t maxLength = 64;
+  uint32_t histogram[64];
+  void *scratch = malloc(GREYLargestRectScratchSize(maxLength));
+  uint32_t seed = 7;
+  for (int iteration = 0; iteration < 2000; iteration++) {
+    seed = seed * 1664525u + 1013904223u;
+    size_t length = 1 + (seed >> 8) % maxLength;
+    // Few distinct heights so that ties between rectangles are common.
+    uint32_t maxHeight = 1 + (seed >> 20) % 5;
+    for (size_t i = 0; i < length; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      histogram[i] = (seed >> 16) % maxHeight;
+    }
+    GREYHistogramRect expected = grey_referenceLargestRectInHistogram(histogram, length);
+    GREYHistogramRect actual = GREYLargestRectInHistogram(histogram, length, scratch);
+    XCTAssertEqual(expected.x, actual.x);
+    XCTAssertEqual(expected.width, actual.width);
+    XCTAssertEqual(expected.height, actual.height);
+  }
+  free(scratch);
+}
+
+- (void)testLargestRectInHistogramWithoutBars {
+  uint32_t histogram[] = {0, 0, 0};
+  void *scratch = malloc(GREYLargestRectScratchSize(3));
+  GREYHistogramRect rect = GREYLargestRectInHistogram(histogram, 3, scratch);
+  XCTAssertEqual(rect.width, 0u);
+  XCTAssertEqual(rect.height, 0u);
+  free(scratch);
+}
+
+- (void)testLargestRectInHistogramWiderThanUInt16 {
+  const size_t length = 70000;
+  uint32_t *histogram = malloc(length * sizeof(uint32_t));
+  for (size_t i = 0; i < length; i++) {
+    histogram[i] = 2;
+  }
+  histogram[3] = 1;
+  void *scratch = malloc(GREYLargestRectScratchSize(length));
+  GREYHistogramRect rect = GREYLargestRectInHistogram(histogram, length, scratch);
+  XCTAssertEqual(rect.x, 4u);
+  XCTAssertEqual(rect.width, length - 4);
+  XCTAssertEqual(rect.height, 2u);
+  free(scratch);
+  free(histogram);
+}
+
+@end
@@ -134,4 +134,35 @@
   XCTAssertTrue([url grey_shouldSynchronize]);
 }
 
+- (void)testBlacklistURLsWithBackReferencesAndQuotes {
+  [[GREYConfiguration sharedInstance] setValue:@[ @"(bar)\\1", @"google\\.com", @"\\Qa.b" ]
+                                  forConfigKey:kGREYConfigKeyURLBlacklistRegex];
+
+  NSURL *url = [NSURL URLWithString:@"http://barbar.com"];
+  XCTAssertFalse([url grey_shouldSynchronize]);
+
+  url = [NSURL URLWithString:@"http://bar.com"];
+  XCTAssertTrue([url grey_shouldSynchronize]);
+
+  url = [NSURL URLWithString:@"http://google.com"];
+  XCTAssertFalse([url grey_shouldSynchronize]);
+
+  url = [NSURL URLWithString:@"http://a.b"];
+  XCTAssertFalse([url grey_shouldSynchronize]);
+
+  url = [NSURL URLWithString:@"http://axb"];
+  XCTAssertTrue([url grey_shouldSynchronize]);
+}
+
+- (void)testBlacklistChangeIsHonoredForPreviouslyMatchedURL {
+  [[GREYConfiguration sharedInstance] setValue:@[ @"google\\.com" ]
+                                  forConfigKey:kGREYConfigKeyURLBlacklistRegex];
+  NSURL *url = [NSURL URLWithString:@"http://google.com"];
+  XCTAssertFalse([url grey_shouldSynchronize]);
+
+  [[GREYConfiguration sharedInstance] setValue:@[ @"youtube\\.com" ]
+                                  forConfigKey:kGREYConfigKeyURLBlacklistRegex];
+  XCTAssertTrue([url grey_shouldSynchronize]);
+}
+
 @end